@@ -0,0 +1,107 @@
+#include "addon_bundle.h"
+#include "globals.h"
+#include "shared/version.h"
+
+#include <algorithm>
+#include <cstring>
+
+static constexpr char     BUNDLE_MAGIC[8] = { 'J', 'S', 'L', 'P', 'A', 'C', 'K', '\0' };
+static constexpr uint32_t BUNDLE_VERSION = 1;
+static constexpr size_t   HEADER_SIZE = 32;
+static constexpr size_t   ENTRY_SIZE = 40;
+
+template <typename T>
+static T ReadLE(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));  // x86/x64: already little endian
+    return value;
+}
+
+// [offset, offset + size) lies within [0, limit)
+static bool InRange(uint64_t offset, uint64_t size, uint64_t limit) {
+    return offset <= limit && size <= limit - offset;
+}
+
+std::shared_ptr<const AddonBundle> AddonBundle::Open(const std::string& filePath) {
+    std::shared_ptr<AddonBundle> bundle(new AddonBundle());
+    std::string error;
+
+    bundle->m_file = MappedFile::Open(filePath, &error);
+    if (bundle->m_file) bundle->Parse(error);
+    if (!error.empty()) {
+        if (Globals::API) {
+            Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                ("Invalid addon bundle '" + filePath + "': " + error).c_str());
+        }
+        return nullptr;
+    }
+    return bundle;
+}
+
+bool AddonBundle::Parse(std::string& error) {
+    const char* view = m_file->GetData();
+    size_t size = m_file->GetSize();
+
+    if (size < HEADER_SIZE) {
+        error = "file too small";
+        return false;
+    }
+    if (std::memcmp(view, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0) {
+        error = "not a bundle";
+        return false;
+    }
+    uint32_t version = ReadLE<uint32_t>(view + 8);
+    if (version != BUNDLE_VERSION) {
+        error = "unsupported version " + std::to_string(version);
+        return false;
+    }
+
+    uint32_t count = ReadLE<uint32_t>(view + 12);
+    uint64_t stringsOffset = ReadLE<uint64_t>(view + 16);
+    uint64_t stringsSize = ReadLE<uint64_t>(view + 24);
+    if (!InRange(HEADER_SIZE, static_cast<uint64_t>(count) * ENTRY_SIZE, size) ||
+        !InRange(stringsOffset, stringsSize, size)) {
+        error = "truncated index";
+        return false;
+    }
+
+    const char* strings = view + stringsOffset;
+    m_entries.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const char* p = view + HEADER_SIZE + static_cast<size_t>(i) * ENTRY_SIZE;
+        uint32_t pathOffset = ReadLE<uint32_t>(p);
+        uint32_t pathLength = ReadLE<uint32_t>(p + 4);
+        uint32_t mimeOffset = ReadLE<uint32_t>(p + 8);
+        uint32_t mimeLength = ReadLE<uint32_t>(p + 12);
+        uint64_t dataOffset = ReadLE<uint64_t>(p + 16);
+        uint64_t dataSize = ReadLE<uint64_t>(p + 24);
+
+        if (!InRange(pathOffset, pathLength, stringsSize) ||
+            !InRange(mimeOffset, mimeLength, stringsSize) ||
+            !InRange(dataOffset, dataSize, size)) {
+            error = "entry " + std::to_string(i) + " out of bounds";
+            return false;
+        }
+
+        Entry entry;
+        entry.path     = std::string_view(strings + pathOffset, pathLength);
+        entry.mimeType = std::string_view(strings + mimeOffset, mimeLength);
+        entry.data     = view + dataOffset;
+        entry.size     = static_cast<size_t>(dataSize);
+        entry.hash     = ReadLE<uint64_t>(p + 32);
+
+        // Find() relies on strictly increasing paths
+        if (!m_entries.empty() && !(m_entries.back().path < entry.path)) {
+            error = "index not sorted at '" + std::string(entry.path) + "'";
+            return false;
+        }
+        m_entries.push_back(entry);
+    }
+    return true;
+}
+
+const AddonBundle::Entry* AddonBundle::Find(std::string_view path) const {
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), path,
+        [](const Entry& entry, std::string_view key) { return entry.path < key; });
+    return (it != m_entries.end() && it->path == path) ? &*it : nullptr;
+}
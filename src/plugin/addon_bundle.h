@@ -0,0 +1,63 @@
+#pragma once
+
+#include "mapped_file.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Packed addon bundle (addon.pack), built by tools/pack_addon.py.
+//
+// One file holding every asset of an addon, so serving it costs one open and
+// one mapping instead of an open/stat/read per file. Layout (little endian):
+//
+//   Header  (32 bytes)
+//     char[8]  magic "JSLPACK\0"
+//     u32      version (1)
+//     u32      entry count
+//     u64      string table offset
+//     u64      string table size
+//   Entries (40 bytes each, sorted bytewise by path)
+//     u32      path offset, length    (in the string table)
+//     u32      MIME offset, length    (empty: derive from the extension)
+//     u64      data offset (from the start of the file), size
+//     u64      FNV-1a 64 of the data
+//   String table, then data (each entry aligned to 8 bytes)
+//
+// Paths are stored normalized (AssetCache::NormalizePath). The file is mapped
+// read-only for the bundle's lifetime; entries point into the mapping.
+class AddonBundle {
+public:
+    static constexpr const char* FILE_NAME = "addon.pack";
+
+    struct Entry {
+        std::string_view path;
+        std::string_view mimeType;
+        const char*      data;
+        size_t           size;
+        uint64_t         hash;
+    };
+
+    // Map and validate a bundle. Logs and returns nullptr if the file cannot
+    // be mapped or is malformed.
+    static std::shared_ptr<const AddonBundle> Open(const std::string& filePath);
+
+    // Entry for a normalized path, or nullptr.
+    const Entry* Find(std::string_view path) const;
+
+    const std::vector<Entry>& GetEntries() const { return m_entries; }
+    size_t GetFileSize() const { return m_file->GetSize(); }
+
+private:
+    AddonBundle() = default;
+    AddonBundle(const AddonBundle&) = delete;
+    AddonBundle& operator=(const AddonBundle&) = delete;
+
+    bool Parse(std::string& error);
+
+    std::shared_ptr<const MappedFile> m_file;
+    std::vector<Entry>                m_entries;
+};
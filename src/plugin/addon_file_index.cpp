@@ -0,0 +1,297 @@
+#include "addon_file_index.h"
+#include "asset_cache.h"
+#include "file_walk.h"
+#include "globals.h"
+#include "shared/version.h"
+
+#include "include/cef_parser.h"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AddonFileIndex {
+
+// A burst of writes (an editor saving, a folder being copied) signals many
+// times; the index is rebuilt once it has settled.
+static constexpr DWORD REBUILD_DELAY_MS = 250;
+
+static const Index s_empty;
+
+// Same types as MIME_TYPES in tools/pack_addon.py. CefGetMimeType falls back
+// to the Windows registry, which may not know (or may mistype) these.
+static const std::unordered_map<std::string, std::string> s_mimeTypes = {
+    { "html",  "text/html" },
+    { "htm",   "text/html" },
+    { "js",    "text/javascript" },
+    { "mjs",   "text/javascript" },
+    { "cjs",   "text/javascript" },
+    { "css",   "text/css" },
+    { "json",  "application/json" },
+    { "map",   "application/json" },
+    { "webmanifest", "application/manifest+json" },
+    { "wasm",  "application/wasm" },
+    { "svg",   "image/svg+xml" },
+    { "png",   "image/png" },
+    { "jpg",   "image/jpeg" },
+    { "jpeg",  "image/jpeg" },
+    { "gif",   "image/gif" },
+    { "webp",  "image/webp" },
+    { "avif",  "image/avif" },
+    { "ico",   "image/x-icon" },
+    { "woff",  "font/woff" },
+    { "woff2", "font/woff2" },
+    { "ttf",   "font/ttf" },
+    { "otf",   "font/otf" },
+    { "mp3",   "audio/mpeg" },
+    { "ogg",   "audio/ogg" },
+    { "wav",   "audio/wav" },
+    { "mp4",   "video/mp4" },
+    { "webm",  "video/webm" },
+    { "txt",   "text/plain" },
+};
+
+struct Watch {
+    std::string addonId;
+    std::string basePath;
+};
+
+static std::mutex                                                    s_mutex;
+static std::unordered_map<std::string, std::shared_ptr<const Index>> s_indexes;
+static std::vector<Watch>                                            s_watches;
+static std::vector<std::string>                                      s_unhashed;  // addons to hash
+static std::thread                                                   s_watcher;
+static HANDLE                                                        s_wake = nullptr;  // watch list changed / stop
+static std::atomic<bool>                                             s_stopping{false};
+
+// List the addon's files into a new snapshot, keeping the hashes of files
+// unchanged since `previous`.
+static std::shared_ptr<const Index> Scan(const std::string& addonId,
+                                         const std::string& basePath, const Index* previous) {
+    bool initial = previous == nullptr;
+    auto start = std::chrono::steady_clock::now();
+    auto index = std::make_shared<Index>();
+    std::unordered_map<std::string, std::string> mimeTypes;  // extension → MIME
+    bool truncated = false;
+
+    FileWalk::ForEach(basePath, [&](FileWalk::Entry& entry) {
+        if (index->size() >= MAX_FILES) {
+            truncated = true;
+            return false;
+        }
+
+        File file;
+        file.path = std::move(entry.path);
+        file.size = entry.size;
+        file.mtime = entry.mtime;
+
+        // The key is lower case already
+        size_t slash = entry.key.rfind('/');
+        size_t dot = entry.key.rfind('.');
+        size_t nameStart = slash == std::string::npos ? 0 : slash + 1;
+        std::string ext = (dot != std::string::npos && dot > nameStart)
+            ? entry.key.substr(dot + 1) : std::string();
+        auto mime = mimeTypes.find(ext);
+        if (mime == mimeTypes.end()) mime = mimeTypes.emplace(ext, MimeTypeFor(ext)).first;
+        file.mimeType = mime->second;
+
+        // Unchanged since the last scan: keep its hash
+        if (previous) {
+            auto old = previous->find(entry.key);
+            if (old != previous->end() && old->second.size == file.size &&
+                old->second.mtime == file.mtime) {
+                file.hash = old->second.hash;
+            }
+        }
+        index->emplace(std::move(entry.key), std::move(file));
+        return true;
+    });
+
+    if (Globals::API) {
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        char msg[256];
+        snprintf(msg, sizeof(msg), "Addon '%s': indexed %zu file(s) in %.1f ms.",
+            addonId.c_str(), index->size(), ms);
+        Globals::API->Log(initial ? LOGL_INFO : LOGL_DEBUG, ADDON_NAME, msg);
+        if (truncated) {
+            snprintf(msg, sizeof(msg), "Addon '%s': more than %zu files, the rest are not served.",
+                addonId.c_str(), MAX_FILES);
+            Globals::API->Log(LOGL_WARNING, ADDON_NAME, msg);
+        }
+    }
+    return index;
+}
+
+// Hash the addon's cacheable files that have no hash yet and publish the
+// result, unless a rebuild replaced the snapshot meanwhile (it is hashed next).
+// Watcher thread; stops early on shutdown.
+static void HashFiles(const std::string& addonId) {
+    std::shared_ptr<const Index> current = Get(addonId);
+    if (!current) return;
+
+    auto hashed = std::make_shared<Index>(*current);
+    std::string data;
+    size_t count = 0;
+    for (auto& [key, file] : *hashed) {
+        if (s_stopping) return;
+        if (file.hash || file.size == 0 || file.size > AssetCache::MAX_ENTRY_BYTES) continue;
+
+        data.resize(static_cast<size_t>(file.size));
+        std::ifstream in(file.path, std::ios::binary);
+        if (!in.read(data.data(), static_cast<std::streamsize>(data.size())) ||
+            in.peek() != std::ifstream::traits_type::eof()) {
+            continue;  // changed since the scan: the next rebuild hashes it
+        }
+        file.hash = AssetCache::ContentHash(data.data(), data.size());
+        ++count;
+    }
+    if (!count) return;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = s_indexes.find(addonId);
+    if (it != s_indexes.end() && it->second == current) it->second = std::move(hashed);
+}
+
+// Change notification handles are opened, waited on and closed here only,
+// so Build() never closes a handle the thread is waiting on.
+static void WatchLoop() {
+    std::vector<Watch>  watches;
+    std::vector<HANDLE> handles;  // [0] = s_wake, then one per watched addon
+
+    auto closeAll = [&]() {
+        for (size_t i = 1; i < handles.size(); ++i) {
+            FindCloseChangeNotification(handles[i]);
+        }
+        handles.assign(1, s_wake);
+    };
+    handles.assign(1, s_wake);
+
+    bool reload = true;
+    while (!s_stopping) {
+        if (reload) {
+            reload = false;
+            closeAll();
+            {
+                std::lock_guard<std::mutex> lock(s_mutex);
+                watches = s_watches;
+            }
+            for (const Watch& watch : watches) {
+                HANDLE handle = handles.size() < MAXIMUM_WAIT_OBJECTS
+                    ? FindFirstChangeNotificationW(std::filesystem::path(watch.basePath).c_str(),
+                        TRUE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                              FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE)
+                    : INVALID_HANDLE_VALUE;
+                if (handle == INVALID_HANDLE_VALUE) {
+                    if (Globals::API) {
+                        Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                            (std::string("Addon '") + watch.addonId +
+                             "': cannot watch its files, changes need a reload.").c_str());
+                    }
+                    break;  // keep handles and watches aligned
+                }
+                handles.push_back(handle);
+            }
+        }
+
+        // New addons are hashed once their directory is watched
+        std::vector<std::string> unhashed;
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            unhashed.swap(s_unhashed);
+        }
+        for (const std::string& addonId : unhashed) HashFiles(addonId);
+
+        DWORD result = WaitForMultipleObjects(static_cast<DWORD>(handles.size()),
+                                              handles.data(), FALSE, INFINITE);
+        if (result == WAIT_OBJECT_0) {
+            reload = true;
+            continue;
+        }
+        size_t i = result - WAIT_OBJECT_0;
+        if (i >= handles.size()) break;  // WAIT_FAILED
+
+        Sleep(REBUILD_DELAY_MS);
+        if (s_stopping) break;
+        // Re-arm before scanning: a change made during the scan signals again
+        FindNextChangeNotification(handles[i]);
+
+        const Watch& watch = watches[i - 1];
+        std::shared_ptr<const Index> previous = Get(watch.addonId);
+        std::shared_ptr<const Index> index = Scan(watch.addonId, watch.basePath,
+                                                  previous ? previous.get() : &s_empty);
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            auto current = s_indexes.find(watch.addonId);
+            if (current == s_indexes.end()) continue;
+            current->second = std::move(index);
+        }
+        HashFiles(watch.addonId);
+    }
+    closeAll();
+}
+
+void Build(const std::string& addonId, const std::string& basePath) {
+    std::shared_ptr<const Index> index = Scan(addonId, basePath, nullptr);
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_indexes[addonId] = std::move(index);
+    s_unhashed.push_back(addonId);
+
+    auto watch = std::find_if(s_watches.begin(), s_watches.end(),
+        [&](const Watch& w) { return w.addonId == addonId; });
+    if (watch != s_watches.end()) {
+        watch->basePath = basePath;
+    } else {
+        s_watches.push_back({ addonId, basePath });
+    }
+
+    if (!s_watcher.joinable()) {
+        s_wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!s_wake) return;  // served from the startup index only
+        s_stopping = false;
+        s_watcher = std::thread(WatchLoop);
+    } else {
+        SetEvent(s_wake);
+    }
+}
+
+std::string MimeTypeFor(const std::string& ext) {
+    auto known = s_mimeTypes.find(ext);
+    if (known != s_mimeTypes.end()) return known->second;
+    std::string mimeType = ext.empty() ? std::string() : CefGetMimeType(ext).ToString();
+    return mimeType.empty() ? "application/octet-stream" : mimeType;
+}
+
+std::shared_ptr<const Index> Get(const std::string& addonId) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = s_indexes.find(addonId);
+    return it != s_indexes.end() ? it->second : nullptr;
+}
+
+void Clear() {
+    if (s_watcher.joinable()) {
+        s_stopping = true;
+        SetEvent(s_wake);
+        s_watcher.join();
+    }
+    if (s_wake) {
+        CloseHandle(s_wake);
+        s_wake = nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_indexes.clear();
+    s_watches.clear();
+    s_unhashed.clear();
+}
+
+} // namespace AddonFileIndex
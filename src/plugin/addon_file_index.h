@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+// Per-addon index of the files under its directory, built when the addon is
+// registered, so the scheme handler resolves a request with one hash lookup
+// and answers a miss without touching the disk.
+//
+// Keys are normalized paths (AssetCache::NormalizePath). A watcher thread
+// waits on directory change notifications and rebuilds an addon's index
+// shortly after its files change; readers keep the snapshot they took.
+// The same thread hashes the cacheable files of each new snapshot (content
+// addresses for AssetCache) and publishes them as another snapshot.
+namespace AddonFileIndex {
+
+// Largest number of files indexed per addon; the rest are not served.
+constexpr size_t MAX_FILES = 65536;
+
+struct File {
+    std::filesystem::path path;  // absolute; open it as a path (FileWalk::Entry)
+    std::string mimeType;  // from the extension, application/octet-stream if unknown
+    uint64_t    size = 0;
+    int64_t     mtime = 0; // last write time (file_time_type ticks)
+    uint64_t    hash = 0;  // AssetCache::ContentHash, 0 until hashed (cacheable files only)
+};
+
+using Index = std::unordered_map<std::string, File>;
+
+// Build the addon's index and watch its directory. Replaces an existing one.
+void Build(const std::string& addonId, const std::string& basePath);
+
+// Current snapshot, or nullptr if the addon has none. Any thread.
+std::shared_ptr<const Index> Get(const std::string& addonId);
+
+// Stop watching and drop every index (shutdown).
+void Clear();
+
+// MIME type for a lower-case extension (no dot): the built-in table of types
+// the web engine relies on (application/wasm for streaming compilation,
+// module scripts, web fonts), then CEF's, application/octet-stream if unknown.
+std::string MimeTypeFor(const std::string& ext);
+
+} // namespace AddonFileIndex
@@ -1,73 +1,25 @@
 #include "addon_instance.h"
 #include "addon_manager.h"
+#include "js_dispatch.h"
+#include "event_router.h"
+#include "game_state.h"
 #include "globals.h"
 #include "shared/version.h"
 
 #include "nlohmann/json.hpp"
 
-using json = nlohmann::json;
-
-// ---- Global trampoline table for event dispatch ----
-// Nexus Events_Subscribe requires a plain C function pointer void(*)(void*).
-// We use a template-generated trampoline table shared across all addons.
-// Each slot stores {addonId, eventName} so the trampoline can route to the
-// correct addon's pending event queue.
-
-static constexpr int GLOBAL_MAX_EVENT_SLOTS = 256;
-
-struct TrampolineSlot {
-    std::string addonId;
-    std::string eventName;
-    bool used = false;
-};
-
-static TrampolineSlot s_globalSlots[GLOBAL_MAX_EVENT_SLOTS];
-static std::mutex s_globalSlotMutex;
-
-template<int N>
-static void GlobalEventTrampoline(void* /*aEventArgs*/) {
-    std::string addonId;
-    std::string eventName;
-    {
-        std::lock_guard<std::mutex> lock(s_globalSlotMutex);
-        auto& slot = s_globalSlots[N];
-        if (!slot.used) return;
-        addonId = slot.addonId;
-        eventName = slot.eventName;
-    }
-    auto* addon = AddonManager::GetAddon(addonId);
-    if (!addon) return;
-    addon->QueueEvent(eventName);
-}
-
-template<int... Is>
-static std::array<EVENT_CONSUME, sizeof...(Is)>
-MakeGlobalTrampolineTable(std::integer_sequence<int, Is...>) {
-    return {{ &GlobalEventTrampoline<Is>... }};
-}
+#include <cstring>
 
-static auto s_globalTrampolines = MakeGlobalTrampolineTable(
-    std::make_integer_sequence<int, GLOBAL_MAX_EVENT_SLOTS>{});
+using json = nlohmann::json;
 
-static int AllocateGlobalSlot(const std::string& addonId, const std::string& eventName) {
-    for (int i = 0; i < GLOBAL_MAX_EVENT_SLOTS; ++i) {
-        if (!s_globalSlots[i].used) {
-            s_globalSlots[i].used = true;
-            s_globalSlots[i].addonId = addonId;
-            s_globalSlots[i].eventName = eventName;
-            return i;
-        }
-    }
-    return -1;
-}
+// ---- Keybind routing ----
+// Keybind identifiers ("JSLOADER_<addonId>_<keybindId>") are interned when
+// registered; the owner table maps the interned ID back to its addon so the
+// input callback needs neither a lock nor a string parse. The callback holds
+// an EventRouter read section while it uses the owner, so Shutdown can wait
+// it out before the instance is freed.
 
-static void FreeGlobalSlot(int slot) {
-    if (slot >= 0 && slot < GLOBAL_MAX_EVENT_SLOTS) {
-        s_globalSlots[slot].used = false;
-        s_globalSlots[slot].addonId.clear();
-        s_globalSlots[slot].eventName.clear();
-    }
-}
+static std::atomic<AddonInstance*> s_keybindOwners[NameIntern::MAX_NAMES];
 
 // ---- AddonInstance implementation ----
 
@@ -185,57 +137,239 @@ void AddonInstance::FlushFrames() {
 void AddonInstance::FlushPendingEvents() {
     // Find the main browser to dispatch events to
     auto* mainWindow = GetWindow("main");
-    if (!mainWindow || !mainWindow->browser || !mainWindow->browser->IsReady()) return;
+    if (!mainWindow || !mainWindow->browser || !mainWindow->browser->IsReady()) {
+        DiscardPendingRecords();
+        return;
+    }
 
-    // Flush events
-    {
-        std::lock_guard<std::mutex> lock(m_eventMutex);
-        for (const auto& ev : m_pendingEvents) {
-            json j;
-            j["type"] = "event";
-            j["name"] = ev.name;
-            if (!ev.jsonData.empty()) {
-                try {
-                    j["data"] = json::parse(ev.jsonData);
-                } catch (...) {
-                    j["data"] = ev.jsonData;
+    InProcessBrowser* browser = mainWindow->browser.get();
+
+    // A new page has no keys down. A dropped record may have been a release:
+    // forget what is held rather than swallow that bind's later presses.
+    uint32_t droppedKeybinds = m_droppedKeybinds.load(std::memory_order_relaxed);
+    if (browser->GetLoadCount() != m_keybindsDownLoad || droppedKeybinds != m_keybindsDownDropped) {
+        m_keybindsDown.clear();
+        m_keybindsDownLoad = browser->GetLoadCount();
+        m_keybindsDownDropped = droppedKeybinds;
+    }
+
+    // Flush events: drain the queue, apply each subscription's policy, then
+    // deliver what is left in arrival order
+    m_flushBatch.clear();
+    while (m_pendingEvents.TryPop([&](PendingEvent& ev) { m_flushBatch.push_back(ev); })) {}
+
+    ApplyEventPolicies();
+    for (const PendingEvent& ev : m_flushBatch) {
+        if (ev.name == NameIntern::INVALID) continue; // filtered by policy
+        DeliverEvent(browser, ev);
+        m_subscriptions.find(ev.name)->second.delivered++;
+    }
+    DeliverHeldSamples(browser);
+    EmitAggregates(browser);
+
+    // Flush keybinds. A held key can repeat its press; only the first press
+    // before a release is delivered.
+    while (m_pendingKeybinds.TryPop([&](PendingKeybind& kb) {
+        auto it = m_keybindNames.find(kb.identifier);
+        if (it == m_keybindNames.end()) return; // deregistered since queued
+        if (kb.isRelease) {
+            m_keybindsDown.erase(kb.identifier);
+        } else if (!m_keybindsDown.insert(kb.identifier).second) {
+            m_coalescedKeybinds++;
+            return;
+        }
+        json j;
+        j["type"] = "keybind";
+        j["id"] = it->second;
+        j["isRelease"] = kb.isRelease;
+        JsDispatch::Send(browser, j);
+    })) {}
+
+    ReportDroppedRecords();
+}
+
+// ---- Event policies ----
+// Records a policy filters out are marked by clearing their name; the rest of
+// m_flushBatch is delivered in order.
+
+const char* EventPolicyName(EventPolicy policy) {
+    switch (policy) {
+        case EventPolicy::All:      return "all";
+        case EventPolicy::Latest:   return "latest";
+        case EventPolicy::Coalesce: return "coalesce";
+        case EventPolicy::Sample:   return "sample";
+    }
+    return "all";
+}
+
+bool ParseEventPolicy(std::string_view name, EventPolicy& out) {
+    if (name == "all")      { out = EventPolicy::All;      return true; }
+    if (name == "latest")   { out = EventPolicy::Latest;   return true; }
+    if (name == "coalesce") { out = EventPolicy::Coalesce; return true; }
+    if (name == "sample")   { out = EventPolicy::Sample;   return true; }
+    return false;
+}
+
+void AddonInstance::ApplyEventPolicies() {
+    for (auto& [id, sub] : m_subscriptions) {
+        sub.flushCount = 0;
+        sub.flushLatest = SIZE_MAX;
+    }
+    m_coalesceSlots.clear();
+
+    for (size_t i = 0; i < m_flushBatch.size(); ++i) {
+        PendingEvent& ev = m_flushBatch[i];
+        auto it = m_subscriptions.find(ev.name);
+        if (it == m_subscriptions.end()) {
+            ev.name = NameIntern::INVALID; // unsubscribed since queued
+            continue;
+        }
+        EventSubscription& sub = it->second;
+
+        switch (sub.config.policy) {
+            case EventPolicy::All:
+                if (sub.config.max && ++sub.flushCount > sub.config.max) {
+                    sub.dropped++;
+                    ev.name = NameIntern::INVALID;
+                }
+                break;
+
+            case EventPolicy::Coalesce: {
+                uint64_t key = 0;
+                if (sub.keyField &&
+                    EventCodecs::FieldKey(ev.codec, *sub.keyField, ev.payload, ev.payloadSize, key)) {
+                    auto [slot, inserted] = m_coalesceSlots.try_emplace(
+                        key ^ (static_cast<uint64_t>(ev.name) * 0x9E3779B97F4A7C15ull), i);
+                    if (!inserted) {
+                        m_flushBatch[slot->second].name = NameIntern::INVALID;
+                        slot->second = i;
+                        sub.coalesced++;
+                    }
+                    break;
+                }
+                // No key in this record: coalesce it with the other keyless ones
+                [[fallthrough]];
+            }
+
+            case EventPolicy::Latest:
+                if (sub.flushLatest != SIZE_MAX) {
+                    m_flushBatch[sub.flushLatest].name = NameIntern::INVALID;
+                    sub.coalesced++;
                 }
-            } else {
-                j["data"] = nullptr;
+                sub.flushLatest = i;
+                break;
+
+            case EventPolicy::Sample: {
+                auto [held, inserted] = m_heldSamples.try_emplace(ev.name, ev);
+                if (!inserted) {
+                    held->second = ev;
+                    sub.dropped++;
+                }
+                ev.name = NameIntern::INVALID;
+                break;
             }
-            std::string code = "window.__nexus_dispatch(" + j.dump() + ");";
-            mainWindow->browser->ExecuteJavaScript(code);
         }
-        m_pendingEvents.clear();
     }
+}
 
-    // Flush keybinds
-    {
-        std::lock_guard<std::mutex> lock(m_keybindMutex);
-        for (const auto& kb : m_pendingKeybinds) {
-            json j;
-            j["type"] = "keybind";
-            j["id"] = kb.identifier;
-            j["isRelease"] = kb.isRelease;
-            std::string code = "window.__nexus_dispatch(" + j.dump() + ");";
-            mainWindow->browser->ExecuteJavaScript(code);
+// Push aggregated values that are due (see EventAggregator::TakeEmit).
+void AddonInstance::EmitAggregates(InProcessBrowser* browser) {
+    if (m_aggregators.empty()) return;
+
+    DWORD now = GetTickCount();
+    for (auto& [id, aggregator] : m_aggregators) {
+        aggregator->Advance(now);
+        if (!aggregator->TakeEmit(now)) continue;
+
+        json j;
+        j["type"] = "aggregate";
+        j["id"] = id;
+        j["value"] = aggregator->Value();
+        j["count"] = aggregator->WindowCount();
+        JsDispatch::Send(browser, j);
+    }
+}
+
+// Deliver each Sample subscription's held record once its interval is up.
+void AddonInstance::DeliverHeldSamples(InProcessBrowser* browser) {
+    if (m_heldSamples.empty()) return;
+
+    DWORD now = GetTickCount();
+    for (auto it = m_heldSamples.begin(); it != m_heldSamples.end();) {
+        auto sub = m_subscriptions.find(it->first);
+        if (sub == m_subscriptions.end() || sub->second.config.policy != EventPolicy::Sample) {
+            it = m_heldSamples.erase(it);
+            continue;
         }
-        m_pendingKeybinds.clear();
+        if (now - sub->second.lastDeliveredTick < sub->second.intervalMs) {
+            ++it;
+            continue;
+        }
+        DeliverEvent(browser, it->second);
+        sub->second.delivered++;
+        sub->second.lastDeliveredTick = now;
+        it = m_heldSamples.erase(it);
+    }
+}
+
+// ---- Shared event serialization ----
+// Every subscriber of an event gets its own copy of the captured record, but
+// all copies carry the same sequence number. The first addon to flush an
+// occurrence decodes it; later addons in the same frame reuse the message
+// and its encoded dispatch script (JsDispatch shared payloads).
+
+void AddonInstance::DeliverEvent(InProcessBrowser* browser, const PendingEvent& ev) {
+    JsDispatch::SharedPayloadRef payload = JsDispatch::FindShared(JsDispatch::PayloadSource::Event, ev.seq);
+    if (!payload) {
+        json message;
+        message["type"] = "event";
+        message["name"] = NameIntern::Name(ev.name);
+        EventCodecs::ToJson(ev.codec, ev.payload, ev.payloadSize, message["data"]);
+        payload = JsDispatch::AddShared(JsDispatch::PayloadSource::Event, ev.seq, std::move(message));
+    }
+    JsDispatch::SendShared(browser, *payload);
+}
+
+// No page to deliver to (not created yet, or gone): drop what the game
+// threads queued instead of letting the rings fill. Keys held now are
+// released before the next page sees them.
+void AddonInstance::DiscardPendingRecords() {
+    m_pendingEvents.Clear();
+    m_pendingKeybinds.Clear();
+    m_keybindsDown.clear();
+    ReportDroppedRecords();
+}
+
+// Log queue overflows since the last flush (render thread).
+void AddonInstance::ReportDroppedRecords() {
+    uint32_t droppedEvents = m_droppedEvents.load(std::memory_order_relaxed);
+    uint32_t droppedKeybinds = m_droppedKeybinds.load(std::memory_order_relaxed);
+    if (droppedEvents == m_reportedDroppedEvents &&
+        droppedKeybinds == m_reportedDroppedKeybinds) {
+        return;
+    }
+
+    if (Globals::API) {
+        Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+            ("Addon '" + m_manifest.id + "' dropped " +
+             std::to_string(droppedEvents - m_reportedDroppedEvents) + " event(s) and " +
+             std::to_string(droppedKeybinds - m_reportedDroppedKeybinds) +
+             " keybind(s): queue full").c_str());
     }
+    m_reportedDroppedEvents = droppedEvents;
+    m_reportedDroppedKeybinds = droppedKeybinds;
 }
 
 void AddonInstance::Shutdown() {
     // Close DevTools
     CloseDevTools();
 
-    // Unsubscribe all events
-    if (Globals::API) {
-        for (const auto& [eventName, slot] : m_eventSlots) {
-            Globals::API->Events_Unsubscribe(eventName.c_str(), s_globalTrampolines[slot]);
-            FreeGlobalSlot(slot);
-        }
-    }
-    m_eventSlots.clear();
+    // Unsubscribe all events; afterwards no game thread references this addon
+    EventRouter::UnsubscribeAll(this);
+    m_subscriptions.clear();
+    m_heldSamples.clear();
+    m_aggregators.clear();
+    GameState::UnsubscribeAddon(m_manifest.id);
 
     // Deregister all keybinds (use prefixed ID as registered with Nexus)
     if (Globals::API) {
@@ -244,17 +378,20 @@ void AddonInstance::Shutdown() {
             Globals::API->InputBinds_Deregister(fullId.c_str());
         }
     }
+    for (const auto& [nameId, id] : m_keybindNames) {
+        s_keybindOwners[nameId].store(nullptr);
+    }
+    if (!m_keybindNames.empty()) EventRouter::Synchronize();
+    m_keybindNames.clear();
     m_registeredKeybinds.clear();
+    m_keybindsDown.clear();
 
     // Clear pending queues
-    {
-        std::lock_guard<std::mutex> lock(m_eventMutex);
-        m_pendingEvents.clear();
-    }
-    {
-        std::lock_guard<std::mutex> lock(m_keybindMutex);
-        m_pendingKeybinds.clear();
-    }
+    m_pendingEvents.Clear();
+    m_pendingKeybinds.Clear();
+
+    // Drop any payloads still staged for this addon's pages
+    JsDispatch::ClearBlobs(m_manifest.id);
 
     // Close all browsers
     for (auto& [id, window] : m_windows) {
@@ -354,59 +491,131 @@ InProcessBrowser* AddonInstance::GetDevToolsBrowser() {
 
 // ---- Per-addon IPC state ----
 
-void AddonInstance::SubscribeEvent(const std::string& eventName) {
-    if (!Globals::API) return;
-    if (m_eventSlots.count(eventName)) return; // already subscribed
+bool AddonInstance::ClaimName(const std::string& name) {
+    NameIntern::Id id = NameIntern::Find(name);
+    if (id != NameIntern::INVALID && m_claimedNames.count(id)) return true;
 
-    std::lock_guard<std::mutex> lock(s_globalSlotMutex);
-    int slot = AllocateGlobalSlot(m_manifest.id, eventName);
-    if (slot < 0) {
+    if (m_claimedNames.size() >= MAX_NAMES_PER_ADDON) {
+        if (!m_claimLimitLogged && Globals::API) {
+            Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                ("Addon '" + m_manifest.id + "' uses more than " +
+                 std::to_string(MAX_NAMES_PER_ADDON) + " event names and keybinds; rejecting '" +
+                 name + "' and any further new names").c_str());
+        }
+        m_claimLimitLogged = true;
+        return false;
+    }
+
+    id = NameIntern::Intern(name);
+    if (id == NameIntern::INVALID) {
         if (Globals::API) {
             Globals::API->Log(LOGL_WARNING, ADDON_NAME,
-                "Too many event subscriptions — global max reached.");
+                ("Too many distinct event names and keybind identifiers; rejecting '" +
+                 name + "'").c_str());
         }
-        return;
+        return false;
     }
+    m_claimedNames.insert(id);
+    return true;
+}
+
+void AddonInstance::SubscribeEvent(const std::string& eventName, const EventPolicyConfig& config) {
+    if (!Globals::API) return;
+
+    NameIntern::Id id = NameIntern::Find(eventName);
+    auto it = m_subscriptions.find(id);
+    if (it == m_subscriptions.end()) {
+        if (!ClaimName(eventName) || !EventRouter::Subscribe(this, eventName)) return;
+        id = NameIntern::Find(eventName);
+        it = m_subscriptions.try_emplace(id).first;
+        it->second.eventName = eventName;
 
-    m_eventSlots[eventName] = slot;
-    Globals::API->Events_Subscribe(eventName.c_str(), s_globalTrampolines[slot]);
+        Globals::API->Log(LOGL_DEBUG, ADDON_NAME,
+            (std::string("Addon '") + m_manifest.id + "' subscribed to event: " + eventName).c_str());
+    }
 
-    Globals::API->Log(LOGL_DEBUG, ADDON_NAME,
-        (std::string("Addon '") + m_manifest.id + "' subscribed to event: " + eventName).c_str());
+    // (Re)apply the policy; counters are kept across policy changes
+    EventSubscription& sub = it->second;
+    sub.config = config;
+    sub.keyField = nullptr;
+    sub.intervalMs = 0;
+
+    if (config.policy == EventPolicy::Coalesce) {
+        sub.keyField = EventCodecs::FindField(EventCodecs::Find(eventName), config.key);
+        if (!sub.keyField) {
+            Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                ("Addon '" + m_manifest.id + "': event " + eventName + " has no field '" +
+                 config.key + "' to coalesce by; keeping the latest occurrence only").c_str());
+        }
+    } else if (config.policy == EventPolicy::Sample) {
+        sub.intervalMs = config.hz ? 1000 / config.hz : 1000;
+    }
+}
+
+bool AddonInstance::AddAggregator(const std::string& id, const std::string& eventName,
+                                  AggregateOp op, const std::string& field,
+                                  uint32_t windowMs, uint32_t emitHz) {
+    if (!Globals::API || id.empty() || eventName.empty()) return false;
+
+    EventCodecs::CodecId codec = EventCodecs::Find(eventName);
+    const EventCodecs::FieldDesc* fieldDesc = nullptr;
+    if (!field.empty()) {
+        fieldDesc = EventCodecs::FindField(codec, field);
+        if (!fieldDesc || fieldDesc->type == EventCodecs::FieldType::Chars) {
+            Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                ("Addon '" + m_manifest.id + "': event " + eventName +
+                 " has no numeric field '" + field + "' to aggregate").c_str());
+            return false;
+        }
+    } else if (op == AggregateOp::Sum || op == AggregateOp::Latest) {
+        Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+            ("Addon '" + m_manifest.id + "': aggregate '" + AggregateOpName(op) +
+             "' of " + eventName + " needs a field").c_str());
+        return false;
+    }
+
+    if (!ClaimName(eventName)) return false;
+    RemoveAggregator(id);
+
+    auto aggregator = std::make_unique<EventAggregator>(
+        id, eventName, op, codec, fieldDesc, windowMs, emitHz, GetTickCount());
+    if (!EventRouter::AddAggregator(this, aggregator.get())) return false;
+    m_aggregators[id] = std::move(aggregator);
+    return true;
+}
+
+void AddonInstance::RemoveAggregator(const std::string& id) {
+    auto it = m_aggregators.find(id);
+    if (it == m_aggregators.end()) return;
+
+    // Returns once no game thread can still be feeding it
+    EventRouter::RemoveAggregator(it->second.get());
+    m_aggregators.erase(it);
 }
 
 void AddonInstance::UnsubscribeEvent(const std::string& eventName) {
     if (!Globals::API) return;
 
-    auto it = m_eventSlots.find(eventName);
-    if (it != m_eventSlots.end()) {
-        int slot = it->second;
-        Globals::API->Events_Unsubscribe(eventName.c_str(), s_globalTrampolines[slot]);
-        std::lock_guard<std::mutex> lock(s_globalSlotMutex);
-        FreeGlobalSlot(slot);
-        m_eventSlots.erase(it);
+    auto it = m_subscriptions.find(NameIntern::Find(eventName));
+    if (it != m_subscriptions.end()) {
+        EventRouter::Unsubscribe(this, eventName);
+        m_heldSamples.erase(it->first);
+        m_subscriptions.erase(it);
     }
 }
 
-// Global keybind callback: parses the addon ID from the prefixed identifier
-// to route to the correct addon. This is a non-capturing function that can
-// be used as a C function pointer (INPUTBINDS_PROCESS).
+// Global keybind callback: routes by the interned identifier through the
+// owner table. This is a non-capturing function that can be used as a C
+// function pointer (INPUTBINDS_PROCESS).
 static void GlobalKeybindCallback(const char* aIdentifier, bool aIsRelease) {
-    // Identifier format: "JSLOADER_<addonId>_<keybindId>"
-    std::string id(aIdentifier);
-    const std::string prefix = "JSLOADER_";
-    if (id.substr(0, prefix.size()) != prefix) return;
+    if (!aIdentifier) return;
+    NameIntern::Id id = NameIntern::Find(aIdentifier);
+    if (id == NameIntern::INVALID) return;
 
-    std::string rest = id.substr(prefix.size());
-    auto sep = rest.find('_');
-    if (sep == std::string::npos) return;
-
-    std::string addonId = rest.substr(0, sep);
-    std::string keybindId = rest.substr(sep + 1);
-
-    auto* addon = AddonManager::GetAddon(addonId);
+    EventRouter::ReadSection section;
+    AddonInstance* addon = s_keybindOwners[id].load();
     if (!addon) return;
-    addon->QueueKeybind(keybindId, aIsRelease);
+    addon->QueueKeybind(id, aIsRelease);
 }
 
 void AddonInstance::RegisterKeybind(const std::string& identifier, const std::string& defaultBind) {
@@ -415,6 +624,11 @@ void AddonInstance::RegisterKeybind(const std::string& identifier, const std::st
     // Prefix keybind ID with addon ID to avoid collisions
     std::string fullId = "JSLOADER_" + m_manifest.id + "_" + identifier;
 
+    if (!ClaimName(fullId)) return;
+    NameIntern::Id nameId = NameIntern::Find(fullId);
+    m_keybindNames[nameId] = identifier;
+    s_keybindOwners[nameId].store(this, std::memory_order_release);
+
     Globals::API->InputBinds_RegisterWithString(
         fullId.c_str(), GlobalKeybindCallback, defaultBind.c_str());
     m_registeredKeybinds.insert(identifier);
@@ -426,33 +640,34 @@ void AddonInstance::DeregisterKeybind(const std::string& identifier) {
     std::string fullId = "JSLOADER_" + m_manifest.id + "_" + identifier;
     Globals::API->InputBinds_Deregister(fullId.c_str());
     m_registeredKeybinds.erase(identifier);
-}
 
-void AddonInstance::QueueEvent(const std::string& name, const std::string& jsonData) {
-    std::lock_guard<std::mutex> lock(m_eventMutex);
-    m_pendingEvents.push_back({name, jsonData});
+    NameIntern::Id nameId = NameIntern::Find(fullId);
+    if (nameId != NameIntern::INVALID) {
+        s_keybindOwners[nameId].store(nullptr, std::memory_order_release);
+        m_keybindNames.erase(nameId);
+        m_keybindsDown.erase(nameId);
+    }
 }
 
-void AddonInstance::QueueKeybind(const std::string& identifier, bool isRelease) {
-    std::lock_guard<std::mutex> lock(m_keybindMutex);
-    m_pendingKeybinds.push_back({identifier, isRelease});
+void AddonInstance::QueueEvent(NameIntern::Id name, uint64_t seq, EventCodecs::CodecId codec,
+                               const void* record, size_t recordSize) {
+    if (name == NameIntern::INVALID) return;
+    if (recordSize > EventCodecs::MAX_RECORD_BYTES) recordSize = 0;
+
+    bool queued = m_pendingEvents.TryPush([&](PendingEvent& ev) {
+        ev.seq = seq;
+        ev.name = name;
+        ev.codec = codec;
+        ev.payloadSize = static_cast<uint16_t>(recordSize);
+        if (recordSize) std::memcpy(ev.payload, record, recordSize);
+    });
+    if (!queued) m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
 }
 
-void AddonInstance::SendAsyncResponse(InProcessBrowser* browser, int requestId,
-                                       bool success, const std::string& value) {
-    if (!browser) return;
-
-    json j;
-    j["type"] = "response";
-    j["requestId"] = requestId;
-    j["success"] = success;
-
-    try {
-        j["value"] = json::parse(value);
-    } catch (...) {
-        j["value"] = value;
-    }
-
-    std::string code = "window.__nexus_dispatch(" + j.dump() + ");";
-    browser->ExecuteJavaScript(code);
+void AddonInstance::QueueKeybind(NameIntern::Id identifier, bool isRelease) {
+    bool queued = m_pendingKeybinds.TryPush([&](PendingKeybind& kb) {
+        kb.identifier = identifier;
+        kb.isRelease = isRelease;
+    });
+    if (!queued) m_droppedKeybinds.fetch_add(1, std::memory_order_relaxed);
 }
@@ -2,11 +2,19 @@
 
 #include "addon_manager.h"
 #include "in_process_browser.h"
+#include "mpsc_ring.h"
+#include "name_intern.h"
+#include "event_codecs.h"
+#include "event_aggregator.h"
 
 #include "include/cef_browser.h"
 
 #include <string>
+#include <string_view>
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <unordered_map>
@@ -14,6 +22,43 @@
 
 enum class AddonState { Discovered, Loading, Running, Error, Unloaded };
 
+// Delivery policy of an event subscription. Enforced on the render thread
+// when the queue is drained, before anything reaches JS.
+enum class EventPolicy : uint8_t {
+    All,      // every occurrence, at most `max` per frame (0 = no cap)
+    Latest,   // only the newest occurrence per frame
+    Coalesce, // the newest occurrence per value of `key` per frame
+    Sample,   // the newest occurrence, at most `hz` times per second
+};
+
+struct EventPolicyConfig {
+    EventPolicy policy = EventPolicy::All;
+    uint32_t    max = 0;
+    std::string key;      // codec field path, e.g. "src.id"
+    uint32_t    hz = 0;
+};
+
+// "all", "latest", "coalesce", "sample". Parse returns false for other names.
+const char* EventPolicyName(EventPolicy policy);
+bool ParseEventPolicy(std::string_view name, EventPolicy& out);
+
+// Per-subscription delivery state and counters (render thread).
+struct EventSubscription {
+    std::string                   eventName;
+    EventPolicyConfig             config;
+    const EventCodecs::FieldDesc* keyField = nullptr;   // Coalesce
+    DWORD                         intervalMs = 0;       // Sample
+    DWORD                         lastDeliveredTick = 0;
+
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;    // over the per-frame cap, or sampled out
+    uint64_t coalesced = 0;  // superseded by a newer occurrence
+
+    // Scratch for the flush in progress
+    uint32_t flushCount = 0;
+    size_t   flushLatest = SIZE_MAX;
+};
+
 struct WindowInfo {
     std::string windowId;          // "main", "settings", etc.
     std::string title;
@@ -86,26 +131,59 @@ public:
 
     // ---- Per-addon IPC state ----
 
-    // Event subscriptions
-    void SubscribeEvent(const std::string& eventName);
+    // Distinct event names and keybind identifiers one addon may intern. The
+    // intern table is process-wide and never shrinks, so a page cycling
+    // through new names must not be able to fill it for every addon.
+    static constexpr size_t MAX_NAMES_PER_ADDON = 256;
+
+    // Event subscriptions. Subscribing again replaces the policy.
+    void SubscribeEvent(const std::string& eventName, const EventPolicyConfig& config = {});
     void UnsubscribeEvent(const std::string& eventName);
 
+    // Native aggregators (nexus.events.aggregate). `id` is chosen by the page;
+    // adding an existing ID replaces that aggregator. `field` is required for
+    // Sum/Latest. Returns false (and logs) if the aggregator cannot be built.
+    bool AddAggregator(const std::string& id, const std::string& eventName, AggregateOp op,
+                       const std::string& field, uint32_t windowMs, uint32_t emitHz);
+    void RemoveAggregator(const std::string& id);
+
+    const std::map<std::string, std::unique_ptr<EventAggregator>>& GetAggregators() const {
+        return m_aggregators;
+    }
+
     // Keybind registrations
     void RegisterKeybind(const std::string& identifier, const std::string& defaultBind);
     void DeregisterKeybind(const std::string& identifier);
 
-    // Send async response to specific browser
-    void SendAsyncResponse(InProcessBrowser* browser, int requestId,
-                           bool success, const std::string& value);
-
     const std::string& GetId() const { return m_manifest.id; }
 
-    // Queue an event into the addon's pending events (thread-safe).
-    // Called by global event trampolines.
-    void QueueEvent(const std::string& name, const std::string& jsonData = "");
+    // Queue an event for the main browser. Lock-free and non-blocking; called
+    // by EventRouter on game threads. `record` is the payload captured by the
+    // event's codec (EventCodecs), copied into the queue. `seq` identifies the
+    // occurrence across subscribers. If the queue is full the event is
+    // dropped and counted.
+    void QueueEvent(NameIntern::Id name, uint64_t seq, EventCodecs::CodecId codec,
+                    const void* record, size_t recordSize);
+
+    // Queue a keybind for the main browser (lock-free, non-blocking).
+    // `identifier` is the interned Nexus identifier ("JSLOADER_<addon>_<id>").
+    void QueueKeybind(NameIntern::Id identifier, bool isRelease);
+
+    // Records dropped because a queue was full.
+    uint32_t GetDroppedEvents() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+    uint32_t GetDroppedKeybinds() const { return m_droppedKeybinds.load(std::memory_order_relaxed); }
+
+    // Records waiting in the queues (render thread).
+    size_t GetQueuedEvents() const { return m_pendingEvents.SizeApprox(); }
+    size_t GetQueuedKeybinds() const { return m_pendingKeybinds.SizeApprox(); }
 
-    // Queue a keybind into the addon's pending keybinds (thread-safe).
-    void QueueKeybind(const std::string& identifier, bool isRelease);
+    // Repeated presses of a held keybind that were folded into one.
+    uint64_t GetCoalescedKeybinds() const { return m_coalescedKeybinds; }
+
+    // Active event subscriptions with their delivery counters.
+    const std::unordered_map<NameIntern::Id, EventSubscription>& GetEventSubscriptions() const {
+        return m_subscriptions;
+    }
 
 private:
     AddonManifest m_manifest;
@@ -115,25 +193,62 @@ private:
     // DevTools
     CefRefPtr<InProcessBrowser> m_devTools;
 
-    // Per-addon event dispatch
+    // Per-addon event dispatch. Game-thread producers push fixed-size
+    // records; the render thread drains them in FlushPendingEvents.
+    static constexpr size_t EVENT_QUEUE_CAPACITY = 512;
     struct PendingEvent {
-        std::string name;
-        std::string jsonData;
+        uint64_t             seq;
+        NameIntern::Id       name;
+        EventCodecs::CodecId codec;
+        uint16_t             payloadSize;
+        alignas(8) uint8_t   payload[EventCodecs::MAX_RECORD_BYTES];
     };
-    std::mutex                    m_eventMutex;
-    std::vector<PendingEvent>     m_pendingEvents;
+    MpscRing<PendingEvent, EVENT_QUEUE_CAPACITY> m_pendingEvents;
+    std::atomic<uint32_t> m_droppedEvents{0};
+    uint32_t              m_reportedDroppedEvents = 0; // render thread
+
+    // Subscriptions routed via EventRouter, by interned event name
+    std::unordered_map<NameIntern::Id, EventSubscription> m_subscriptions;
+
+    // Render-thread drain state: the records popped this flush, the newest
+    // record per (event, key) for Coalesce, and the record each Sample
+    // subscription is holding until its next slot.
+    std::vector<PendingEvent>                     m_flushBatch;
+    std::unordered_map<uint64_t, size_t>          m_coalesceSlots;
+    std::unordered_map<NameIntern::Id, PendingEvent> m_heldSamples;
+
+    void ApplyEventPolicies();
+    void EmitAggregates(InProcessBrowser* browser);
 
-    static constexpr int MAX_EVENT_SLOTS = 64;
-    std::string m_eventSlotNames[MAX_EVENT_SLOTS];
-    bool        m_eventSlotUsed[MAX_EVENT_SLOTS] = {};
-    std::unordered_map<std::string, int> m_eventSlots;
+    std::map<std::string, std::unique_ptr<EventAggregator>> m_aggregators; // by page-chosen ID
+    void DeliverHeldSamples(InProcessBrowser* browser);
 
     // Per-addon keybind dispatch
+    static constexpr size_t KEYBIND_QUEUE_CAPACITY = 128;
     struct PendingKeybind {
-        std::string identifier;
-        bool        isRelease;
+        NameIntern::Id identifier;
+        bool           isRelease;
     };
-    std::mutex                          m_keybindMutex;
-    std::vector<PendingKeybind>         m_pendingKeybinds;
-    std::unordered_set<std::string>     m_registeredKeybinds; // un-prefixed IDs
+    MpscRing<PendingKeybind, KEYBIND_QUEUE_CAPACITY> m_pendingKeybinds;
+    std::atomic<uint32_t> m_droppedKeybinds{0};
+    uint32_t              m_reportedDroppedKeybinds = 0; // render thread
+    uint64_t              m_coalescedKeybinds = 0;       // render thread
+    std::unordered_set<NameIntern::Id> m_keybindsDown;   // pressed, not yet released
+    uint32_t              m_keybindsDownLoad = 0;        // page load m_keybindsDown belongs to
+    uint32_t              m_keybindsDownDropped = 0;     // m_droppedKeybinds when last checked
+
+    void ReportDroppedRecords();
+    void DiscardPendingRecords();
+    void DeliverEvent(InProcessBrowser* browser, const PendingEvent& ev);
+
+    std::unordered_set<std::string>                 m_registeredKeybinds; // un-prefixed IDs
+    std::unordered_map<NameIntern::Id, std::string> m_keybindNames;       // interned full ID -> un-prefixed ID
+
+    // Names this addon has interned, up to MAX_NAMES_PER_ADDON; kept after unsubscribing
+    std::unordered_set<NameIntern::Id> m_claimedNames;
+    bool                               m_claimLimitLogged = false;
+
+    // Intern `name` for this addon. False (logged) once the addon is at
+    // MAX_NAMES_PER_ADDON and `name` is new to it, or if the table is full.
+    bool ClaimName(const std::string& name);
 };
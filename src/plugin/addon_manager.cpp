@@ -1,6 +1,15 @@
 #include "addon_manager.h"
 #include "addon_instance.h"
+#include "addon_bundle.h"
 #include "addon_scheme_handler.h"
+#include "asset_io.h"
+#include "asset_preload.h"
+#include "asset_cache.h"
+#include "event_router.h"
+#include "game_state.h"
+#include "js_dispatch.h"
+#include "ipc_handler.h"
+#include "worker_pool.h"
 #include "cef_loader.h"
 #include "globals.h"
 #include "shared/version.h"
@@ -8,6 +17,10 @@
 #include "nlohmann/json.hpp"
 
 #include <windows.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 
 using json = nlohmann::json;
@@ -17,11 +30,32 @@ namespace AddonManager {
 static std::map<std::string, std::shared_ptr<AddonInstance>> s_addons;
 static constexpr DWORD BROWSER_CREATION_TIMEOUT_MS = 15000;
 
+// Headers the scheme handler sets itself (or Chromium derives from them);
+// a manifest cannot override these.
+static const char* const RESERVED_HEADERS[] = {
+    "accept-ranges", "cache-control", "content-encoding", "content-length",
+    "content-range", "content-type", "etag", "transfer-encoding", "vary",
+};
+
+// Whether `name` is an HTTP token the manifest may set.
+static bool IsAllowedHeader(const std::string& name) {
+    if (name.empty()) return false;
+    for (char c : name) {
+        if (!isalnum(static_cast<unsigned char>(c)) &&
+            (c == '\0' || !strchr("!#$%&'*+-.^_`|~", c))) {
+            return false;
+        }
+    }
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return std::find(std::begin(RESERVED_HEADERS), std::end(RESERVED_HEADERS), lower) ==
+           std::end(RESERVED_HEADERS);
+}
+
 // Parse a manifest.json file into an AddonManifest. Returns false if invalid.
 static bool ParseManifest(const std::string& addonDir, const std::string& addonId, AddonManifest& out) {
-    std::string manifestPath = addonDir + "\\manifest.json";
-
-    std::ifstream file(manifestPath);
+    std::ifstream file(std::filesystem::path(addonDir) / "manifest.json");
     if (!file.is_open()) return false;
 
     json j;
@@ -56,65 +90,171 @@ static bool ParseManifest(const std::string& addonDir, const std::string& addonI
     out.entry       = j["entry"].get<std::string>();
     out.basePath    = addonDir;
 
+    // Optional: Cache-Control per file extension
+    if (j.contains("cache") && j["cache"].is_object()) {
+        for (const auto& [ext, value] : j["cache"].items()) {
+            std::string policy = value.is_string() ? value.get<std::string>() : "";
+            if (policy.empty() || policy.find_first_of("\r\n") != std::string::npos) {
+                if (Globals::API) {
+                    Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                        (std::string("Ignoring invalid cache policy '") + ext + "' for '" +
+                         addonId + "'").c_str());
+                }
+                continue;
+            }
+            std::string key = (!ext.empty() && ext[0] == '.') ? ext.substr(1) : ext;
+            std::transform(key.begin(), key.end(), key.begin(),
+                [](unsigned char c) { return static_cast<char>(tolower(c)); });
+            out.cachePolicies[key] = policy;
+        }
+    }
+
+    // Optional: files to warm before the browser starts (paths or globs)
+    if (j.contains("preload")) {
+        const json& preload = j["preload"];
+        for (const auto& item : preload.is_array() ? preload : json::array({ preload })) {
+            if (!item.is_string() || item.get<std::string>().empty()) {
+                if (Globals::API) {
+                    Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                        (std::string("Ignoring invalid preload entry for '") + addonId + "'").c_str());
+                }
+                continue;
+            }
+            out.preload.push_back(AssetCache::NormalizePath(item.get<std::string>()));
+        }
+    }
+
+    // Optional: response headers, and cross-origin isolation
+    if (j.contains("headers") && j["headers"].is_object()) {
+        for (const auto& [name, value] : j["headers"].items()) {
+            std::string text = value.is_string() ? value.get<std::string>() : "";
+            if (!IsAllowedHeader(name) || text.empty() ||
+                text.find_first_of(std::string("\r\n\0", 3)) != std::string::npos) {
+                if (Globals::API) {
+                    Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                        (std::string("Ignoring invalid header '") + name + "' for '" +
+                         addonId + "'").c_str());
+                }
+                continue;
+            }
+            out.headers[name] = text;
+        }
+    }
+    if (j.contains("crossOriginIsolated") && j["crossOriginIsolated"].is_boolean()) {
+        out.crossOriginIsolated = j["crossOriginIsolated"].get<bool>();
+    }
+
+    // A packed bundle next to the manifest is served in place of loose files
+    std::error_code ec;
+    std::filesystem::path bundle = std::filesystem::path(addonDir) / AddonBundle::FILE_NAME;
+    if (std::filesystem::is_regular_file(bundle, ec)) {
+        out.bundlePath = bundle.string();
+    }
+
     return true;
 }
 
-void Initialize() {
-    if (!Globals::API) return;
-    if (!CefLoader::IsAvailable()) return;
+// A file name as UTF-8 for log lines, "?" if even that fails.
+static std::string Utf8Name(const std::filesystem::path& path) {
+    try {
+        std::u8string name = path.filename().u8string();
+        return std::string(reinterpret_cast<const char*>(name.data()), name.size());
+    } catch (...) {
+        return "?";
+    }
+}
+
+// Parse the manifest of every addon directory. Logs and returns an empty list
+// if there is none.
+static std::vector<AddonManifest> ScanAddons() {
+    std::vector<AddonManifest> manifests;
 
     // Get the addon scan directory: <GW2>/addons/jsloader/
     const char* addonDir = Globals::API->Paths_GetAddonDirectory("jsloader");
     if (!addonDir) {
         Globals::API->Log(LOGL_WARNING, ADDON_NAME,
             "Could not get jsloader addon directory.");
-        return;
+        return manifests;
     }
 
-    std::string scanDir(addonDir);
+    std::filesystem::path scanDir(addonDir);
     Globals::API->Log(LOGL_INFO, ADDON_NAME,
-        (std::string("Scanning for addons in: ") + scanDir).c_str());
+        (std::string("Scanning for addons in: ") + addonDir).c_str());
 
     // Enumerate subdirectories
-    std::string searchPattern = scanDir + "\\*";
-    WIN32_FIND_DATAA findData;
-    HANDLE hFind = FindFirstFileA(searchPattern.c_str(), &findData);
-    if (hFind == INVALID_HANDLE_VALUE) {
+    std::error_code ec;
+    std::filesystem::directory_iterator it(scanDir, ec);
+    if (ec) {
         Globals::API->Log(LOGL_INFO, ADDON_NAME,
             "No addons found (directory empty or does not exist).");
-        return;
+        return manifests;
     }
 
-    int addonCount = 0;
-    do {
-        // Skip . and ..
-        if (findData.cFileName[0] == '.') continue;
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        // string() throws for names the ANSI code page cannot represent
+        std::string addonId, addonPath;
+        try {
+            addonId = it->path().filename().string();
+            addonPath = it->path().string();
+        } catch (...) {
+            Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                ("Skipping addon folder '" + Utf8Name(it->path()) +
+                 "': its path has characters outside the system code page.").c_str());
+            continue;
+        }
 
-        // Only process directories
-        if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) continue;
+        // Skip hidden entries
+        if (addonId.empty() || addonId[0] == '.') continue;
 
-        std::string addonId(findData.cFileName);
-        std::string addonPath = scanDir + "\\" + addonId;
+        // Only process directories
+        if (!it->is_directory(ec)) continue;
 
         AddonManifest manifest;
         if (!ParseManifest(addonPath, addonId, manifest)) continue;
+        manifests.push_back(std::move(manifest));
+    }
+    return manifests;
+}
+
+// Scanned by Preload, taken by the next Initialize
+static std::vector<AddonManifest> s_scanned;
+static bool                       s_preloaded = false;
+
+void Preload() {
+    if (!Globals::API) return;
+
+    AssetIo::Start();
+    s_scanned = ScanAddons();
+    s_preloaded = true;
+    AssetPreload::Start(s_scanned);
+}
 
+void Initialize() {
+    if (!Globals::API) return;
+    if (!CefLoader::IsAvailable()) return;
+
+    IpcHandler::Initialize();
+    AssetIo::Start();
+
+    std::vector<AddonManifest> manifests = s_preloaded ? std::move(s_scanned) : ScanAddons();
+    s_scanned.clear();
+    s_preloaded = false;
+
+    int addonCount = 0;
+    for (const AddonManifest& manifest : manifests) {
         // Register scheme handler for this addon
-        AddonSchemeHandler::RegisterForAddon(manifest.id, manifest.basePath);
+        AddonSchemeHandler::RegisterForAddon(manifest);
 
         // Create addon instance
         auto instance = std::make_shared<AddonInstance>(manifest);
         instance->CreateMainBrowser();
-        s_addons[addonId] = instance;
+        s_addons[manifest.id] = instance;
         ++addonCount;
 
         Globals::API->Log(LOGL_INFO, ADDON_NAME,
             (std::string("Loaded addon: ") + manifest.name + " v" + manifest.version +
              " by " + manifest.author).c_str());
-
-    } while (FindNextFileA(hFind, &findData));
-
-    FindClose(hFind);
+    }
 
     char msg[128];
     snprintf(msg, sizeof(msg), "Addon scan complete. %d addon(s) loaded.", addonCount);
@@ -122,12 +262,21 @@ void Initialize() {
 }
 
 void Shutdown() {
+    // Stop bridge work before the addons and browsers it refers to go away
+    IpcHandler::Shutdown();
+    RenderBatch::Clear();
+
     for (auto& [id, addon] : s_addons) {
         addon->Shutdown();
     }
     s_addons.clear();
+    EventRouter::Shutdown();
+    GameState::Shutdown();
 
-    // Unregister all scheme handlers
+    // Finish in-flight file loads (and preloads), then unregister all scheme handlers
+    AssetIo::Stop();
+    s_scanned.clear();
+    s_preloaded = false;
     AddonSchemeHandler::UnregisterAll();
 }
 
@@ -138,9 +287,14 @@ void FlushAllFrames() {
 }
 
 void FlushAllPendingEvents() {
+    // Bridge actions and worker responses queued since the last frame
+    RenderBatch::Run();
+
     for (auto& [id, addon] : s_addons) {
         addon->FlushPendingEvents();
     }
+    GameState::Tick();
+    JsDispatch::EndFrame();
 }
 
 bool AnyReady() {
@@ -3,6 +3,7 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <vector>
 
 class AddonInstance;
 
@@ -14,12 +15,33 @@ struct AddonManifest {
     std::string description;
     std::string entry;       // e.g. "index.html"
     std::string basePath;    // absolute filesystem path to addon dir
+    std::string bundlePath;  // packed assets (addon.pack), empty if loose files only
+
+    // Cache-Control for served files, by extension (lower case, no dot);
+    // "*" applies to all others
+    std::map<std::string, std::string> cachePolicies;
+
+    // Paths or globs (normalized) warmed into the asset cache before the
+    // browser starts
+    std::vector<std::string> preload;
+
+    // Extra response headers on every served file
+    std::map<std::string, std::string> headers;
+
+    // Serve files with COOP/COEP, so pages are cross-origin isolated
+    // (SharedArrayBuffer, WASM threads)
+    bool crossOriginIsolated = false;
 };
 
 // Discovers addons from disk, owns their lifecycle, provides accessors.
 namespace AddonManager {
 
-// Scan addon directory, parse manifests, register scheme handlers, create browsers.
+// Scan addon directory and parse manifests while CEF is not ready yet, and
+// start warming the files the manifests list for preload. Call at addon load.
+void Preload();
+
+// Scan addon directory (unless Preload did), parse manifests, register scheme
+// handlers, create browsers.
 void Initialize();
 
 // Shut down all addons, close browsers, unregister scheme handlers.
@@ -28,7 +50,8 @@ void Shutdown();
 // Apply buffered pixel data for all addon browsers. Call from render thread.
 void FlushAllFrames();
 
-// Flush pending events/keybinds to JS for all addons. Call from OnPreRender.
+// Flush pending events/keybinds and game-state updates to JS for all addons.
+// Call from OnPreRender.
 void FlushAllPendingEvents();
 
 // Whether at least one addon's browser is ready.
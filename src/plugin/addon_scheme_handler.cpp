@@ -1,19 +1,41 @@
 #include "addon_scheme_handler.h"
+#include "addon_bundle.h"
+#include "addon_file_index.h"
+#include "addon_manager.h"
+#include "asset_cache.h"
+#include "asset_resource_handler.h"
 #include "globals.h"
+#include "js_dispatch.h"
+#include "mapped_file.h"
 #include "shared/version.h"
 
 #include "include/cef_scheme.h"
 #include "include/cef_parser.h"
-#include "include/cef_stream.h"
-#include "include/wrapper/cef_stream_resource_handler.h"
 
+#include <map>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
-// Maps addon ID → base path for file resolution.
-static std::unordered_map<std::string, std::string> s_addonPaths;
+// What an addon's files are served from, and how.
+struct AddonSite {
+    std::shared_ptr<const AddonBundle>            bundle;         // if the addon ships one
+    std::unordered_map<std::string, std::string>  cachePolicies;  // extension → Cache-Control
+    std::string                                   defaultCachePolicy;
+    std::shared_ptr<const CefResponse::HeaderMap> headers;        // manifest headers, COOP/COEP
+};
+
+// Maps addon ID → its site.
+static std::unordered_map<std::string, AddonSite> s_addonSites;
+
+// Without a manifest policy: the browser may keep a copy but revalidates it on
+// every use, which an unchanged file answers with a bodiless 304.
+static constexpr const char* DEFAULT_CACHE_POLICY = "no-cache";
 
 // Registered domain names for cleanup.
 static std::vector<std::string> s_registeredDomains;
@@ -34,6 +56,109 @@ static std::string GetFileExtension(const std::string& path) {
     return path.substr(pos + 1);
 }
 
+// Precompressed sibling (file.js.br) or bundle entry, and the Content-Encoding
+// it is served with. Chromium decodes it in the network stack.
+struct Encoding {
+    const char* suffix;
+    const char* name;
+};
+
+static const Encoding s_encodings[] = {
+    { ".br", "br" },
+    { ".gz", "gzip" },
+};
+
+// Whether an Accept-Encoding header lists the coding (and not with q=0).
+// No header at all: Chromium always accepts gzip and br.
+static bool AcceptsEncoding(const CefString& header, const char* name) {
+    std::string value = header.ToString();
+    if (value.empty()) return true;
+
+    size_t start = 0;
+    while (start < value.size()) {
+        size_t end = value.find(',', start);
+        if (end == std::string::npos) end = value.size();
+        std::string item = value.substr(start, end - start);
+        start = end + 1;
+
+        size_t params = item.find(';');
+        std::string coding = item.substr(0, params);
+        coding.erase(0, coding.find_first_not_of(" \t"));
+        coding.erase(coding.find_last_not_of(" \t") + 1);
+        if (!std::equal(coding.begin(), coding.end(), name, name + strlen(name),
+                [](char a, char b) { return tolower(static_cast<unsigned char>(a)) == b; })) {
+            continue;
+        }
+
+        if (params == std::string::npos) return true;
+        size_t q = item.find("q=", params);
+        return q == std::string::npos || atof(item.c_str() + q + 2) > 0.0;
+    }
+    return false;
+}
+
+static CefResponse::HeaderMap ResponseHeaders(const std::string& cachePolicy,
+                                              const Encoding* encoding,
+                                              const CefResponse::HeaderMap& extra) {
+    CefResponse::HeaderMap headers = extra;
+    headers.insert(std::make_pair("Cache-Control", cachePolicy));
+    if (encoding) {
+        headers.insert(std::make_pair("Content-Encoding", encoding->name));
+        headers.insert(std::make_pair("Vary", "Accept-Encoding"));
+    }
+    return headers;
+}
+
+// Body of an indexed file, from the addon's asset cache (read into it on a
+// miss), or mapped if it is too large to cache. Asset I/O pool.
+static bool LoadFile(const std::string& addonId, const std::string& key,
+                     const AddonFileIndex::File& file, AssetResourceHandler::Body& body) {
+    if (std::shared_ptr<const AssetCache::Asset> asset =
+            AssetCache::Get(addonId, key, file.path, file.size, file.mtime, file.hash)) {
+        body.data = std::shared_ptr<const char>(asset, asset->data->data());
+        body.size = asset->data->size();
+        body.etag = AssetCache::ETag(asset->hash);
+        return true;
+    }
+
+    // Too large to cache (large media): ranges are served straight from the
+    // OS file cache. Not hashed: the ETag is weak, from size and write time.
+    std::shared_ptr<const MappedFile> mapped = MappedFile::Open(file.path);
+    if (!mapped) return false;
+
+    char etag[48];
+    snprintf(etag, sizeof(etag), "W/\"%zx-%llx\"", mapped->GetSize(),
+        static_cast<unsigned long long>(mapped->GetWriteTime()));
+    body.data = std::shared_ptr<const char>(mapped, mapped->GetData());
+    body.size = mapped->GetSize();
+    body.etag = etag;
+    body.mapped = true;
+    return true;
+}
+
+// Serve a payload staged by JsDispatch (path: __nexus/blob/<id>).
+static CefRefPtr<CefResourceHandler> CreateBlobHandler(const std::string& addonId,
+                                                       const std::string& idStr) {
+    uint64_t blobId = 0;
+    try {
+        blobId = std::stoull(idStr);
+    } catch (...) {
+        return nullptr;
+    }
+
+    auto data = std::make_shared<std::string>();
+    std::string mimeType;
+    if (!JsDispatch::TakeBlob(addonId, blobId, *data, mimeType)) return nullptr;
+
+    // The handler keeps the taken blob alive; nothing is copied.
+    AssetResourceHandler::Body body;
+    body.size = data->size();
+    body.data = std::shared_ptr<const char>(data, data->data());
+    body.mimeType = mimeType;
+    body.headers.insert(std::make_pair("Cache-Control", "no-store"));
+    return new AssetResourceHandler(addonId, std::move(body));
+}
+
 // CefSchemeHandlerFactory implementation that serves local addon files.
 class AddonSchemeHandlerFactory : public CefSchemeHandlerFactory {
 public:
@@ -48,31 +173,24 @@ public:
 
         std::string url = request->GetURL().ToString();
 
-        // Parse the URL path: https://<addon-id>.jsloader.local/<path>
-        // Find the path after the domain
-        std::string domain = m_addonId + ".jsloader.local";
-        auto domainPos = url.find(domain);
-        if (domainPos == std::string::npos) return nullptr;
-
-        std::string path = url.substr(domainPos + domain.size());
+        // https://<addon-id>.jsloader.local/<path>: the factory is registered
+        // for this host only, so the path starts at the first '/' after it
+        size_t hostStart = url.find("://");
+        if (hostStart == std::string::npos) return nullptr;
+        size_t pathStart = url.find('/', hostStart + 3);
+        pathStart = pathStart == std::string::npos ? url.size() : pathStart + 1;
+        size_t pathEnd = url.find_first_of("?#", pathStart);
+        if (pathEnd == std::string::npos) pathEnd = url.size();
 
-        // Strip leading slash
-        if (!path.empty() && path[0] == '/') {
-            path = path.substr(1);
+        // URL-decode the path (handle %20 etc.), only if it is encoded
+        std::string path = url.substr(pathStart, pathEnd - pathStart);
+        if (path.find('%') != std::string::npos) {
+            path = CefURIDecode(path, true,
+                static_cast<cef_uri_unescape_rule_t>(
+                    UU_SPACES | UU_PATH_SEPARATORS | UU_URL_SPECIAL_CHARS_EXCEPT_PATH_SEPARATORS
+                )).ToString();
         }
 
-        // Strip query string and fragment
-        auto queryPos = path.find('?');
-        if (queryPos != std::string::npos) path = path.substr(0, queryPos);
-        auto fragPos = path.find('#');
-        if (fragPos != std::string::npos) path = path.substr(0, fragPos);
-
-        // URL-decode the path (handle %20 etc.)
-        path = CefURIDecode(path, true,
-            static_cast<cef_uri_unescape_rule_t>(
-                UU_SPACES | UU_PATH_SEPARATORS | UU_URL_SPECIAL_CHARS_EXCEPT_PATH_SEPARATORS
-            )).ToString();
-
         // Validate path safety (no traversal)
         if (!IsPathSafe(path)) {
             if (Globals::API) {
@@ -82,39 +200,117 @@ public:
             return nullptr;
         }
 
-        // Look up base path for this addon
-        auto it = s_addonPaths.find(m_addonId);
-        if (it == s_addonPaths.end()) return nullptr;
+        // Payloads staged by the native->JS dispatcher
+        const size_t blobPrefixLen = strlen(JsDispatch::BLOB_PATH_PREFIX);
+        if (path.compare(0, blobPrefixLen, JsDispatch::BLOB_PATH_PREFIX) == 0) {
+            return CreateBlobHandler(m_addonId, path.substr(blobPrefixLen));
+        }
 
-        // Construct full filesystem path
-        std::string filePath = it->second + "\\" + path;
+        auto site = s_addonSites.find(m_addonId);
+        if (site == s_addonSites.end()) return nullptr;
 
-        // Replace forward slashes with backslashes for Windows
-        std::replace(filePath.begin(), filePath.end(), '/', '\\');
+        std::string key = AssetCache::NormalizePath(path);
 
-        // Create file stream
-        CefRefPtr<CefStreamReader> stream =
-            CefStreamReader::CreateForFile(filePath);
-        if (!stream) {
-            if (Globals::API) {
-                Globals::API->Log(LOGL_DEBUG, ADDON_NAME,
-                    (std::string("File not found: ") + filePath).c_str());
+        // Cache policy by extension
+        std::string ext = GetFileExtension(key);  // already lower case
+        auto policy = site->second.cachePolicies.find(ext);
+        const std::string& cachePolicy = policy != site->second.cachePolicies.end()
+            ? policy->second : site->second.defaultCachePolicy;
+
+        // Precompressed variants the browser accepts, in order of preference
+        std::vector<const Encoding*> encodings;
+        CefString acceptEncoding = request->GetHeaderByName("Accept-Encoding");
+        for (const Encoding& encoding : s_encodings) {
+            if (AcceptsEncoding(acceptEncoding, encoding.name)) encodings.push_back(&encoding);
+        }
+
+        // Packed bundle: a slice of the mapping, nothing read or copied
+        if (site->second.bundle) {
+            for (const Encoding* encoding : encodings) {
+                if (auto handler = ServeBundleEntry(site->second, key + encoding->suffix, ext,
+                                                    cachePolicy, encoding)) {
+                    return handler;
+                }
+            }
+            if (auto handler = ServeBundleEntry(site->second, key, ext, cachePolicy, nullptr)) {
+                return handler;
             }
-            return nullptr;
         }
 
-        // Determine MIME type from file extension
-        std::string ext = GetFileExtension(path);
-        CefString mimeType = CefGetMimeType(ext);
-        if (mimeType.empty()) {
-            mimeType = "application/octet-stream";
+        // Loose files: resolved in the index built at registration, so a
+        // missing file (or sibling) costs a hash lookup, not a disk probe.
+        // file.js.br / file.js.gz siblings first, then the file itself.
+        std::shared_ptr<const AddonFileIndex::Index> index = AddonFileIndex::Get(m_addonId);
+        if (!index) return AssetResourceHandler::NotFound(m_addonId);
+
+        auto original = index->find(key);
+        std::string fileKey = key;
+        const AddonFileIndex::File* file = nullptr;
+        const Encoding* fileEncoding = nullptr;
+        for (const Encoding* encoding : encodings) {
+            fileKey.resize(key.size());
+            fileKey += encoding->suffix;
+            auto variant = index->find(fileKey);
+            if (variant != index->end()) {
+                file = &variant->second;
+                fileEncoding = encoding;
+                break;
+            }
         }
+        if (!file) {
+            if (original == index->end()) {
+                if (Globals::API) {
+                    Globals::API->Log(LOGL_DEBUG, ADDON_NAME,
+                        (std::string("File not found: ") + m_addonId + "/" + path).c_str());
+                }
+                return AssetResourceHandler::NotFound(m_addonId);
+            }
+            fileKey = key;
+            file = &original->second;
+        }
+
+        // Compressed variants carry the original's MIME type
+        std::string mimeType = original != index->end() ? original->second.mimeType
+                                                        : AddonFileIndex::MimeTypeFor(ext);
 
-        // Return a stream resource handler
-        return new CefStreamResourceHandler(mimeType, stream);
+        // Read on the asset I/O pool; the index snapshot keeps `file` alive
+        return new AssetResourceHandler(m_addonId,
+            [addonId = m_addonId, index, file, fileKey = std::move(fileKey),
+             mimeType = std::move(mimeType), cachePolicy = cachePolicy,
+             headers = site->second.headers, fileEncoding](AssetResourceHandler::Body& body) {
+                if (!LoadFile(addonId, fileKey, *file, body)) {
+                    if (Globals::API) {
+                        Globals::API->Log(LOGL_DEBUG, ADDON_NAME,
+                            ("Cannot read file: " + fileKey).c_str());
+                    }
+                    return false;
+                }
+                body.mimeType = mimeType;
+                body.headers = ResponseHeaders(cachePolicy, fileEncoding, *headers);
+                return true;
+            });
     }
 
 private:
+    CefRefPtr<CefResourceHandler> ServeBundleEntry(
+        const AddonSite& site, const std::string& key,
+        const std::string& ext, const std::string& cachePolicy, const Encoding* encoding) {
+        const std::shared_ptr<const AddonBundle>& bundle = site.bundle;
+        const AddonBundle::Entry* entry = bundle->Find(key);
+        if (!entry) return nullptr;
+
+        AssetResourceHandler::Body body;
+        body.data = std::shared_ptr<const char>(bundle, entry->data);
+        body.size = entry->size;
+        // Compressed entries carry the original's MIME type
+        body.mimeType = entry->mimeType.empty() ? AddonFileIndex::MimeTypeFor(ext)
+                                                : std::string(entry->mimeType);
+        body.headers = ResponseHeaders(cachePolicy, encoding, *site.headers);
+        body.etag = AssetCache::ETag(entry->hash);
+        body.mapped = true;
+        return new AssetResourceHandler(m_addonId, std::move(body));
+    }
+
     std::string m_addonId;
 
     IMPLEMENT_REFCOUNTING(AddonSchemeHandlerFactory);
@@ -123,8 +319,54 @@ private:
 
 namespace AddonSchemeHandler {
 
-void RegisterForAddon(const std::string& addonId, const std::string& basePath) {
-    s_addonPaths[addonId] = basePath;
+void RegisterForAddon(const AddonManifest& manifest) {
+    // Cached files are kept: preloaded while waiting for CEF, and validated
+    // against the index on every lookup
+    const std::string& addonId = manifest.id;
+
+    AddonSite site;
+    for (const auto& [ext, policy] : manifest.cachePolicies) {
+        if (ext == "*") {
+            site.defaultCachePolicy = policy;
+        } else {
+            site.cachePolicies[ext] = policy;
+        }
+    }
+    if (site.defaultCachePolicy.empty()) site.defaultCachePolicy = DEFAULT_CACHE_POLICY;
+
+    // Cross-origin isolation first, so the manifest can relax it (e.g.
+    // Cross-Origin-Embedder-Policy: credentialless); names compare case-blind
+    std::map<std::string, std::pair<std::string, std::string>> headers;
+    auto setHeader = [&headers](const std::string& name, const std::string& value) {
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+            [](unsigned char c) { return static_cast<char>(tolower(c)); });
+        headers[lower] = { name, value };
+    };
+    if (manifest.crossOriginIsolated) {
+        setHeader("Cross-Origin-Opener-Policy", "same-origin");
+        setHeader("Cross-Origin-Embedder-Policy", "require-corp");
+    }
+    for (const auto& [name, value] : manifest.headers) setHeader(name, value);
+
+    auto headerMap = std::make_shared<CefResponse::HeaderMap>();
+    for (const auto& [lower, header] : headers) headerMap->insert(header);
+    site.headers = std::move(headerMap);
+
+    if (!manifest.bundlePath.empty()) {
+        if (auto bundle = AddonBundle::Open(manifest.bundlePath)) {
+            if (Globals::API) {
+                char msg[256];
+                snprintf(msg, sizeof(msg), "Addon '%s': serving %zu file(s) from %s (%.1f MB).",
+                    addonId.c_str(), bundle->GetEntries().size(), AddonBundle::FILE_NAME,
+                    bundle->GetFileSize() / (1024.0 * 1024.0));
+                Globals::API->Log(LOGL_INFO, ADDON_NAME, msg);
+            }
+            site.bundle = std::move(bundle);
+        }
+    }
+    s_addonSites[addonId] = std::move(site);
+    AddonFileIndex::Build(addonId, manifest.basePath);
 
     std::string domain = addonId + ".jsloader.local";
 
@@ -145,7 +387,9 @@ void UnregisterAll() {
         CefRegisterSchemeHandlerFactory("https", domain, nullptr);
     }
     s_registeredDomains.clear();
-    s_addonPaths.clear();
+    s_addonSites.clear();  // bundle mappings stay alive until in-flight handlers finish
+    AddonFileIndex::Clear();
+    AssetCache::Clear();
 }
 
 } // namespace AddonSchemeHandler
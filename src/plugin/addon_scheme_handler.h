@@ -2,13 +2,23 @@
 
 #include <string>
 
+struct AddonManifest;
+
 // Serves local addon files via HTTPS scheme with synthetic domains.
 // URL pattern: https://<addon-id>.jsloader.local/<path>
+// Files are served from the addon's bundle (addon_bundle.h) if it has one,
+// else from a per-addon in-memory cache (asset_cache.h) or, for files too
+// large to cache, a mapping; loose files are read on the asset I/O pool
+// (asset_io.h), off CEF's IO thread. Responses carry ETags (strong, from content
+// hashes, where the content is hashed), are revalidated with If-None-Match,
+// and support single byte ranges.
 namespace AddonSchemeHandler {
 
 // Register a scheme handler factory for a specific addon.
-// The factory resolves URL paths to local files under basePath.
-void RegisterForAddon(const std::string& addonId, const std::string& basePath);
+// The factory resolves URL paths to local files under the manifest's
+// basePath. If it has a bundlePath, the bundle is mapped and its entries are
+// served first. Responses carry the manifest's cache policies.
+void RegisterForAddon(const AddonManifest& manifest);
 
 // Unregister all scheme handler factories.
 void UnregisterAll();
@@ -0,0 +1,228 @@
+#include "asset_cache.h"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace AssetCache {
+
+struct Entry {
+    std::string                  key;
+    std::shared_ptr<const Asset> asset;
+};
+
+struct AddonCache {
+    std::list<Entry>                                           lru;  // front = most recent
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    Stats                                                      stats;
+};
+
+// Distinct contents still alive, counted by the buffers themselves: the last
+// reference may be dropped with or without s_mutex held
+static std::atomic<uint64_t> s_contentBytes{0};
+static std::atomic<uint32_t> s_contentBuffers{0};
+
+// One resident copy of a file's contents, shared by every entry with them.
+struct Content {
+    std::string bytes;
+
+    explicit Content(std::string data) : bytes(std::move(data)) {
+        s_contentBytes += bytes.size();
+        ++s_contentBuffers;
+    }
+    ~Content() {
+        s_contentBytes -= bytes.size();
+        --s_contentBuffers;
+    }
+};
+
+static std::mutex                                                  s_mutex;
+static std::unordered_map<std::string, std::unique_ptr<AddonCache>> s_addons;
+static std::unordered_map<uint64_t, std::weak_ptr<const Content>>   s_contents;  // by ContentHash
+static uint64_t                                                    s_sharedLoads = 0;
+
+// s_mutex held
+static AddonCache& GetCache(const std::string& addonId) {
+    auto& cache = s_addons[addonId];
+    if (!cache) cache = std::make_unique<AddonCache>();
+    return *cache;
+}
+
+// s_mutex held
+static void Erase(AddonCache& cache, std::list<Entry>::iterator it) {
+    cache.stats.residentBytes -= it->asset->size;
+    --cache.stats.entries;
+    cache.index.erase(it->key);
+    cache.lru.erase(it);
+}
+
+std::string NormalizePath(const std::string& path) {
+    std::string key;
+    key.reserve(path.size());
+
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find_first_of("/\\", start);
+        if (end == std::string::npos) end = path.size();
+
+        size_t length = end - start;
+        if (length > 0 && !(length == 1 && path[start] == '.')) {
+            if (!key.empty()) key += '/';
+            for (size_t i = start; i < end; ++i) {
+                char c = path[i];
+                key += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+            }
+        }
+        start = end + 1;
+    }
+    return key;
+}
+
+uint64_t ContentHash(const char* data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string ETag(uint64_t hash) {
+    char tag[24];
+    snprintf(tag, sizeof(tag), "\"%016llx\"", static_cast<unsigned long long>(hash));
+    return tag;
+}
+
+std::shared_ptr<const Asset> Get(const std::string& addonId, const std::string& key,
+                                 const std::filesystem::path& filePath, uint64_t size, int64_t mtime,
+                                 uint64_t hash) {
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        AddonCache& cache = GetCache(addonId);
+
+        if (size > MAX_ENTRY_BYTES) {
+            ++cache.stats.uncached;
+            return nullptr;
+        }
+
+        auto it = cache.index.find(key);
+        if (it != cache.index.end()) {
+            const Asset& cached = *it->second->asset;
+            if (cached.size == size && cached.mtime == mtime) {
+                cache.lru.splice(cache.lru.begin(), cache.lru, it->second);
+                ++cache.stats.hits;
+                cache.stats.bytesServed += size;
+                return it->second->asset;
+            }
+            Erase(cache, it->second);  // stale
+        }
+        ++cache.stats.misses;
+    }
+
+    // Read outside the lock: other addons' (and this addon's) hits go on.
+    // A file that no longer has the indexed size was changed after the index
+    // was built: not cached, the caller maps the current contents.
+    std::string bytes(static_cast<size_t>(size), '\0');
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open() ||
+        !file.read(bytes.data(), static_cast<std::streamsize>(bytes.size())) ||
+        file.peek() != std::ifstream::traits_type::eof()) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        ++GetCache(addonId).stats.uncached;
+        return nullptr;
+    }
+    if (!hash) hash = ContentHash(bytes.data(), bytes.size());
+
+    // Another addon (or path) may already hold these bytes. Compared outside
+    // the lock; the candidate is kept alive by the local reference.
+    std::shared_ptr<const Content> content;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto slot = s_contents.find(hash);
+        if (slot != s_contents.end()) content = slot->second.lock();
+    }
+    bool shared = content && content->bytes == bytes;
+    if (!shared) content = std::make_shared<const Content>(std::move(bytes));
+
+    auto asset = std::make_shared<Asset>();
+    asset->data = std::shared_ptr<const std::string>(content, &content->bytes);
+    asset->hash = hash;
+    asset->size = size;
+    asset->mtime = mtime;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    AddonCache& cache = GetCache(addonId);
+    cache.stats.bytesRead += size;
+    cache.stats.bytesServed += size;
+
+    if (shared) {
+        ++s_sharedLoads;
+    } else {
+        // First holder of these bytes (or a hash collision: kept apart)
+        std::weak_ptr<const Content>& slot = s_contents[hash];
+        if (slot.expired()) slot = content;
+        if (s_contents.size() > 2 * static_cast<size_t>(s_contentBuffers) + 64) {
+            for (auto it = s_contents.begin(); it != s_contents.end();) {
+                it = it->second.expired() ? s_contents.erase(it) : std::next(it);
+            }
+        }
+    }
+
+    // Another request may have loaded the same file meanwhile
+    auto it = cache.index.find(key);
+    if (it != cache.index.end()) Erase(cache, it->second);
+
+    cache.lru.push_front({ key, asset });
+    cache.index[key] = cache.lru.begin();
+    cache.stats.residentBytes += size;
+    ++cache.stats.entries;
+
+    while (cache.stats.residentBytes > MAX_ADDON_BYTES && cache.lru.size() > 1) {
+        Erase(cache, std::prev(cache.lru.end()));
+        ++cache.stats.evictions;
+    }
+    return asset;
+}
+
+void Invalidate(const std::string& addonId) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = s_addons.find(addonId);
+    if (it == s_addons.end()) return;
+
+    AddonCache& cache = *it->second;
+    cache.lru.clear();
+    cache.index.clear();
+    cache.stats.residentBytes = 0;
+    cache.stats.entries = 0;
+}
+
+void Clear() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_addons.clear();
+    s_contents.clear();
+    s_sharedLoads = 0;
+}
+
+bool GetStats(const std::string& addonId, Stats& out) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = s_addons.find(addonId);
+    if (it == s_addons.end()) return false;
+    out = it->second->stats;
+    return true;
+}
+
+SharedStats GetSharedStats() {
+    SharedStats out;
+    std::lock_guard<std::mutex> lock(s_mutex);
+    for (const auto& [id, cache] : s_addons) out.cachedBytes += cache->stats.residentBytes;
+    out.residentBytes = s_contentBytes;
+    out.buffers = s_contentBuffers;
+    out.sharedLoads = s_sharedLoads;
+    return out;
+}
+
+} // namespace AssetCache
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Per-addon in-memory cache of files served by the scheme handler.
+//
+// Entries are keyed by normalized path (forward slashes, no "." or empty
+// segments, lower case — addon files live on a case-insensitive volume) and
+// validated against the size and modification time the caller has for the
+// file (the addon's file index), so an edited file is re-read once the index
+// has picked up the change. Each addon's entries
+// are kept in LRU order under a memory cap. Precompressed siblings
+// (file.js.br) are cached under their own key, as compressed bytes. Any
+// thread (CEF IO thread, UI).
+//
+// Contents are stored once per distinct file content: entries of any addon
+// whose bytes are identical (the same library shipped by several addons)
+// share one resident buffer, found by ContentHash and confirmed bytewise,
+// since FNV-1a does not keep one addon from forging another's hash.
+namespace AssetCache {
+
+// Largest file that is cached; bigger ones are served from a mapping.
+constexpr size_t MAX_ENTRY_BYTES = 8 * 1024 * 1024;
+
+// Memory cap per addon.
+constexpr size_t MAX_ADDON_BYTES = 32 * 1024 * 1024;
+
+struct Asset {
+    std::shared_ptr<const std::string> data;  // file contents, shared across addons
+    uint64_t                           hash = 0;   // ContentHash(*data)
+    uint64_t                           size = 0;   // validators, from the file index
+    int64_t                            mtime = 0;
+};
+
+// Normalized cache key for a relative path.
+std::string NormalizePath(const std::string& path);
+
+// FNV-1a 64 of a file's contents; the same hash addon bundles store.
+uint64_t ContentHash(const char* data, size_t size);
+
+// Strong HTTP entity tag for a content hash: the hash in hex, quoted.
+std::string ETag(uint64_t hash);
+
+// The file's contents, from the cache if its validators match `size` and
+// `mtime`, or read from `filePath` (and cached). `hash` is the file's
+// ContentHash from the index, 0 if it has not been hashed yet. Returns
+// nullptr if the file cannot be read or is larger than MAX_ENTRY_BYTES; the
+// caller then maps it.
+std::shared_ptr<const Asset> Get(const std::string& addonId, const std::string& key,
+                                 const std::filesystem::path& filePath, uint64_t size, int64_t mtime,
+                                 uint64_t hash);
+
+// Drop an addon's entries, keeping its counters (addon reload).
+void Invalidate(const std::string& addonId);
+
+// Drop every entry and counter (shutdown).
+void Clear();
+
+struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;        // not cached, or stale (file changed)
+    uint64_t uncached = 0;      // too large or unreadable: served from a mapping
+    uint64_t evictions = 0;
+    uint64_t bytesServed = 0;   // from memory
+    uint64_t bytesRead = 0;     // from disk into the cache
+    uint64_t residentBytes = 0;
+    uint32_t entries = 0;
+};
+
+// Copy of the addon's counters. Returns false if it has no cache yet.
+bool GetStats(const std::string& addonId, Stats& out);
+
+// Content shared between cache entries, across all addons.
+struct SharedStats {
+    uint64_t cachedBytes = 0;    // sum of every addon's residentBytes
+    uint64_t residentBytes = 0;  // distinct buffers actually held
+    uint32_t buffers = 0;
+    uint64_t sharedLoads = 0;    // misses that reused a resident buffer
+};
+
+SharedStats GetSharedStats();
+
+} // namespace AssetCache
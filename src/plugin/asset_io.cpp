@@ -0,0 +1,127 @@
+#include "asset_io.h"
+#include "ipc_stats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace AssetIo {
+
+using Clock = std::chrono::steady_clock;
+
+struct PendingJob {
+    WorkerPool::Job   job;
+    Clock::time_point posted;
+};
+
+struct AddonEntry {
+    std::deque<PendingJob> jobs;
+    bool                   ready = false;  // in s_ready
+    uint32_t               running = 0;
+    uint32_t               maxQueued = 0;
+    uint64_t               busyUs = 0;
+    IpcStats::Histogram    queueUs;
+};
+
+static std::mutex                                                  s_mutex;
+static std::unordered_map<std::string, std::unique_ptr<AddonEntry>> s_addons;
+static std::deque<AddonEntry*>                                      s_ready;  // turn order
+static std::unique_ptr<WorkerPool>                                  s_pool;
+
+// s_mutex held. Queue the addon for a turn if it has work and room to run it.
+static void MakeReady(AddonEntry& entry) {
+    if (!entry.ready && !entry.jobs.empty() && entry.running < MAX_RUNNING_PER_ADDON) {
+        entry.ready = true;
+        s_ready.push_back(&entry);
+    }
+}
+
+// One pool job per posted job. A job held back by its addon's limit is run
+// by the thread that finishes one of that addon's running jobs.
+static void RunNext() {
+    std::unique_lock<std::mutex> lock(s_mutex);
+    while (!s_ready.empty()) {
+        AddonEntry* entry = s_ready.front();
+        s_ready.pop_front();
+        entry->ready = false;
+
+        PendingJob pending = std::move(entry->jobs.front());
+        entry->jobs.pop_front();
+        ++entry->running;
+        MakeReady(*entry);  // next turn, if under the limit
+
+        Clock::time_point start = Clock::now();
+        entry->queueUs.Record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(start - pending.posted).count()));
+
+        lock.unlock();
+        pending.job();
+        pending.job = nullptr;  // release captures outside the lock
+        uint64_t busy = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+        lock.lock();
+
+        entry->busyUs += busy;
+        --entry->running;
+        MakeReady(*entry);
+    }
+}
+
+void Start() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_pool) s_pool = std::make_unique<WorkerPool>(THREAD_COUNT);
+}
+
+void Stop() {
+    std::unique_ptr<WorkerPool> pool;
+    std::vector<std::deque<PendingJob>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        pool = std::move(s_pool);
+        for (auto& [id, entry] : s_addons) {
+            dropped.push_back(std::move(entry->jobs));
+            entry->ready = false;
+        }
+        s_ready.clear();
+    }
+    // Outside the lock: running jobs still need it
+    if (pool) pool->Stop();
+}
+
+bool Post(const std::string& addonId, WorkerPool::Job job) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_pool) return false;
+
+    auto& entry = s_addons[addonId];
+    if (!entry) entry = std::make_unique<AddonEntry>();
+    entry->jobs.push_back({ std::move(job), Clock::now() });
+    entry->maxQueued = std::max(entry->maxQueued, static_cast<uint32_t>(entry->jobs.size()));
+    MakeReady(*entry);
+
+    // Stop() clears s_pool before stopping the pool, so this cannot fail
+    s_pool->Post(RunNext);
+    return true;
+}
+
+bool GetStats(const std::string& addonId, Stats& out) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = s_addons.find(addonId);
+    if (it == s_addons.end()) return false;
+
+    const AddonEntry& entry = *it->second;
+    out.jobs       = entry.queueUs.GetCount();
+    out.queueP50Us = entry.queueUs.Percentile(0.50);
+    out.queueP95Us = entry.queueUs.Percentile(0.95);
+    out.queueMaxUs = entry.queueUs.GetMax();
+    out.busyUs     = entry.busyUs;
+    out.running    = entry.running;
+    out.queued     = static_cast<uint32_t>(entry.jobs.size());
+    out.maxQueued  = entry.maxQueued;
+    return true;
+}
+
+} // namespace AssetIo
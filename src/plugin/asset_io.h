@@ -0,0 +1,41 @@
+#pragma once
+
+#include "worker_pool.h"
+
+#include <string>
+#include <cstdint>
+
+// Worker pool for addon file I/O (scheme handler loads and cold reads of
+// mapped files), so a slow disk read never blocks CEF's IO thread.
+//
+// Each addon has its own FIFO and at most MAX_RUNNING_PER_ADDON jobs running
+// at once; backlogged addons take turns, so one addon loading a large media
+// file delays only its own requests.
+namespace AssetIo {
+
+constexpr size_t   THREAD_COUNT = 3;
+constexpr uint32_t MAX_RUNNING_PER_ADDON = 2;
+
+// Start / stop the pool. Stop drops queued jobs and waits for running ones.
+void Start();
+void Stop();
+
+// Queue a job in the addon's FIFO. Returns false if the pool is not running
+// (the caller does the work inline). Any thread.
+bool Post(const std::string& addonId, WorkerPool::Job job);
+
+struct Stats {
+    uint64_t jobs = 0;
+    uint64_t queueP50Us = 0;   // time from Post to start
+    uint64_t queueP95Us = 0;
+    uint64_t queueMaxUs = 0;
+    uint64_t busyUs = 0;       // total time spent running the addon's jobs
+    uint32_t running = 0;
+    uint32_t queued = 0;
+    uint32_t maxQueued = 0;
+};
+
+// Copy of the addon's counters. Returns false if it has posted no job yet.
+bool GetStats(const std::string& addonId, Stats& out);
+
+} // namespace AssetIo
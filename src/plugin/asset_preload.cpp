@@ -0,0 +1,121 @@
+#include "asset_preload.h"
+#include "asset_cache.h"
+#include "asset_io.h"
+#include "file_walk.h"
+#include "globals.h"
+#include "shared/version.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace AssetPreload {
+
+bool MatchGlob(std::string_view pattern, std::string_view path) {
+    if (pattern.empty()) return path.empty();
+
+    if (pattern.compare(0, 2, "**") == 0) {
+        // "**/" may also match no directory at all
+        std::string_view rest = pattern.substr(2);
+        if (!rest.empty() && rest[0] == '/' && MatchGlob(rest.substr(1), path)) return true;
+        for (size_t i = 0; i <= path.size(); ++i) {
+            if (MatchGlob(rest, path.substr(i))) return true;
+        }
+        return false;
+    }
+    if (pattern[0] == '*') {
+        for (size_t i = 0; i <= path.size(); ++i) {
+            if (MatchGlob(pattern.substr(1), path.substr(i))) return true;
+            if (i < path.size() && path[i] == '/') break;
+        }
+        return false;
+    }
+    if (path.empty()) return false;
+    if (pattern[0] == '?' ? path[0] == '/' : pattern[0] != path[0]) return false;
+    return MatchGlob(pattern.substr(1), path.substr(1));
+}
+
+// Same key and validators as the addon's file index, so the scheme handler's
+// lookups hit what is read here.
+static std::unordered_map<std::string, FileWalk::Entry> ListFiles(const std::string& basePath) {
+    std::unordered_map<std::string, FileWalk::Entry> files;
+    FileWalk::ForEach(basePath, [&](FileWalk::Entry& entry) {
+        std::string key = entry.key;
+        files.emplace(std::move(key), std::move(entry));
+        return true;
+    });
+    return files;
+}
+
+static void Warm(const AddonManifest& manifest) {
+    auto start = std::chrono::steady_clock::now();
+    std::unordered_map<std::string, FileWalk::Entry> files = ListFiles(manifest.basePath);
+
+    // The entry page first, then the manifest's list in order
+    std::vector<std::string> patterns;
+    patterns.push_back(AssetCache::NormalizePath(manifest.entry));
+    patterns.insert(patterns.end(), manifest.preload.begin(), manifest.preload.end());
+
+    std::vector<std::string> selected;
+    std::unordered_set<std::string> seen;
+    auto select = [&](const std::string& key) {
+        if (!seen.insert(key).second) return;
+        selected.push_back(key);
+        for (const char* suffix : { ".br", ".gz" }) {
+            std::string sibling = key + suffix;
+            if (files.count(sibling) && seen.insert(sibling).second) selected.push_back(sibling);
+        }
+    };
+    for (const std::string& pattern : patterns) {
+        if (pattern.find_first_of("*?") == std::string::npos) {
+            if (files.count(pattern)) select(pattern);
+            continue;
+        }
+        std::vector<std::string> matches;
+        for (const auto& [key, file] : files) {
+            if (MatchGlob(pattern, key)) matches.push_back(key);
+        }
+        std::sort(matches.begin(), matches.end());
+        for (const std::string& key : matches) select(key);
+    }
+
+    // Past the cache's cap, later files would only evict earlier ones
+    size_t warmed = 0;
+    uint64_t bytes = 0;
+    bool capped = false;
+    for (const std::string& key : selected) {
+        const FileWalk::Entry& file = files.at(key);
+        if (file.size > AssetCache::MAX_ENTRY_BYTES) continue;
+        if (bytes + file.size > AssetCache::MAX_ADDON_BYTES) {
+            capped = true;
+            break;
+        }
+        if (AssetCache::Get(manifest.id, key, file.path, file.size, file.mtime, 0)) {
+            ++warmed;
+            bytes += file.size;
+        }
+    }
+
+    if (Globals::API) {
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        char msg[256];
+        snprintf(msg, sizeof(msg), "Addon '%s': preloaded %zu file(s) (%.1f KB) in %.1f ms%s.",
+            manifest.id.c_str(), warmed, bytes / 1024.0, ms,
+            capped ? ", stopped at the cache limit" : "");
+        Globals::API->Log(capped ? LOGL_WARNING : LOGL_INFO, ADDON_NAME, msg);
+    }
+}
+
+void Start(const std::vector<AddonManifest>& manifests) {
+    for (const AddonManifest& manifest : manifests) {
+        // A bundle is mapped at registration and served from the mapping
+        if (!manifest.bundlePath.empty()) continue;
+        AssetIo::Post(manifest.id, [manifest]() { Warm(manifest); });
+    }
+}
+
+} // namespace AssetPreload
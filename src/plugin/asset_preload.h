@@ -0,0 +1,22 @@
+#pragma once
+
+#include "addon_manager.h"
+
+#include <string_view>
+#include <vector>
+
+// Warms the asset cache while the loader waits for CEF: each addon's entry
+// page and the files its manifest lists under "preload" are read into
+// AssetCache on the asset I/O pool, so the first page load is served from
+// memory. Precompressed siblings (file.js.br / .gz) of a listed file are
+// warmed with it, since the scheme handler prefers them.
+namespace AssetPreload {
+
+// Queue one warm-up job per addon. AssetIo must be started.
+void Start(const std::vector<AddonManifest>& manifests);
+
+// Whether a normalized path matches a normalized pattern: '*' and '?' match
+// within one segment, "**" across segments (including none).
+bool MatchGlob(std::string_view pattern, std::string_view path);
+
+} // namespace AssetPreload
@@ -0,0 +1,285 @@
+#include "asset_resource_handler.h"
+#include "asset_io.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+AssetResourceHandler::AssetResourceHandler(const std::string& addonId, Body body)
+    : m_addonId(addonId), m_body(std::move(body)) {}
+
+AssetResourceHandler::AssetResourceHandler(const std::string& addonId, Loader loader)
+    : m_addonId(addonId), m_loader(std::move(loader)) {}
+
+CefRefPtr<AssetResourceHandler> AssetResourceHandler::NotFound(const std::string& addonId) {
+    CefRefPtr<AssetResourceHandler> handler = new AssetResourceHandler(addonId, Body());
+    handler->m_found = false;
+    return handler;
+}
+
+// Whether an If-None-Match header lists the ETag ("*" matches anything; the
+// comparison is weak, so W/"x" matches "x").
+static bool MatchesETag(const std::string& header, const std::string& etag) {
+    size_t start = 0;
+    while (start < header.size()) {
+        size_t end = header.find(',', start);
+        if (end == std::string::npos) end = header.size();
+
+        size_t first = header.find_first_not_of(" \t", start);
+        size_t last = header.find_last_not_of(" \t", end - 1);
+        if (first != std::string::npos && first < end) {
+            std::string tag = header.substr(first, last - first + 1);
+            if (tag == "*") return true;
+            if (tag.compare(0, 2, "W/") == 0) tag.erase(0, 2);
+            if (tag == etag) return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+enum class RangeResult { Whole, Partial, Unsatisfiable };
+
+// Parse a Range header against a body of `size` bytes. Only a single byte
+// range is supported; anything else is served whole.
+static RangeResult ParseRange(const std::string& header, size_t size,
+                              size_t& first, size_t& last) {
+    size_t pos = header.find_first_not_of(" \t");
+    if (pos == std::string::npos || header.compare(pos, 6, "bytes=") != 0) {
+        return RangeResult::Whole;
+    }
+    std::string spec = header.substr(pos + 6);
+    if (spec.find(',') != std::string::npos) return RangeResult::Whole;
+
+    size_t dash = spec.find('-');
+    if (dash == std::string::npos) return RangeResult::Whole;
+
+    auto parse = [](const std::string& text, bool& present, uint64_t& value) {
+        size_t begin = text.find_first_not_of(" \t");
+        size_t end = text.find_last_not_of(" \t");
+        present = begin != std::string::npos;
+        if (!present) return true;
+        std::string digits = text.substr(begin, end - begin + 1);
+        if (digits.size() > 19 || digits.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+        value = std::stoull(digits);
+        return true;
+    };
+
+    bool hasFirst, hasLast;
+    uint64_t from = 0, to = 0;
+    if (!parse(spec.substr(0, dash), hasFirst, from) ||
+        !parse(spec.substr(dash + 1), hasLast, to) ||
+        (!hasFirst && !hasLast) || (hasFirst && hasLast && to < from)) {
+        return RangeResult::Whole;
+    }
+
+    if (!hasFirst) {
+        // Suffix: the last `to` bytes
+        if (to == 0 || size == 0) return RangeResult::Unsatisfiable;
+        first = size - static_cast<size_t>(std::min<uint64_t>(to, size));
+        last = size - 1;
+    } else {
+        if (from >= size) return RangeResult::Unsatisfiable;
+        first = static_cast<size_t>(from);
+        last = hasLast ? static_cast<size_t>(std::min<uint64_t>(to, size - 1)) : size - 1;
+    }
+    return RangeResult::Partial;
+}
+
+bool AssetResourceHandler::Open(CefRefPtr<CefRequest> request, bool& handleRequest,
+                                CefRefPtr<CefCallback> callback) {
+    Conditions conditions;
+    if (request) {
+        conditions.ifNoneMatch = request->GetHeaderByName("If-None-Match").ToString();
+        conditions.range = request->GetHeaderByName("Range").ToString();
+        conditions.ifRange = request->GetHeaderByName("If-Range").ToString();
+    }
+
+    if (!m_loader) {
+        // Everything is in memory: answer immediately
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Prepare(m_found, conditions);
+        handleRequest = true;
+        return true;
+    }
+
+    CefRefPtr<AssetResourceHandler> self(this);
+    // `async`: on the pool, so CEF waits for the callback; inline, Open's
+    // return value answers instead
+    auto load = [self, conditions, callback](bool async) {
+        // The loader is only touched here; run it without the lock so
+        // Cancel() never waits for the disk
+        Body body;
+        bool found = self->m_loader(body);
+        std::shared_ptr<const char> data;
+        size_t from = 0, end = 0;
+        {
+            std::lock_guard<std::mutex> lock(self->m_mutex);
+            self->m_loader = nullptr;
+            if (self->m_cancelled) return;
+            self->m_body = std::move(body);
+            self->Prepare(found, conditions);
+            if (self->m_body.mapped) {
+                data = self->m_body.data;
+                from = self->m_offset;
+                end = self->m_end;
+            }
+        }
+        if (data) self->Prefetch(data.get(), from, end);
+        if (async && callback) callback->Continue();
+    };
+
+    if (AssetIo::Post(m_addonId, [load]() { load(true); })) {
+        handleRequest = false;  // continued from the pool
+    } else {
+        load(false);  // pool not running: inline
+        handleRequest = true;
+    }
+    return true;
+}
+
+void AssetResourceHandler::Prepare(bool found, const Conditions& conditions) {
+    if (!found) {
+        m_status = 404;
+        m_body = Body();
+        m_body.mimeType = "text/plain";
+        m_end = 0;
+        return;
+    }
+
+    m_end = m_body.size;
+    CefResponse::HeaderMap& headers = m_body.headers;
+    if (!m_body.etag.empty()) headers.insert(std::make_pair("ETag", m_body.etag));
+    headers.insert(std::make_pair("Accept-Ranges", "bytes"));
+
+    // Revalidation of a copy the browser already has: no body
+    if (!m_body.etag.empty() && MatchesETag(conditions.ifNoneMatch, m_body.etag)) {
+        m_status = 304;
+        m_body.data.reset();
+        m_end = 0;
+        return;
+    }
+
+    if (conditions.range.empty()) return;
+
+    // If-Range: the range only applies to the representation the browser
+    // has part of; a weak validator never matches
+    const std::string& etag = m_body.etag;
+    if (!conditions.ifRange.empty() &&
+        (etag.empty() || etag.compare(0, 2, "W/") == 0 || conditions.ifRange != etag)) {
+        return;
+    }
+
+    size_t first = 0, last = 0;
+    char contentRange[64];
+    switch (ParseRange(conditions.range, m_body.size, first, last)) {
+    case RangeResult::Whole:
+        break;
+    case RangeResult::Partial:
+        m_status = 206;
+        m_offset = m_rangeFirst = first;
+        m_end = last + 1;
+        snprintf(contentRange, sizeof(contentRange), "bytes %zu-%zu/%zu", first, last,
+            m_body.size);
+        headers.insert(std::make_pair("Content-Range", contentRange));
+        break;
+    case RangeResult::Unsatisfiable:
+        m_status = 416;
+        m_body.data.reset();
+        m_end = 0;
+        snprintf(contentRange, sizeof(contentRange), "bytes */%zu", m_body.size);
+        headers.insert(std::make_pair("Content-Range", contentRange));
+        break;
+    }
+}
+
+void AssetResourceHandler::Prefetch(const char* data, size_t from, size_t end) {
+    static constexpr size_t PAGE_SIZE = 4096;
+    size_t to = std::min(end, from + READ_AHEAD);
+
+    volatile char sink = 0;
+    for (size_t offset = from; offset < to; offset += PAGE_SIZE) sink = data[offset];
+    (void)sink;
+
+    size_t prefetched = m_prefetched.load(std::memory_order_relaxed);
+    while (to > prefetched &&
+           !m_prefetched.compare_exchange_weak(prefetched, to, std::memory_order_relaxed)) {}
+}
+
+void AssetResourceHandler::GetResponseHeaders(CefRefPtr<CefResponse> response,
+                                              int64& responseLength,
+                                              CefString& /*redirectUrl*/) {
+    const char* statusText = "OK";
+    switch (m_status) {
+    case 206: statusText = "Partial Content"; break;
+    case 304: statusText = "Not Modified"; break;
+    case 404: statusText = "Not Found"; break;
+    case 416: statusText = "Range Not Satisfiable"; break;
+    }
+    response->SetStatus(m_status);
+    response->SetStatusText(statusText);
+    response->SetMimeType(m_body.mimeType);
+    if (!m_body.headers.empty()) response->SetHeaderMap(m_body.headers);
+    responseLength = static_cast<int64>(m_end - m_offset);
+}
+
+bool AssetResourceHandler::Skip(int64 bytesToSkip, int64& bytesSkipped,
+                                CefRefPtr<CefResourceSkipCallback> /*callback*/) {
+    // CEF's loader applies a Range itself by skipping to its first byte
+    // before reading. Open already positioned the response there.
+    if (m_status == 206 && m_offset == m_rangeFirst &&
+        bytesToSkip == static_cast<int64>(m_rangeFirst)) {
+        m_rangeFirst = 0;
+        bytesSkipped = bytesToSkip;
+        return true;
+    }
+
+    size_t skip = std::min(static_cast<size_t>(std::max<int64>(bytesToSkip, 0)), m_end - m_offset);
+    m_offset += skip;
+    bytesSkipped = static_cast<int64>(skip);
+    return skip > 0;
+}
+
+bool AssetResourceHandler::Read(void* dataOut, int bytesToRead, int& bytesRead,
+                                CefRefPtr<CefResourceReadCallback> callback) {
+    size_t count = std::min(static_cast<size_t>(std::max(bytesToRead, 0)), m_end - m_offset);
+    if (count == 0) {
+        bytesRead = 0;  // end of response
+        return false;
+    }
+
+    // Mapped pages not touched yet may have to come from disk: copy them on
+    // the pool, which also reads ahead
+    size_t offset = m_offset;
+    if (m_body.mapped && callback &&
+        offset + count > m_prefetched.load(std::memory_order_relaxed)) {
+        CefRefPtr<AssetResourceHandler> self(this);
+        std::shared_ptr<const char> data = m_body.data;
+        size_t end = m_end;
+        bool posted = AssetIo::Post(m_addonId,
+            [self, data, dataOut, offset, count, end, callback]() {
+                std::memcpy(dataOut, data.get() + offset, count);
+                self->Prefetch(data.get(), offset + count, end);
+                callback->Continue(static_cast<int>(count));
+            });
+        if (posted) {
+            m_offset += count;
+            bytesRead = 0;  // continued from the pool
+            return true;
+        }
+    }
+
+    std::memcpy(dataOut, m_body.data.get() + offset, count);
+    m_offset += count;
+    bytesRead = static_cast<int>(count);
+    return true;
+}
+
+void AssetResourceHandler::Cancel() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cancelled = true;
+    m_body.data.reset();
+    m_offset = m_end = 0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "include/cef_resource_handler.h"
+#include "include/cef_response.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cstddef>
+
+// Serves a response body that is already resident in memory (a cached file,
+// a staged blob) or mapped (a large file, a bundle entry). The bytes are
+// shared with their owner, not copied into a stream, and stay alive until CEF
+// releases the handler.
+//
+// A handler built from a Loader resolves its body on the asset I/O pool
+// (asset_io.h) and continues CEF from there, so file reads never block CEF's
+// IO thread. Reads of mapped bodies beyond the pages already touched are
+// also done on the pool, each prefetching the next READ_AHEAD bytes.
+//
+// With an ETag, the response carries it and a request whose If-None-Match
+// lists it is answered 304 without a body. A single-range Range request
+// (bytes=first-last, first-, -suffix) is answered 206 with Content-Range, or
+// 416 if it lies past the end; If-Range is honored for strong ETags.
+class AssetResourceHandler : public CefResourceHandler {
+public:
+    static constexpr size_t READ_AHEAD = 1024 * 1024;
+
+    struct Body {
+        std::shared_ptr<const char> data;
+        size_t                      size = 0;
+        std::string                 mimeType;
+        CefResponse::HeaderMap      headers;
+        std::string                 etag;
+        bool                        mapped = false;  // pages may still be on disk
+    };
+
+    // Fills in the body (I/O pool). Returns false if there is none (404).
+    using Loader = std::function<bool(Body& body)>;
+
+    AssetResourceHandler(const std::string& addonId, Body body);
+    AssetResourceHandler(const std::string& addonId, Loader loader);
+
+    // 404, answered without touching the disk or the pool
+    static CefRefPtr<AssetResourceHandler> NotFound(const std::string& addonId);
+
+    // CefResourceHandler (CEF IO thread)
+    bool Open(CefRefPtr<CefRequest> request, bool& handleRequest,
+              CefRefPtr<CefCallback> callback) override;
+    void GetResponseHeaders(CefRefPtr<CefResponse> response, int64& responseLength,
+                            CefString& redirectUrl) override;
+    bool Skip(int64 bytesToSkip, int64& bytesSkipped,
+              CefRefPtr<CefResourceSkipCallback> callback) override;
+    bool Read(void* dataOut, int bytesToRead, int& bytesRead,
+              CefRefPtr<CefResourceReadCallback> callback) override;
+    void Cancel() override;
+
+private:
+    // Conditional and range headers of the request
+    struct Conditions {
+        std::string ifNoneMatch;
+        std::string range;
+        std::string ifRange;
+    };
+
+    // Install the loaded body and apply the request's conditions (m_mutex)
+    void Prepare(bool found, const Conditions& conditions);
+
+    // Touch the pages of [from, min(from + READ_AHEAD, end)) (I/O pool)
+    void Prefetch(const char* data, size_t from, size_t end);
+
+    std::string                 m_addonId;
+    Loader                      m_loader;
+    Body                        m_body;
+    size_t                      m_offset = 0;      // next byte to read
+    size_t                      m_end = 0;         // one past the last byte to send
+    size_t                      m_rangeFirst = 0;
+    std::atomic<size_t>         m_prefetched{0};   // mapped: pages touched up to here
+    int                         m_status = 200;
+    bool                        m_found = true;    // bodies without a loader
+    std::mutex                  m_mutex;           // the load job vs. Cancel
+    bool                        m_cancelled = false;
+
+    IMPLEMENT_REFCOUNTING(AssetResourceHandler);
+    DISALLOW_COPY_AND_ASSIGN(AssetResourceHandler);
+};
@@ -0,0 +1,272 @@
+#include "bridge_api.h"
+
+#include <climits>
+#include <cmath>
+#include <string>
+
+using json = nlohmann::json;
+
+namespace BridgeApi {
+
+// ---- Perfect hash: action name -> Action ----
+// FNV-1a with a seed, finalized with a multiply-xorshift. The seed is searched
+// at compile time so that every action lands in its own slot of the table.
+
+static constexpr size_t HASH_TABLE_SIZE = 256;
+static_assert(ACTION_COUNT < HASH_TABLE_SIZE / 4, "Grow HASH_TABLE_SIZE with the action list");
+
+static constexpr uint32_t HashName(std::string_view name, uint32_t seed) {
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c : name) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+static constexpr bool IsPerfectSeed(uint32_t seed) {
+    bool used[HASH_TABLE_SIZE] = {};
+    for (auto name : ACTION_NAMES) {
+        size_t slot = HashName(name, seed) & (HASH_TABLE_SIZE - 1);
+        if (used[slot]) return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+static constexpr uint32_t FindPerfectSeed() {
+    for (uint32_t seed = 0; seed < 4096; ++seed) {
+        if (IsPerfectSeed(seed)) return seed;
+    }
+    return UINT32_MAX;
+}
+
+static constexpr uint32_t HASH_SEED = FindPerfectSeed();
+static_assert(HASH_SEED != UINT32_MAX, "No collision-free seed for the bridge action table");
+
+static constexpr std::array<uint8_t, HASH_TABLE_SIZE> BuildHashTable() {
+    std::array<uint8_t, HASH_TABLE_SIZE> table = {};
+    for (auto& slot : table) slot = static_cast<uint8_t>(Action::Unknown);
+    for (size_t i = 0; i < ACTION_COUNT; ++i) {
+        table[HashName(ACTION_NAMES[i], HASH_SEED) & (HASH_TABLE_SIZE - 1)] = static_cast<uint8_t>(i);
+    }
+    return table;
+}
+
+static constexpr std::array<uint8_t, HASH_TABLE_SIZE> s_hashTable = BuildHashTable();
+
+Action Lookup(std::string_view name) {
+    uint8_t index = s_hashTable[HashName(name, HASH_SEED) & (HASH_TABLE_SIZE - 1)];
+    if (index == static_cast<uint8_t>(Action::Unknown)) return Action::Unknown;
+    if (ACTION_NAMES[index] != name) return Action::Unknown;
+    return static_cast<Action>(index);
+}
+
+// ---- Parameter decoding ----
+
+// Integer parameters take any finite number, truncated toward zero as the
+// baseline's value<int>() did (a computed width of 400.5 is 400). Values
+// that no int can hold (1e20, past INT_MAX) fail the whole decode rather
+// than wrapping.
+enum class Assigned { Skipped, Set, Invalid };
+
+static Assigned ToAssigned(bool set) {
+    return set ? Assigned::Set : Assigned::Skipped;
+}
+
+static bool TruncateToInt(double value, int& out) {
+    if (!std::isfinite(value)) return false;
+    double truncated = std::trunc(value);
+    if (truncated < static_cast<double>(INT_MIN) || truncated > static_cast<double>(INT_MAX)) {
+        return false;
+    }
+    out = static_cast<int>(truncated);
+    return true;
+}
+
+bool ToInt(const json& value, int& out) {
+    if (value.is_number_unsigned()) {
+        uint64_t v = value.get<uint64_t>();
+        if (v > static_cast<uint64_t>(INT_MAX)) return false;
+        out = static_cast<int>(v);
+        return true;
+    }
+    if (value.is_number_float()) return TruncateToInt(value.get<double>(), out);
+    if (!value.is_number_integer()) return false;
+    int64_t v = value.get<int64_t>();
+    if (v < INT_MIN || v > INT_MAX) return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+static Assigned Assign(int& out, const json& value) {
+    if (!value.is_number()) return Assigned::Skipped;
+    return ToInt(value, out) ? Assigned::Set : Assigned::Invalid;
+}
+
+static Assigned Assign(bool& out, const json& value) {
+    if (value.is_boolean()) out = value.get<bool>();
+    return ToAssigned(value.is_boolean());
+}
+
+static Assigned Assign(const char*& out, const json& value) {
+    if (value.is_string()) out = value.get_ref<const std::string&>().c_str();
+    return ToAssigned(value.is_string());
+}
+
+static Assigned Assign(const json*& out, const json& value) {
+    out = &value;
+    return Assigned::Set;
+}
+
+using BridgeScanner::Member;
+using BridgeScanner::ValueKind;
+
+bool ToInt(const Member& value, int& out) {
+    if (value.kind != ValueKind::Number) return false;
+    if (!value.integral) return TruncateToInt(value.number, out);
+    if (value.integer < INT_MIN || value.integer > INT_MAX) return false;
+    out = static_cast<int>(value.integer);
+    return true;
+}
+
+static Assigned Assign(int& out, const Member& value) {
+    if (value.kind != ValueKind::Number) return Assigned::Skipped;
+    return ToInt(value, out) ? Assigned::Set : Assigned::Invalid;
+}
+
+static Assigned Assign(bool& out, const Member& value) {
+    if (value.kind == ValueKind::Bool) out = value.boolean;
+    return ToAssigned(value.kind == ValueKind::Bool);
+}
+
+static Assigned Assign(const char*& out, const Member& value) {
+    if (value.kind == ValueKind::String) out = value.str;
+    return ToAssigned(value.kind == ValueKind::String);
+}
+
+static Assigned Assign(const json*&, const Member&) {
+    return Assigned::Skipped; // Json params never take the flat path
+}
+
+// Match one message member against an action's parameters. Returns false if
+// the member's value is invalid for its parameter.
+#define NEXUS_BRIDGE_DECODE_FIELD(type, name, def)                          \
+    if (key == #name) {                                                     \
+        Assigned assigned = Assign(out.name, value);                        \
+        if (assigned == Assigned::Set) out.present |= 1u << out.name##_idx; \
+        return assigned != Assigned::Invalid;                               \
+    }
+
+#define NEXUS_BRIDGE_DECODER(Id, wire, thread, cls)                         \
+    template <class Value>                                                  \
+    static bool DecodeMember(std::string_view key, const Value& value,      \
+                             Id##Params& out) {                             \
+        (void)key; (void)value; (void)out;                                  \
+        NEXUS_BRIDGE_PARAMS_##Id(NEXUS_BRIDGE_DECODE_FIELD)                 \
+        return true;                                                        \
+    }                                                                       \
+    bool Decode(const json& msg, Id##Params& out) {                         \
+        if constexpr (Id##Params::FIELD_COUNT == 0) return true;            \
+        if (!msg.is_object()) return true;                                  \
+        for (auto it = msg.begin(); it != msg.end(); ++it) {                \
+            if (!DecodeMember(it.key(), *it, out)) return false;            \
+        }                                                                   \
+        return true;                                                        \
+    }                                                                       \
+    bool Decode(const BridgeScanner::FlatMessage& msg, Id##Params& out) {   \
+        if constexpr (Id##Params::FIELD_COUNT == 0) return true;            \
+        for (size_t i = 0; i < msg.count; ++i) {                            \
+            if (!DecodeMember(msg.members[i].key, msg.members[i], out)) {   \
+                return false;                                               \
+            }                                                               \
+        }                                                                   \
+        return true;                                                        \
+    }
+
+NEXUS_BRIDGE_ACTIONS(NEXUS_BRIDGE_DECODER)
+
+#undef NEXUS_BRIDGE_DECODER
+#undef NEXUS_BRIDGE_DECODE_FIELD
+
+// ---- JS stubs ----
+
+// Every positional arg of a JS stub must be a declared parameter of its
+// action (spread args, "*name", are exempt).
+template <size_t N>
+static constexpr bool StubArgsDeclared(std::string_view args,
+                                       const std::array<std::string_view, N>& fields) {
+    while (!args.empty()) {
+        size_t comma = args.find(',');
+        std::string_view arg = args.substr(0, comma);
+        args = (comma == std::string_view::npos) ? std::string_view() : args.substr(comma + 1);
+        if (!arg.empty() && arg[0] == '*') continue;
+
+        bool found = false;
+        for (auto field : fields) {
+            if (field == arg) found = true;
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+#define NEXUS_BRIDGE_CHECK_STUB(Id, ns, method, kind, args, fixed)           \
+    static_assert(StubArgsDeclared(args, Id##Params::FIELD_NAMES),           \
+                  "JS stub " ns "." method " passes an undeclared parameter");
+NEXUS_BRIDGE_JS_STUBS(NEXUS_BRIDGE_CHECK_STUB)
+#undef NEXUS_BRIDGE_CHECK_STUB
+
+enum StubKind { Send = 0, Async = 1 };
+
+static std::string BuildJsStubs() {
+    std::string js;
+    js.reserve(4096);
+
+    // Known action names, used by _send() to flag hand-written calls that
+    // drifted from the description.
+    js += "var _ACTIONS = {";
+    for (size_t i = 0; i < ACTION_COUNT; ++i) {
+        if (i) js += ",";
+        js += "'";
+        js += ACTION_NAMES[i];
+        js += "':1";
+    }
+    js += "};\n";
+
+    // [namespace, method, action, async, [args], fixed]
+    js += "var _STUBS = [\n";
+#define NEXUS_BRIDGE_EMIT_STUB(Id, ns, method, kind, args, fixed)              \
+    {                                                                          \
+        std::string argList;                                                   \
+        std::string_view rest = args;                                          \
+        while (!rest.empty()) {                                                \
+            size_t comma = rest.find(',');                                     \
+            if (!argList.empty()) argList += ",";                              \
+            argList += "'";                                                    \
+            argList += rest.substr(0, comma);                                  \
+            argList += "'";                                                    \
+            rest = (comma == std::string_view::npos) ? std::string_view()      \
+                                                     : rest.substr(comma + 1); \
+        }                                                                      \
+        js += "  ['" ns "','" method "','";                                    \
+        js += ACTION_NAMES[static_cast<size_t>(Action::Id)];                   \
+        js += "',";                                                            \
+        js += (kind == Async) ? "1" : "0";                                     \
+        js += ",[" + argList + "]," fixed "],\n";                              \
+    }
+    NEXUS_BRIDGE_JS_STUBS(NEXUS_BRIDGE_EMIT_STUB)
+#undef NEXUS_BRIDGE_EMIT_STUB
+    js += "];\n";
+    return js;
+}
+
+const std::string& GetJsStubs() {
+    static const std::string s_stubs = BuildJsStubs();
+    return s_stubs;
+}
+
+} // namespace BridgeApi
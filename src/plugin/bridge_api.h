@@ -0,0 +1,290 @@
+#pragma once
+
+#include "bridge_scanner.h"
+
+#include "nlohmann/json.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// Single description of the JS<->native bridge API.
+//
+// Everything the bridge exposes is declared once here as X-macro lists:
+//   - NEXUS_BRIDGE_ACTIONS: every wire action, its handler ID, thread and
+//     rate-limit class
+//   - NEXUS_BRIDGE_PARAMS_<Id>: the typed parameters of each action
+//   - NEXUS_BRIDGE_JS_STUBS: the window.nexus.* methods generated from them
+//
+// From these lists bridge_api.cpp builds a constexpr perfect hash from action
+// name to handler ID, one-pass decoders into typed parameter structs, and the
+// JS stub table injected into the bridge script. IpcHandler must provide a
+// Handle<Id> function for every action, so the dispatcher, the native
+// handlers and the JS surface cannot drift apart.
+
+// ---- Actions: A(Id, "wire_name", Thread, Class) ----
+// Thread: where the handler runs. Bridge messages are parsed on the bridge
+// worker; Worker handlers run there too and must not touch CEF, ImGui, addon
+// state or non-thread-safe Nexus APIs (their async responses are posted to
+// the render thread). Render handlers run in the next per-frame batch; so
+// does any handler whose addon still has one waiting there, to keep the
+// addon's messages in order (bridge_scheduler.h).
+// Class: the rate-limit bucket the action draws from (see bridge_scheduler.h).
+#define NEXUS_BRIDGE_ACTIONS(A) \
+    A(Log,                        "log",                         Worker, Log)     \
+    A(Alert,                      "alert",                       Render, Control) \
+    A(EventsSubscribe,            "events_subscribe",            Render, Control) \
+    A(EventsUnsubscribe,          "events_unsubscribe",          Render, Control) \
+    A(EventsRaise,                "events_raise",                Worker, Event)   \
+    A(EventsGetStats,             "events_getStats",             Render, Query)   \
+    A(EventsAggregate,            "events_aggregate",            Render, Control) \
+    A(EventsStopAggregate,        "events_stopAggregate",        Render, Control) \
+    A(KeybindsRegister,           "keybinds_register",           Render, Control) \
+    A(KeybindsDeregister,         "keybinds_deregister",         Render, Control) \
+    A(GameBindsPress,             "gamebinds_press",             Worker, Input)   \
+    A(GameBindsRelease,           "gamebinds_release",           Worker, Input)   \
+    A(GameBindsInvoke,            "gamebinds_invoke",            Worker, Input)   \
+    A(GameBindsIsBound,           "gamebinds_isBound",           Worker, Query)   \
+    A(PathsGetGameDirectory,      "paths_getGameDirectory",      Worker, Query)   \
+    A(PathsGetAddonDirectory,     "paths_getAddonDirectory",     Worker, Query)   \
+    A(PathsGetCommonDirectory,    "paths_getCommonDirectory",    Worker, Query)   \
+    A(DataLinkGetMumbleLink,      "datalink_getMumbleLink",      Render, Query)   \
+    A(DataLinkGetNexusLink,       "datalink_getNexusLink",       Render, Query)   \
+    A(GameStateSubscribe,         "gamestate_subscribe",         Render, Control) \
+    A(GameStateUnsubscribe,       "gamestate_unsubscribe",       Render, Control) \
+    A(QuickAccessAdd,             "quickaccess_add",             Render, Control) \
+    A(QuickAccessRemove,          "quickaccess_remove",          Render, Control) \
+    A(QuickAccessNotify,          "quickaccess_notify",          Render, Control) \
+    A(LocalizationTranslate,      "localization_translate",      Worker, Query)   \
+    A(LocalizationSet,            "localization_set",            Render, Control) \
+    A(WindowsCreate,              "windows_create",              Render, Control) \
+    A(WindowsClose,               "windows_close",               Render, Control) \
+    A(WindowsUpdate,              "windows_update",              Render, Control) \
+    A(WindowsSetInputPassthrough, "windows_setInputPassthrough", Render, Control) \
+    A(WindowsList,                "windows_list",                Render, Query)   \
+    A(BridgeNegotiate,            "bridge_negotiate",            Render, Control) \
+    A(PerfLatency,                "perf_latency",                Worker, Log)     \
+    A(PerfGetIpcStats,            "perf_getIpcStats",            Worker, Query)
+
+// ---- Parameters: F(Type, name, default) ----
+// Types: Int (int), Bool (bool), Str (const char*, never null), Json (raw
+// node, null if absent). Str/Json point into the parsed message and are only
+// valid for the duration of the handler call. A value of the wrong JSON type
+// leaves the default in place; an Int given a fraction is truncated.
+#define NEXUS_BRIDGE_PARAMS_Log(F)                  F(Int, level, 3) F(Str, channel, "") F(Str, message, "")
+#define NEXUS_BRIDGE_PARAMS_Alert(F)                F(Str, message, "")
+#define NEXUS_BRIDGE_PARAMS_EventsSubscribe(F)      F(Str, name, "") F(Str, policy, "all") F(Int, max, 0) \
+                                                    F(Str, key, "") F(Int, hz, 0)
+#define NEXUS_BRIDGE_PARAMS_EventsUnsubscribe(F)    F(Str, name, "")
+#define NEXUS_BRIDGE_PARAMS_EventsRaise(F)          F(Str, name, "")
+#define NEXUS_BRIDGE_PARAMS_EventsGetStats(F)
+#define NEXUS_BRIDGE_PARAMS_EventsAggregate(F)      F(Str, id, "") F(Str, name, "") F(Str, op, "count") \
+                                                    F(Str, field, "") F(Int, windowMs, 1000) F(Int, emitHz, 4)
+#define NEXUS_BRIDGE_PARAMS_EventsStopAggregate(F)  F(Str, id, "")
+#define NEXUS_BRIDGE_PARAMS_KeybindsRegister(F)     F(Str, id, "") F(Str, defaultBind, "")
+#define NEXUS_BRIDGE_PARAMS_KeybindsDeregister(F)   F(Str, id, "")
+#define NEXUS_BRIDGE_PARAMS_GameBindsPress(F)       F(Int, bind, 0)
+#define NEXUS_BRIDGE_PARAMS_GameBindsRelease(F)     F(Int, bind, 0)
+#define NEXUS_BRIDGE_PARAMS_GameBindsInvoke(F)      F(Int, bind, 0) F(Int, durationMs, 0)
+#define NEXUS_BRIDGE_PARAMS_GameBindsIsBound(F)     F(Int, bind, 0)
+#define NEXUS_BRIDGE_PARAMS_PathsGetGameDirectory(F)
+#define NEXUS_BRIDGE_PARAMS_PathsGetAddonDirectory(F) F(Str, name, "")
+#define NEXUS_BRIDGE_PARAMS_PathsGetCommonDirectory(F)
+#define NEXUS_BRIDGE_PARAMS_DataLinkGetMumbleLink(F)
+#define NEXUS_BRIDGE_PARAMS_DataLinkGetNexusLink(F)
+#define NEXUS_BRIDGE_PARAMS_GameStateSubscribe(F)   F(Int, hz, 0)
+#define NEXUS_BRIDGE_PARAMS_GameStateUnsubscribe(F)
+#define NEXUS_BRIDGE_PARAMS_QuickAccessAdd(F)       F(Str, id, "") F(Str, texture, "") F(Str, textureHover, "") \
+                                                    F(Str, keybind, "") F(Str, tooltip, "")
+#define NEXUS_BRIDGE_PARAMS_QuickAccessRemove(F)    F(Str, id, "")
+#define NEXUS_BRIDGE_PARAMS_QuickAccessNotify(F)    F(Str, id, "")
+#define NEXUS_BRIDGE_PARAMS_LocalizationTranslate(F) F(Str, id, "")
+#define NEXUS_BRIDGE_PARAMS_LocalizationSet(F)      F(Str, id, "") F(Str, lang, "") F(Str, text, "")
+#define NEXUS_BRIDGE_PARAMS_WindowsCreate(F)        F(Str, windowId, "") F(Str, url, "") F(Int, width, 800) \
+                                                    F(Int, height, 600) F(Str, title, "")
+#define NEXUS_BRIDGE_PARAMS_WindowsClose(F)         F(Str, windowId, "")
+#define NEXUS_BRIDGE_PARAMS_WindowsUpdate(F)        F(Str, windowId, "") F(Str, title, "") F(Int, width, 0) \
+                                                    F(Int, height, 0) F(Bool, visible, true)
+#define NEXUS_BRIDGE_PARAMS_WindowsSetInputPassthrough(F) F(Str, windowId, "") F(Int, alphaThreshold, 0) \
+                                                    F(Bool, enabled, false)
+#define NEXUS_BRIDGE_PARAMS_WindowsList(F)
+#define NEXUS_BRIDGE_PARAMS_BridgeNegotiate(F)      F(Json, encodings, nullptr)
+#define NEXUS_BRIDGE_PARAMS_PerfLatency(F)          F(Json, samples, nullptr)
+#define NEXUS_BRIDGE_PARAMS_PerfGetIpcStats(F)      F(Bool, all, false)
+
+// ---- Generated JS methods: S(Id, "namespace", "method", Kind, "args", "fixed") ----
+// Kind: Send (fire-and-forget) or Async (returns a Promise). Args map
+// positionally onto declared parameters; "*name" spreads an options object.
+// `fixed` is a JS object literal merged into every message. An empty
+// namespace attaches the method to window.nexus itself. Methods that keep
+// JS-side state (callbacks) are written by hand in nexus_bridge.cpp.
+#define NEXUS_BRIDGE_JS_STUBS(S) \
+    S(Log,                     "log",          "info",               Send,  "channel,message", "{level:3}") \
+    S(Log,                     "log",          "warning",            Send,  "channel,message", "{level:2}") \
+    S(Log,                     "log",          "critical",           Send,  "channel,message", "{level:1}") \
+    S(Log,                     "log",          "debug",              Send,  "channel,message", "{level:4}") \
+    S(Log,                     "log",          "trace",              Send,  "channel,message", "{level:5}") \
+    S(Alert,                   "",             "alert",              Send,  "message", "{}") \
+    S(EventsRaise,             "events",       "raise",              Send,  "name", "{}") \
+    S(EventsGetStats,          "events",       "getStats",           Async, "", "{}") \
+    S(GameBindsPress,          "gamebinds",    "press",              Send,  "bind", "{}") \
+    S(GameBindsRelease,        "gamebinds",    "release",            Send,  "bind", "{}") \
+    S(GameBindsInvoke,         "gamebinds",    "invoke",             Send,  "bind,durationMs", "{}") \
+    S(GameBindsIsBound,        "gamebinds",    "isBound",            Async, "bind", "{}") \
+    S(DataLinkGetMumbleLink,   "datalink",     "getMumbleLink",      Async, "", "{}") \
+    S(DataLinkGetNexusLink,    "datalink",     "getNexusLink",       Async, "", "{}") \
+    S(GameStateSubscribe,      "gamestate",    "subscribe",          Send,  "*options", "{}") \
+    S(GameStateUnsubscribe,    "gamestate",    "unsubscribe",        Send,  "", "{}") \
+    S(PathsGetGameDirectory,   "paths",        "getGameDirectory",   Async, "", "{}") \
+    S(PathsGetAddonDirectory,  "paths",        "getAddonDirectory",  Async, "name", "{}") \
+    S(PathsGetCommonDirectory, "paths",        "getCommonDirectory", Async, "", "{}") \
+    S(QuickAccessAdd,          "quickaccess",  "add",                Send,  "id,texture,textureHover,keybind,tooltip", "{}") \
+    S(QuickAccessRemove,       "quickaccess",  "remove",             Send,  "id", "{}") \
+    S(QuickAccessNotify,       "quickaccess",  "notify",             Send,  "id", "{}") \
+    S(LocalizationTranslate,   "localization", "translate",          Async, "id", "{}") \
+    S(LocalizationSet,         "localization", "set",                Send,  "id,lang,text", "{}") \
+    S(WindowsCreate,           "windows",      "create",             Async, "windowId,*options", "{}") \
+    S(WindowsClose,            "windows",      "close",              Send,  "windowId", "{}") \
+    S(WindowsUpdate,           "windows",      "update",             Send,  "windowId,*options", "{}") \
+    S(WindowsList,             "windows",      "list",               Async, "", "{}") \
+    S(BridgeNegotiate,         "bridge",       "negotiate",          Async, "encodings", "{}") \
+    S(PerfGetIpcStats,         "perf",         "getIpcStats",        Async, "*options", "{}")
+
+namespace BridgeApi {
+
+// Handler IDs, one per action.
+enum class Action : uint8_t {
+#define NEXUS_BRIDGE_ACTION_ENUM(Id, wire, thread, cls) Id,
+    NEXUS_BRIDGE_ACTIONS(NEXUS_BRIDGE_ACTION_ENUM)
+#undef NEXUS_BRIDGE_ACTION_ENUM
+    Count,
+    Unknown = 0xFF
+};
+
+constexpr size_t ACTION_COUNT = static_cast<size_t>(Action::Count);
+
+// Wire names indexed by Action.
+inline constexpr std::array<std::string_view, ACTION_COUNT> ACTION_NAMES = {
+#define NEXUS_BRIDGE_ACTION_NAME(Id, wire, thread, cls) wire,
+    NEXUS_BRIDGE_ACTIONS(NEXUS_BRIDGE_ACTION_NAME)
+#undef NEXUS_BRIDGE_ACTION_NAME
+};
+
+// Actions whose parameters are all scalars (no Json) can be decoded straight
+// from a BridgeScanner::FlatMessage without building a DOM.
+#define NEXUS_BRIDGE_IS_JSON_Int  false
+#define NEXUS_BRIDGE_IS_JSON_Bool false
+#define NEXUS_BRIDGE_IS_JSON_Str  false
+#define NEXUS_BRIDGE_IS_JSON_Json true
+#define NEXUS_BRIDGE_FIELD_IS_JSON(type, name, def) || NEXUS_BRIDGE_IS_JSON_##type
+#define NEXUS_BRIDGE_ACTION_FLAT(Id, wire, thread, cls) !(false NEXUS_BRIDGE_PARAMS_##Id(NEXUS_BRIDGE_FIELD_IS_JSON)),
+
+inline constexpr std::array<bool, ACTION_COUNT> ACTION_FLAT = {
+    NEXUS_BRIDGE_ACTIONS(NEXUS_BRIDGE_ACTION_FLAT)
+};
+
+#undef NEXUS_BRIDGE_ACTION_FLAT
+#undef NEXUS_BRIDGE_FIELD_IS_JSON
+
+inline bool IsFlatDecodable(Action action) {
+    return static_cast<size_t>(action) < ACTION_COUNT && ACTION_FLAT[static_cast<size_t>(action)];
+}
+
+// Thread each action's handler runs on (see NEXUS_BRIDGE_ACTIONS).
+enum class Thread : uint8_t { Worker, Render };
+
+inline constexpr std::array<Thread, ACTION_COUNT> ACTION_THREAD = {
+#define NEXUS_BRIDGE_ACTION_THREAD(Id, wire, thread, cls) Thread::thread,
+    NEXUS_BRIDGE_ACTIONS(NEXUS_BRIDGE_ACTION_THREAD)
+#undef NEXUS_BRIDGE_ACTION_THREAD
+};
+
+inline Thread GetThread(Action action) {
+    return static_cast<size_t>(action) < ACTION_COUNT ? ACTION_THREAD[static_cast<size_t>(action)]
+                                                      : Thread::Render;
+}
+
+// Rate-limit class of each action (see NEXUS_BRIDGE_ACTIONS).
+enum class ActionClass : uint8_t { Log, Event, Input, Query, Control, Count };
+
+constexpr size_t ACTION_CLASS_COUNT = static_cast<size_t>(ActionClass::Count);
+
+inline constexpr std::array<ActionClass, ACTION_COUNT> ACTION_CLASS = {
+#define NEXUS_BRIDGE_ACTION_CLASS(Id, wire, thread, cls) ActionClass::cls,
+    NEXUS_BRIDGE_ACTIONS(NEXUS_BRIDGE_ACTION_CLASS)
+#undef NEXUS_BRIDGE_ACTION_CLASS
+};
+
+inline ActionClass GetClass(Action action) {
+    return static_cast<size_t>(action) < ACTION_COUNT ? ACTION_CLASS[static_cast<size_t>(action)]
+                                                      : ActionClass::Control;
+}
+
+inline const char* ActionClassName(ActionClass cls) {
+    switch (cls) {
+        case ActionClass::Log:     return "log";
+        case ActionClass::Event:   return "event";
+        case ActionClass::Input:   return "input";
+        case ActionClass::Query:   return "query";
+        case ActionClass::Control: return "control";
+        default:                   return "?";
+    }
+}
+
+// ---- Typed parameter structs: <Id>Params ----
+
+#define NEXUS_BRIDGE_TYPE_Int  int
+#define NEXUS_BRIDGE_TYPE_Bool bool
+#define NEXUS_BRIDGE_TYPE_Str  const char*
+#define NEXUS_BRIDGE_TYPE_Json const nlohmann::json*
+
+#define NEXUS_BRIDGE_FIELD_INDEX(type, name, def) name##_idx,
+#define NEXUS_BRIDGE_FIELD_NAME(type, name, def)  #name,
+#define NEXUS_BRIDGE_FIELD_DECL(type, name, def)  NEXUS_BRIDGE_TYPE_##type name = def;
+
+#define NEXUS_BRIDGE_PARAM_STRUCT(Id, wire, thread, cls)                             \
+    struct Id##Params {                                                              \
+        enum Field : uint8_t {                                                       \
+            NEXUS_BRIDGE_PARAMS_##Id(NEXUS_BRIDGE_FIELD_INDEX)                       \
+            FIELD_COUNT                                                              \
+        };                                                                           \
+        static constexpr std::array<std::string_view, FIELD_COUNT> FIELD_NAMES = {   \
+            NEXUS_BRIDGE_PARAMS_##Id(NEXUS_BRIDGE_FIELD_NAME)                        \
+        };                                                                           \
+        NEXUS_BRIDGE_PARAMS_##Id(NEXUS_BRIDGE_FIELD_DECL)                            \
+        uint32_t present = 0; /* bit per Field that was present in the message */   \
+        bool Has(Field f) const { return (present >> f) & 1u; }                      \
+    };
+
+NEXUS_BRIDGE_ACTIONS(NEXUS_BRIDGE_PARAM_STRUCT)
+
+#undef NEXUS_BRIDGE_PARAM_STRUCT
+#undef NEXUS_BRIDGE_FIELD_DECL
+#undef NEXUS_BRIDGE_FIELD_NAME
+#undef NEXUS_BRIDGE_FIELD_INDEX
+
+// Map a wire action name to its handler ID (perfect hash, one string compare).
+// Returns Action::Unknown for names not in the description.
+Action Lookup(std::string_view name);
+
+// Decode an action's parameters from a message object in one pass over its
+// members. Unknown members and members of the wrong type are ignored; returns
+// false if an Int member is a number no int can hold. The flat
+// overload is only valid for actions where IsFlatDecodable() is true.
+#define NEXUS_BRIDGE_DECODE_DECL(Id, wire, thread, cls)             \
+    bool Decode(const nlohmann::json& msg, Id##Params& out);        \
+    bool Decode(const BridgeScanner::FlatMessage& msg, Id##Params& out);
+NEXUS_BRIDGE_ACTIONS(NEXUS_BRIDGE_DECODE_DECL)
+#undef NEXUS_BRIDGE_DECODE_DECL
+
+// A JSON number as an int, truncated toward zero: false if it is not finite
+// or out of range.
+bool ToInt(const nlohmann::json& value, int& out);
+bool ToInt(const BridgeScanner::Member& value, int& out);
+
+// JS source that installs the generated window.nexus.* methods. Inserted into
+// the bridge script by NexusBridge.
+const std::string& GetJsStubs();
+
+} // namespace BridgeApi
@@ -0,0 +1,243 @@
+#include "bridge_scanner.h"
+
+#include <charconv>
+
+namespace BridgeScanner {
+
+const Member* FlatMessage::Find(std::string_view key) const {
+    for (size_t i = count; i > 0; --i) {
+        if (members[i - 1].key == key) return &members[i - 1];
+    }
+    return nullptr;
+}
+
+// Cursor over the mutable message buffer.
+struct Cursor {
+    char*       pos;
+    const char* end;
+};
+
+static void SkipWhitespace(Cursor& c) {
+    while (c.pos < c.end &&
+           (*c.pos == ' ' || *c.pos == '\t' || *c.pos == '\n' || *c.pos == '\r')) {
+        ++c.pos;
+    }
+}
+
+static int HexDigit(char ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
+static bool ReadHex4(const char* p, const char* end, uint32_t& out) {
+    if (end - p < 4) return false;
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+        int d = HexDigit(p[i]);
+        if (d < 0) return false;
+        out = (out << 4) | static_cast<uint32_t>(d);
+    }
+    return true;
+}
+
+static char* WriteUtf8(char* w, uint32_t cp) {
+    if (cp < 0x80) {
+        *w++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *w++ = static_cast<char>(0xC0 | (cp >> 6));
+        *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *w++ = static_cast<char>(0xE0 | (cp >> 12));
+        *w++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *w++ = static_cast<char>(0xF0 | (cp >> 18));
+        *w++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *w++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *w++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return w;
+}
+
+// Decode a string whose opening quote is at c.pos. The unescaped text is
+// written over the source (it is never longer) and NUL-terminated.
+static bool ReadString(Cursor& c, const char*& str, size_t& len) {
+    if (c.pos >= c.end || *c.pos != '"') return false;
+    char* r = ++c.pos;
+    char* w = r;
+    char* start = r;
+
+    while (r < c.end) {
+        char ch = *r;
+        if (ch == '"') {
+            *w = '\0';
+            str = start;
+            len = static_cast<size_t>(w - start);
+            c.pos = r + 1;
+            return true;
+        }
+        if (static_cast<unsigned char>(ch) < 0x20) return false;
+        if (ch != '\\') {
+            *w++ = *r++;
+            continue;
+        }
+
+        if (++r >= c.end) return false;
+        switch (*r++) {
+            case '"':  *w++ = '"';  break;
+            case '\\': *w++ = '\\'; break;
+            case '/':  *w++ = '/';  break;
+            case 'b':  *w++ = '\b'; break;
+            case 'f':  *w++ = '\f'; break;
+            case 'n':  *w++ = '\n'; break;
+            case 'r':  *w++ = '\r'; break;
+            case 't':  *w++ = '\t'; break;
+            case 'u': {
+                uint32_t cp;
+                if (!ReadHex4(r, c.end, cp)) return false;
+                r += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    uint32_t low;
+                    if (c.end - r < 6 || r[0] != '\\' || r[1] != 'u' ||
+                        !ReadHex4(r + 2, c.end, low) || low < 0xDC00 || low > 0xDFFF) {
+                        return false;
+                    }
+                    r += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return false;
+                }
+                w = WriteUtf8(w, cp);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+static bool ReadNumber(Cursor& c, Member& m) {
+    const char* start = c.pos;
+    const char* p = c.pos;
+    bool integral = true;
+
+    if (p < c.end && *p == '-') ++p;
+    if (p >= c.end || *p < '0' || *p > '9') return false;
+    if (*p == '0') {
+        ++p;
+    } else {
+        while (p < c.end && *p >= '0' && *p <= '9') ++p;
+    }
+    if (p < c.end && *p == '.') {
+        integral = false;
+        ++p;
+        if (p >= c.end || *p < '0' || *p > '9') return false;
+        while (p < c.end && *p >= '0' && *p <= '9') ++p;
+    }
+    if (p < c.end && (*p == 'e' || *p == 'E')) {
+        integral = false;
+        ++p;
+        if (p < c.end && (*p == '+' || *p == '-')) ++p;
+        if (p >= c.end || *p < '0' || *p > '9') return false;
+        while (p < c.end && *p >= '0' && *p <= '9') ++p;
+    }
+
+    m.kind = ValueKind::Number;
+    if (integral) {
+        auto res = std::from_chars(start, p, m.integer);
+        if (res.ec == std::errc()) {
+            m.integral = true;
+            m.number = static_cast<double>(m.integer);
+            c.pos += p - start;
+            return true;
+        }
+        // Out of int64 range: keep it as a double.
+    }
+    auto res = std::from_chars(start, p, m.number);
+    if (res.ec != std::errc()) return false;
+    c.pos += p - start;
+    return true;
+}
+
+static bool ReadLiteral(Cursor& c, std::string_view literal) {
+    if (static_cast<size_t>(c.end - c.pos) < literal.size()) return false;
+    if (std::string_view(c.pos, literal.size()) != literal) return false;
+    c.pos += literal.size();
+    return true;
+}
+
+static bool ReadValue(Cursor& c, Member& m) {
+    if (c.pos >= c.end) return false;
+    switch (*c.pos) {
+        case '"':
+            m.kind = ValueKind::String;
+            return ReadString(c, m.str, m.strLen);
+        case 't':
+            m.kind = ValueKind::Bool;
+            m.boolean = true;
+            return ReadLiteral(c, "true");
+        case 'f':
+            m.kind = ValueKind::Bool;
+            m.boolean = false;
+            return ReadLiteral(c, "false");
+        case 'n':
+            m.kind = ValueKind::Null;
+            return ReadLiteral(c, "null");
+        case '{':
+        case '[':
+            return false; // nested: not a flat message
+        default:
+            return ReadNumber(c, m);
+    }
+}
+
+bool Scan(char* buffer, size_t length, FlatMessage& out) {
+    Cursor c{ buffer, buffer + length };
+    out.count = 0;
+
+    SkipWhitespace(c);
+    if (c.pos >= c.end || *c.pos != '{') return false;
+    ++c.pos;
+    SkipWhitespace(c);
+
+    if (c.pos < c.end && *c.pos == '}') {
+        ++c.pos;
+    } else {
+        for (;;) {
+            if (out.count == MAX_MEMBERS) return false;
+            Member& m = out.members[out.count];
+            m = Member();
+
+            const char* key;
+            size_t keyLen;
+            if (!ReadString(c, key, keyLen)) return false;
+            m.key = std::string_view(key, keyLen);
+
+            SkipWhitespace(c);
+            if (c.pos >= c.end || *c.pos != ':') return false;
+            ++c.pos;
+            SkipWhitespace(c);
+
+            if (!ReadValue(c, m)) return false;
+            ++out.count;
+
+            SkipWhitespace(c);
+            if (c.pos >= c.end) return false;
+            if (*c.pos == '}') {
+                ++c.pos;
+                break;
+            }
+            if (*c.pos != ',') return false;
+            ++c.pos;
+            SkipWhitespace(c);
+        }
+    }
+
+    SkipWhitespace(c);
+    return c.pos == c.end;
+}
+
+} // namespace BridgeScanner
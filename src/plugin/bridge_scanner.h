@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// Allocation-free decoder for flat bridge messages.
+//
+// Most bridge traffic is a single JSON object whose members are all scalars:
+//   {"action":"log","level":3,"channel":"x","message":"y","__addonId":"a"}
+// Building an nlohmann::json DOM for these costs a heap node per member. The
+// scanner instead decodes such a message in place: strings are unescaped
+// inside the caller's buffer and NUL-terminated there, numbers are parsed
+// directly, and members are recorded in a fixed-size table.
+//
+// Messages with nested objects/arrays, more than MAX_MEMBERS members or
+// malformed input are rejected, and the caller falls back to the DOM parser.
+namespace BridgeScanner {
+
+enum class ValueKind : uint8_t {
+    Null,
+    Bool,
+    Number,
+    String,
+};
+
+struct Member {
+    std::string_view key;
+    ValueKind        kind    = ValueKind::Null;
+    bool             boolean = false;
+    bool             integral = false; // Number without fraction/exponent
+    int64_t          integer = 0;      // valid if integral
+    double           number  = 0.0;
+    const char*      str     = nullptr; // NUL-terminated, points into the buffer
+    size_t           strLen  = 0;
+};
+
+constexpr size_t MAX_MEMBERS = 16;
+
+struct FlatMessage {
+    Member members[MAX_MEMBERS];
+    size_t count = 0;
+
+    // Last member with this key (matches DOM semantics for duplicate keys).
+    const Member* Find(std::string_view key) const;
+};
+
+// Decode `buffer[0..length)` in place. The buffer is modified (unescaping,
+// NUL terminators) and must outlive `out`. Returns false if the message is
+// not a flat object.
+bool Scan(char* buffer, size_t length, FlatMessage& out);
+
+} // namespace BridgeScanner
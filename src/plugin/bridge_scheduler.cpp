@@ -0,0 +1,261 @@
+#include "bridge_scheduler.h"
+#include "globals.h"
+#include "shared/version.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace BridgeScheduler {
+
+using Clock = std::chrono::steady_clock;
+
+// Per addon, per class. Startup (window creation, subscriptions) is bursty;
+// input and raised events are what an addon can spam into the game.
+static const ClassLimit s_limits[ACTION_CLASS_COUNT] = {
+    { 100.0, 200.0 },  // Log
+    {  60.0, 120.0 },  // Event
+    {  30.0,  60.0 },  // Input
+    { 200.0, 400.0 },  // Query
+    {  50.0, 200.0 },  // Control
+};
+
+// All classes together, with some headroom: a page within every class's
+// limit never hits it.
+static const ClassLimit s_messageLimit = { 500.0, 1000.0 };
+
+const ClassLimit& GetLimit(ActionClass cls) {
+    return s_limits[std::min(static_cast<size_t>(cls), ACTION_CLASS_COUNT - 1)];
+}
+
+const ClassLimit& GetMessageLimit() {
+    return s_messageLimit;
+}
+
+struct Bucket {
+    double            tokens = -1.0;  // < 0: not used yet (starts full)
+    Clock::time_point refilled;
+    uint64_t          dropped = 0;    // in the current throttling episode
+};
+
+struct AddonEntry {
+    std::string                 id;
+    std::deque<WorkerPool::Job> jobs;
+    bool                        ready = false;  // in s_ready
+    Bucket                      buckets[ACTION_CLASS_COUNT];
+    Bucket                      messages;       // s_messageLimit, at enqueue
+    uint64_t                    overflowing = 0; // drops in the current FIFO-full episode
+    uint32_t                    renderPending = 0; // in RenderBatch, not yet run
+    AddonStats                  stats;
+};
+
+static std::mutex                                                  s_mutex;
+static std::unordered_map<std::string, std::unique_ptr<AddonEntry>> s_addons;
+static std::deque<AddonEntry*>                                      s_ready;  // turn order
+static std::unique_ptr<WorkerPool>                                  s_worker;
+
+// s_mutex held
+static AddonEntry& GetEntry(const std::string& addonId) {
+    auto& entry = s_addons[addonId];
+    if (!entry) {
+        entry = std::make_unique<AddonEntry>();
+        entry->id = addonId;
+    }
+    return *entry;
+}
+
+// Refill the bucket for the time since its last use and take a token.
+// s_mutex held.
+static bool TakeToken(Bucket& bucket, const ClassLimit& limit, Clock::time_point now) {
+    if (bucket.tokens < 0.0) {
+        bucket.tokens = limit.burst;
+    } else {
+        double elapsed = std::chrono::duration<double>(now - bucket.refilled).count();
+        bucket.tokens = std::min(limit.burst, bucket.tokens + elapsed * limit.ratePerSecond);
+    }
+    bucket.refilled = now;
+
+    if (bucket.tokens < 1.0) return false;
+    bucket.tokens -= 1.0;
+    return true;
+}
+
+// One job per posted message; each runs the next message of the addon whose
+// turn it is.
+static void RunNext() {
+    WorkerPool::Job job;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_ready.empty()) return;
+
+        AddonEntry* entry = s_ready.front();
+        s_ready.pop_front();
+        job = std::move(entry->jobs.front());
+        entry->jobs.pop_front();
+        entry->stats.queued = static_cast<uint32_t>(entry->jobs.size());
+
+        if (entry->jobs.empty()) {
+            entry->ready = false;
+        } else {
+            s_ready.push_back(entry);
+        }
+    }
+    job();
+}
+
+void Start() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_worker) s_worker = std::make_unique<WorkerPool>(1);
+}
+
+void Stop() {
+    std::unique_ptr<WorkerPool> worker;
+    std::vector<std::deque<WorkerPool::Job>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        worker = std::move(s_worker);
+        for (auto& [id, entry] : s_addons) {
+            dropped.push_back(std::move(entry->jobs));
+            entry->ready = false;
+            entry->renderPending = 0;
+            entry->stats.queued = 0;
+        }
+        s_ready.clear();
+    }
+    // Outside the lock: a running job may still need it
+    if (worker) worker->Stop();
+}
+
+// Messages dropped at enqueue are never parsed; the caller rejects a pending
+// request among them.
+Posted Post(const std::string& addonId, WorkerPool::Job job) {
+    char message[256];
+    int logLevel = 0;
+    Posted result = Posted::Queued;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (!s_worker) return Posted::NotRunning;
+
+        AddonEntry& entry = GetEntry(addonId);
+        bool budget = TakeToken(entry.messages, s_messageLimit, Clock::now());
+        if (budget && entry.messages.dropped) {
+            snprintf(message, sizeof(message), "Addon '%s': %llu bridge message(s) dropped over budget.",
+                addonId.c_str(), static_cast<unsigned long long>(entry.messages.dropped));
+            logLevel = LOGL_INFO;
+            entry.messages.dropped = 0;
+        }
+
+        if (!budget) {
+            ++entry.stats.overBudget;
+            if (entry.messages.dropped++ == 0) {
+                snprintf(message, sizeof(message), "Addon '%s': bridge messages over %.0f/s, dropping.",
+                    addonId.c_str(), s_messageLimit.ratePerSecond);
+                logLevel = LOGL_WARNING;
+            }
+            result = Posted::Dropped;
+        } else if (entry.jobs.size() >= MAX_QUEUED) {
+            ++entry.stats.overflowed;
+            if (entry.overflowing++ == 0) {
+                snprintf(message, sizeof(message), "Addon '%s': %zu bridge messages queued, dropping.",
+                    addonId.c_str(), MAX_QUEUED);
+                logLevel = LOGL_WARNING;
+            }
+            result = Posted::Dropped;
+        } else {
+            entry.overflowing = 0;
+            entry.jobs.push_back(std::move(job));
+            entry.stats.queued = static_cast<uint32_t>(entry.jobs.size());
+            entry.stats.maxQueued = std::max(entry.stats.maxQueued, entry.stats.queued);
+            if (!entry.ready) {
+                entry.ready = true;
+                s_ready.push_back(&entry);
+            }
+
+            // Stop() clears s_worker before stopping the pool, so this cannot fail
+            s_worker->Post(RunNext);
+        }
+    }
+
+    if (logLevel && Globals::API) {
+        Globals::API->Log(static_cast<ELogLevel>(logLevel), ADDON_NAME, message);
+    }
+    return result;
+}
+
+bool Admit(const std::string& addonId, ActionClass cls) {
+    size_t index = std::min(static_cast<size_t>(cls), ACTION_CLASS_COUNT - 1);
+    const ClassLimit& limit = s_limits[index];
+    Clock::time_point now = Clock::now();
+
+    char message[256];
+    int logLevel = 0;
+    bool admitted;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        AddonEntry& entry = GetEntry(addonId);
+        Bucket& bucket = entry.buckets[index];
+
+        admitted = TakeToken(bucket, limit, now);
+        if (admitted) {
+            ++entry.stats.admitted;
+            if (bucket.dropped) {
+                snprintf(message, sizeof(message), "Addon '%s': %llu %s message(s) dropped by rate limit.",
+                    addonId.c_str(), static_cast<unsigned long long>(bucket.dropped),
+                    BridgeApi::ActionClassName(cls));
+                logLevel = LOGL_INFO;
+                bucket.dropped = 0;
+            }
+        } else {
+            ++entry.stats.throttled[index];
+            if (bucket.dropped++ == 0) {
+                snprintf(message, sizeof(message), "Addon '%s': %s messages over %.0f/s, throttling.",
+                    addonId.c_str(), BridgeApi::ActionClassName(cls), limit.ratePerSecond);
+                logLevel = LOGL_WARNING;
+            }
+        }
+    }
+
+    if (logLevel && Globals::API) {
+        Globals::API->Log(static_cast<ELogLevel>(logLevel), ADDON_NAME, message);
+    }
+    return admitted;
+}
+
+void BeginRender(const std::string& addonId) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    ++GetEntry(addonId).renderPending;
+}
+
+// Stop() zeroes the count, and the batch may still run jobs posted before it
+void EndRender(const std::string& addonId) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    AddonEntry& entry = GetEntry(addonId);
+    if (entry.renderPending) --entry.renderPending;
+}
+
+bool IsRenderPending(const std::string& addonId) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = s_addons.find(addonId);
+    return it != s_addons.end() && it->second->renderPending != 0;
+}
+
+void AddTime(const std::string& addonId, BridgeApi::Thread thread, uint64_t microseconds) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    AddonEntry& entry = GetEntry(addonId);
+    (thread == BridgeApi::Thread::Worker ? entry.stats.workerUs : entry.stats.renderUs) += microseconds;
+}
+
+bool GetStats(const std::string& addonId, AddonStats& out) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = s_addons.find(addonId);
+    if (it == s_addons.end()) return false;
+    out = it->second->stats;
+    return true;
+}
+
+} // namespace BridgeScheduler
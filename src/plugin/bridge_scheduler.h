@@ -0,0 +1,79 @@
+#pragma once
+
+#include "bridge_api.h"
+#include "worker_pool.h"
+
+#include <string>
+#include <cstdint>
+
+// Schedules bridge messages onto the bridge worker and rate-limits them per
+// addon (the addon of the page that sent the message).
+//
+// Each addon has its own bounded FIFO of pending messages. The worker takes
+// one message from each backlogged addon in turn, so an addon flooding the
+// bridge delays only its own messages. Before a message is queued it is
+// charged to the addon's overall message budget; messages over the budget,
+// or past a full FIFO, are dropped unparsed. After parsing, each addon also
+// has a token bucket per action class (bridge_api.h): a message over its
+// class's rate is dropped before its handler runs, on either thread.
+namespace BridgeScheduler {
+
+using BridgeApi::ActionClass;
+using BridgeApi::ACTION_CLASS_COUNT;
+
+// Most messages an addon can have waiting for the worker.
+constexpr size_t MAX_QUEUED = 256;
+
+// Start / stop the bridge worker. Stop drops queued messages.
+void Start();
+void Stop();
+
+enum class Posted {
+    Queued,
+    Dropped,     // over the addon's message budget, or its FIFO is full
+    NotRunning,  // no worker: the caller handles the message inline
+};
+
+// Queue a job in the addon's FIFO. A dropped job is not run: the caller
+// answers the message itself.
+Posted Post(const std::string& addonId, WorkerPool::Job job);
+
+// Take a token from the addon's bucket for the class. Returns false, and
+// counts the message as throttled, if the bucket is empty. Any thread.
+bool Admit(const std::string& addonId, ActionClass cls);
+
+// Count an addon's messages handed to RenderBatch and not yet run. While
+// any are waiting, the worker sends the addon's later messages the same way,
+// so a worker handler never runs ahead of a render handler queued before it.
+void BeginRender(const std::string& addonId);  // bridge worker
+void EndRender(const std::string& addonId);    // render thread
+bool IsRenderPending(const std::string& addonId);
+
+// Add time spent on the addon's messages. Any thread.
+void AddTime(const std::string& addonId, BridgeApi::Thread thread, uint64_t microseconds);
+
+struct ClassLimit {
+    double ratePerSecond;  // refill rate
+    double burst;          // bucket size
+};
+
+const ClassLimit& GetLimit(ActionClass cls);
+
+// Budget for all of an addon's messages, charged when they are queued.
+const ClassLimit& GetMessageLimit();
+
+struct AddonStats {
+    uint64_t admitted = 0;
+    uint64_t throttled[ACTION_CLASS_COUNT] = {};
+    uint64_t overBudget = 0; // dropped unparsed: over the message budget
+    uint64_t overflowed = 0; // dropped unparsed: FIFO full
+    uint64_t workerUs = 0;   // parsing and worker handlers
+    uint64_t renderUs = 0;   // render handlers
+    uint32_t queued = 0;     // messages waiting for the worker
+    uint32_t maxQueued = 0;
+};
+
+// Copy of the addon's counters. Returns false if no message was seen from it.
+bool GetStats(const std::string& addonId, AddonStats& out);
+
+} // namespace BridgeScheduler
@@ -0,0 +1,124 @@
+#include "event_aggregator.h"
+
+#include <algorithm>
+
+const char* AggregateOpName(AggregateOp op) {
+    switch (op) {
+        case AggregateOp::Count:  return "count";
+        case AggregateOp::Rate:   return "rate";
+        case AggregateOp::Sum:    return "sum";
+        case AggregateOp::Latest: return "latest";
+    }
+    return "count";
+}
+
+bool ParseAggregateOp(std::string_view name, AggregateOp& out) {
+    if (name == "count")  { out = AggregateOp::Count;  return true; }
+    if (name == "rate")   { out = AggregateOp::Rate;   return true; }
+    if (name == "sum")    { out = AggregateOp::Sum;    return true; }
+    if (name == "latest") { out = AggregateOp::Latest; return true; }
+    return false;
+}
+
+EventAggregator::EventAggregator(std::string id, std::string eventName, AggregateOp op,
+                                 EventCodecs::CodecId codec, const EventCodecs::FieldDesc* field,
+                                 uint32_t windowMs, uint32_t emitHz, DWORD now)
+    : m_id(std::move(id))
+    , m_eventName(std::move(eventName))
+    , m_op(op)
+    , m_codec(codec)
+    , m_field(field)
+    , m_windowMs(windowMs)
+    , m_bucketMs(std::max<DWORD>(1, windowMs / BUCKETS))
+    , m_emitIntervalMs(1000 / std::max<uint32_t>(1, emitHz ? emitHz : DEFAULT_EMIT_HZ))
+    , m_headStart(now)
+    , m_createdTick(now)
+    , m_lastAdvanceTick(now) {
+}
+
+// ---- Game threads ----
+
+void EventAggregator::Add(const void* record, size_t size) {
+    m_pendingCount.fetch_add(1, std::memory_order_relaxed);
+    if (!m_field) return;
+
+    double value = 0;
+    if (!EventCodecs::FieldNumber(m_codec, *m_field, record, size, value)) return;
+
+    if (m_op == AggregateOp::Sum) {
+        m_pendingSum.fetch_add(value, std::memory_order_relaxed);
+    } else if (m_op == AggregateOp::Latest) {
+        m_latest.store(value, std::memory_order_relaxed);
+        m_hasLatest.store(true, std::memory_order_release);
+    }
+}
+
+// ---- Render thread ----
+
+void EventAggregator::Advance(DWORD now) {
+    // Rotate past every bucket interval that ended since the last call; a
+    // gap longer than the window clears the whole ring.
+    if (m_windowMs) {
+        DWORD steps = (now - m_headStart) / m_bucketMs;
+        if (steps) {
+            size_t clear = std::min<size_t>(steps, BUCKETS);
+            for (size_t i = 0; i < clear; ++i) {
+                m_head = (m_head + 1) % BUCKETS;
+                m_buckets[m_head] = Bucket{};
+            }
+            m_headStart += steps * m_bucketMs;
+        }
+    }
+
+    uint64_t count = m_pendingCount.exchange(0, std::memory_order_relaxed);
+    double sum = m_pendingSum.exchange(0, std::memory_order_relaxed);
+    m_buckets[m_head].count += count;
+    m_buckets[m_head].sum += sum;
+    m_totalCount += count;
+    m_lastAdvanceTick = now;
+}
+
+uint64_t EventAggregator::WindowCount() const {
+    uint64_t count = 0;
+    for (const Bucket& b : m_buckets) count += b.count;
+    return count;
+}
+
+double EventAggregator::Value() const {
+    switch (m_op) {
+        case AggregateOp::Count:
+            return static_cast<double>(WindowCount());
+
+        case AggregateOp::Rate: {
+            // Until the aggregator has existed for a full window, divide by
+            // its age rather than the window length.
+            DWORD age = m_lastAdvanceTick - m_createdTick;
+            DWORD span = m_windowMs ? std::min<DWORD>(m_windowMs, age) : age;
+            if (span == 0) return 0;
+            return static_cast<double>(WindowCount()) * 1000.0 / span;
+        }
+
+        case AggregateOp::Sum: {
+            double sum = 0;
+            for (const Bucket& b : m_buckets) sum += b.sum;
+            return sum;
+        }
+
+        case AggregateOp::Latest:
+            return m_latest.load(std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+bool EventAggregator::TakeEmit(DWORD now) {
+    if (m_emitted && now - m_lastEmitTick < m_emitIntervalMs) return false;
+    if (m_op == AggregateOp::Latest && !m_hasLatest.load(std::memory_order_acquire)) return false;
+
+    double value = Value();
+    if (m_emitted && value == m_lastEmitValue) return false;
+
+    m_emitted = true;
+    m_lastEmitTick = now;
+    m_lastEmitValue = value;
+    return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "event_codecs.h"
+
+#include <windows.h>
+
+#include <atomic>
+#include <array>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// Native aggregation of a high-frequency event, declared from JS with
+// nexus.events.aggregate().
+//
+// EventRouter feeds occurrences straight into the aggregator on the firing
+// thread: Add() only bumps atomic counters, so nothing is queued or copied
+// per occurrence. Once per frame the render thread folds those counters
+// into a ring of time buckets covering the window and, at the requested
+// emit rate, sends the aggregated value to JS.
+enum class AggregateOp : uint8_t {
+    Count,  // occurrences in the window
+    Rate,   // occurrences per second over the window
+    Sum,    // sum of `field` over the window
+    Latest, // most recent value of `field`
+};
+
+// "count", "rate", "sum", "latest". Parse returns false for other names.
+const char* AggregateOpName(AggregateOp op);
+bool ParseAggregateOp(std::string_view name, AggregateOp& out);
+
+class EventAggregator {
+public:
+    static constexpr size_t   BUCKETS = 32;
+    static constexpr uint32_t DEFAULT_WINDOW_MS = 1000;
+    static constexpr uint32_t DEFAULT_EMIT_HZ = 4;
+
+    // `field` (Sum/Latest) must be a numeric field of `codec`. windowMs 0
+    // aggregates over the aggregator's whole lifetime.
+    EventAggregator(std::string id, std::string eventName, AggregateOp op,
+                    EventCodecs::CodecId codec, const EventCodecs::FieldDesc* field,
+                    uint32_t windowMs, uint32_t emitHz, DWORD now);
+
+    EventAggregator(const EventAggregator&) = delete;
+    EventAggregator& operator=(const EventAggregator&) = delete;
+
+    // Record one occurrence (game threads). Lock-free, no allocation.
+    void Add(const void* record, size_t size);
+
+    // Fold occurrences recorded since the last call into the window and
+    // expire buckets older than it (render thread).
+    void Advance(DWORD now);
+
+    // True when the emit interval has passed and the value changed since the
+    // last emit (or nothing was emitted yet). Marks the value as emitted.
+    bool TakeEmit(DWORD now);
+
+    // Aggregated value as of the last Advance.
+    double Value() const;
+    uint64_t WindowCount() const;
+
+    const std::string& GetId() const { return m_id; }
+    const std::string& GetEventName() const { return m_eventName; }
+    AggregateOp GetOp() const { return m_op; }
+    uint32_t GetWindowMs() const { return m_windowMs; }
+    uint64_t GetTotalCount() const { return m_totalCount; }
+
+private:
+    struct Bucket {
+        uint64_t count = 0;
+        double   sum = 0;
+    };
+
+    std::string                   m_id;
+    std::string                   m_eventName;
+    AggregateOp                   m_op;
+    EventCodecs::CodecId          m_codec;
+    const EventCodecs::FieldDesc* m_field;
+    uint32_t                      m_windowMs;
+    DWORD                         m_bucketMs;
+    DWORD                         m_emitIntervalMs;
+
+    // Written by game threads, drained by Advance
+    std::atomic<uint64_t> m_pendingCount{0};
+    std::atomic<double>   m_pendingSum{0};
+    std::atomic<double>   m_latest{0};
+    std::atomic<bool>     m_hasLatest{false};
+
+    // Render thread
+    std::array<Bucket, BUCKETS> m_buckets{};
+    size_t   m_head = 0;          // bucket receiving the current interval
+    DWORD    m_headStart;         // tick at which m_head's interval began
+    DWORD    m_createdTick;
+    DWORD    m_lastAdvanceTick;
+    uint64_t m_totalCount = 0;
+
+    DWORD    m_lastEmitTick = 0;
+    bool     m_emitted = false;
+    double   m_lastEmitValue = 0;
+};
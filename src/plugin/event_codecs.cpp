@@ -0,0 +1,426 @@
+#include "event_codecs.h"
+
+#include <cstddef>
+#include <cstring>
+
+using json = nlohmann::json;
+
+namespace EventCodecs {
+
+// ---- Mirrors of the structs Nexus / ArcDPS pass as aEventArgs ----
+
+// EV_MUMBLE_IDENTITY_UPDATED: Mumble::Identity*
+struct MumbleIdentity {
+    char     Name[20];
+    uint32_t Profession;
+    uint32_t Specialization;
+    uint32_t Race;
+    uint32_t MapID;
+    uint32_t WorldID;
+    uint32_t TeamColorID;
+    bool     IsCommander;
+    float    FOV;
+    uint32_t UISize;
+};
+
+// EV_ARCDPS_COMBATEVENT_*_RAW: EvCombatData*
+struct ArcCombatEvent {
+    uint64_t time;
+    uint64_t src_agent;
+    uint64_t dst_agent;
+    int32_t  value;
+    int32_t  buff_dmg;
+    uint32_t overstack_value;
+    uint32_t skillid;
+    uint16_t src_instid;
+    uint16_t dst_instid;
+    uint16_t src_master_instid;
+    uint16_t dst_master_instid;
+    uint8_t  iff;
+    uint8_t  buff;
+    uint8_t  result;
+    uint8_t  is_activation;
+    uint8_t  is_buffremove;
+    uint8_t  is_ninety;
+    uint8_t  is_fifty;
+    uint8_t  is_moving;
+    uint8_t  is_statechange;
+    uint8_t  is_flanking;
+    uint8_t  is_shields;
+    uint8_t  is_offcycle;
+    uint8_t  pad61, pad62, pad63, pad64;
+};
+static_assert(sizeof(ArcCombatEvent) == 64, "cbtevent layout");
+
+struct ArcAgent {
+    char*     name;
+    uintptr_t id;
+    uint32_t  prof;
+    uint32_t  elite;
+    uint32_t  self;
+    uint16_t  team;
+};
+
+struct ArcCombatData {
+    ArcCombatEvent* ev;
+    ArcAgent*       src;
+    ArcAgent*       dst;
+    char*           skillname;
+    uint64_t        id;
+    uint64_t        revision;
+};
+
+// ---- Records ----
+
+static constexpr size_t NAME_BYTES = 64;
+
+struct AgentRecord {
+    uint64_t id;
+    uint32_t prof;
+    uint32_t elite;
+    uint32_t self;
+    uint16_t team;
+    char     name[NAME_BYTES];
+};
+
+struct CombatRecord {
+    uint8_t        hasEv, hasSrc, hasDst;
+    ArcCombatEvent ev;
+    AgentRecord    src, dst;
+    uint64_t       id;
+    uint64_t       revision;
+    char           skillName[NAME_BYTES];
+};
+
+struct SignatureRecord {
+    int32_t signature;
+};
+
+struct AccountNameRecord {
+    char name[NAME_BYTES];
+};
+
+static_assert(sizeof(MumbleIdentity) <= MAX_RECORD_BYTES, "record too large");
+static_assert(sizeof(CombatRecord) <= MAX_RECORD_BYTES, "record too large");
+
+static void CopyChars(char* dst, const char* src, size_t capacity) {
+    if (!src) {
+        dst[0] = '\0';
+        return;
+    }
+    size_t n = strnlen(src, capacity - 1);
+    std::memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+// ---- Capture (firing thread) ----
+
+static uint16_t CaptureIdentity(const void* args, void* out) {
+    if (!args) return 0;
+    std::memcpy(out, args, sizeof(MumbleIdentity));
+    return sizeof(MumbleIdentity);
+}
+
+static uint16_t CaptureSignature(const void* args, void* out) {
+    if (!args) return 0;
+    auto* rec = static_cast<SignatureRecord*>(out);
+    std::memcpy(&rec->signature, args, sizeof(int32_t));
+    return sizeof(SignatureRecord);
+}
+
+static uint16_t CaptureAccountName(const void* args, void* out) {
+    if (!args) return 0;
+    auto* rec = static_cast<AccountNameRecord*>(out);
+    CopyChars(rec->name, static_cast<const char*>(args), NAME_BYTES);
+    return sizeof(AccountNameRecord);
+}
+
+static void CaptureAgent(const ArcAgent* agent, AgentRecord& rec) {
+    rec.id    = agent->id;
+    rec.prof  = agent->prof;
+    rec.elite = agent->elite;
+    rec.self  = agent->self;
+    rec.team  = agent->team;
+    CopyChars(rec.name, agent->name, NAME_BYTES);
+}
+
+static uint16_t CaptureCombat(const void* args, void* out) {
+    if (!args) return 0;
+    const auto* data = static_cast<const ArcCombatData*>(args);
+    auto* rec = static_cast<CombatRecord*>(out);
+
+    rec->hasEv = data->ev != nullptr;
+    if (data->ev) rec->ev = *data->ev;
+    rec->hasSrc = data->src != nullptr;
+    if (data->src) CaptureAgent(data->src, rec->src);
+    rec->hasDst = data->dst != nullptr;
+    if (data->dst) CaptureAgent(data->dst, rec->dst);
+    rec->id = data->id;
+    rec->revision = data->revision;
+    CopyChars(rec->skillName, data->skillname, NAME_BYTES);
+    return sizeof(CombatRecord);
+}
+
+// ---- Field tables ----
+
+#define FIELD(Record, member, jsonName, type) \
+    { nullptr, jsonName, static_cast<uint16_t>(offsetof(Record, member)), 0, FieldType::type }
+#define CHARS(Record, member, jsonName) \
+    { nullptr, jsonName, static_cast<uint16_t>(offsetof(Record, member)), \
+      static_cast<uint16_t>(sizeof(Record::member)), FieldType::Chars }
+#define GROUP_FIELD(Record, group, member, jsonName, type) \
+    { group, jsonName, static_cast<uint16_t>(offsetof(Record, member)), 0, FieldType::type }
+#define GROUP_CHARS(Record, group, member, jsonName) \
+    { group, jsonName, static_cast<uint16_t>(offsetof(Record, member)), NAME_BYTES, FieldType::Chars }
+
+static const FieldDesc s_identityFields[] = {
+    CHARS(MumbleIdentity, Name,           "name"),
+    FIELD(MumbleIdentity, Profession,     "profession",     U32),
+    FIELD(MumbleIdentity, Specialization, "specialization", U32),
+    FIELD(MumbleIdentity, Race,           "race",           U32),
+    FIELD(MumbleIdentity, MapID,          "mapId",          U32),
+    FIELD(MumbleIdentity, WorldID,        "worldId",        U32),
+    FIELD(MumbleIdentity, TeamColorID,    "teamColorId",    U32),
+    FIELD(MumbleIdentity, IsCommander,    "isCommander",    Bool),
+    FIELD(MumbleIdentity, FOV,            "fov",            F32),
+    FIELD(MumbleIdentity, UISize,         "uiSize",         U32),
+};
+
+static const FieldDesc s_signatureFields[] = {
+    FIELD(SignatureRecord, signature, "signature", I32),
+};
+
+static const FieldDesc s_accountNameFields[] = {
+    CHARS(AccountNameRecord, name, "name"),
+};
+
+static const GroupDesc s_combatGroups[] = {
+    { "ev",  static_cast<uint16_t>(offsetof(CombatRecord, hasEv)) },
+    { "src", static_cast<uint16_t>(offsetof(CombatRecord, hasSrc)) },
+    { "dst", static_cast<uint16_t>(offsetof(CombatRecord, hasDst)) },
+};
+
+#define EV_FIELD(member, jsonName, type) GROUP_FIELD(CombatRecord, "ev", ev.member, jsonName, type)
+#define AGENT_FIELDS(g)                                                   \
+    GROUP_FIELD(CombatRecord, #g, g.id,    "id",    U64),                 \
+    GROUP_FIELD(CombatRecord, #g, g.prof,  "prof",  U32),                 \
+    GROUP_FIELD(CombatRecord, #g, g.elite, "elite", U32),                 \
+    GROUP_FIELD(CombatRecord, #g, g.self,  "self",  U32),                 \
+    GROUP_FIELD(CombatRecord, #g, g.team,  "team",  U16),                 \
+    GROUP_CHARS(CombatRecord, #g, g.name,  "name")
+
+static const FieldDesc s_combatFields[] = {
+    EV_FIELD(time,              "time",            U64),
+    EV_FIELD(src_agent,         "srcAgent",        U64),
+    EV_FIELD(dst_agent,         "dstAgent",        U64),
+    EV_FIELD(value,             "value",           I32),
+    EV_FIELD(buff_dmg,          "buffDmg",         I32),
+    EV_FIELD(overstack_value,   "overstackValue",  U32),
+    EV_FIELD(skillid,           "skillId",         U32),
+    EV_FIELD(src_instid,        "srcInstId",       U16),
+    EV_FIELD(dst_instid,        "dstInstId",       U16),
+    EV_FIELD(src_master_instid, "srcMasterInstId", U16),
+    EV_FIELD(dst_master_instid, "dstMasterInstId", U16),
+    EV_FIELD(iff,               "iff",             U8),
+    EV_FIELD(buff,              "buff",            U8),
+    EV_FIELD(result,            "result",          U8),
+    EV_FIELD(is_activation,     "isActivation",    U8),
+    EV_FIELD(is_buffremove,     "isBuffRemove",    U8),
+    EV_FIELD(is_ninety,         "isNinety",        U8),
+    EV_FIELD(is_fifty,          "isFifty",         U8),
+    EV_FIELD(is_moving,         "isMoving",        U8),
+    EV_FIELD(is_statechange,    "isStateChange",   U8),
+    EV_FIELD(is_flanking,       "isFlanking",      U8),
+    EV_FIELD(is_shields,        "isShields",       U8),
+    EV_FIELD(is_offcycle,       "isOffCycle",      U8),
+    AGENT_FIELDS(src),
+    AGENT_FIELDS(dst),
+    FIELD(CombatRecord, id,        "id",        U64),
+    FIELD(CombatRecord, revision,  "revision",  U64),
+    CHARS(CombatRecord, skillName, "skillName"),
+};
+
+#undef AGENT_FIELDS
+#undef EV_FIELD
+#undef GROUP_CHARS
+#undef GROUP_FIELD
+#undef CHARS
+#undef FIELD
+
+template <size_t N>
+static constexpr size_t CountOf(const FieldDesc (&)[N]) { return N; }
+template <size_t N>
+static constexpr size_t CountOf(const GroupDesc (&)[N]) { return N; }
+
+// Index 0 is reserved for NONE.
+static const Codec s_codecs[] = {
+    { nullptr, nullptr, nullptr, 0, nullptr, 0 },
+    { "EV_MUMBLE_IDENTITY_UPDATED",      CaptureIdentity,    s_identityFields,    CountOf(s_identityFields),    nullptr, 0 },
+    { "EV_ADDON_LOADED",                 CaptureSignature,   s_signatureFields,   CountOf(s_signatureFields),   nullptr, 0 },
+    { "EV_ADDON_UNLOADED",               CaptureSignature,   s_signatureFields,   CountOf(s_signatureFields),   nullptr, 0 },
+    { "EV_VOLATILE_ADDON_DISABLED",      CaptureSignature,   s_signatureFields,   CountOf(s_signatureFields),   nullptr, 0 },
+    { "EV_ACCOUNT_NAME",                 CaptureAccountName, s_accountNameFields, CountOf(s_accountNameFields), nullptr, 0 },
+    { "EV_ARCDPS_COMBATEVENT_LOCAL_RAW", CaptureCombat,      s_combatFields,      CountOf(s_combatFields),
+      s_combatGroups, CountOf(s_combatGroups) },
+    { "EV_ARCDPS_COMBATEVENT_SQUAD_RAW", CaptureCombat,      s_combatFields,      CountOf(s_combatFields),
+      s_combatGroups, CountOf(s_combatGroups) },
+};
+
+static constexpr size_t CODEC_COUNT = sizeof(s_codecs) / sizeof(s_codecs[0]);
+
+CodecId Find(std::string_view eventName) {
+    for (size_t i = 1; i < CODEC_COUNT; ++i) {
+        if (eventName == s_codecs[i].eventName) return static_cast<CodecId>(i);
+    }
+    return NONE;
+}
+
+const Codec* Get(CodecId id) {
+    if (id == NONE || id >= CODEC_COUNT) return nullptr;
+    return &s_codecs[id];
+}
+
+// ---- Decode (render thread) ----
+
+template <typename T>
+static T Read(const uint8_t* base, uint16_t offset) {
+    T value;
+    std::memcpy(&value, base + offset, sizeof(T));
+    return value;
+}
+
+static size_t FieldBytes(const FieldDesc& f) {
+    switch (f.type) {
+        case FieldType::U8:
+        case FieldType::Bool:  return 1;
+        case FieldType::U16:   return 2;
+        case FieldType::U32:
+        case FieldType::I32:
+        case FieldType::F32:   return 4;
+        case FieldType::U64:   return 8;
+        case FieldType::Chars: return f.size;
+    }
+    return 0;
+}
+
+void ToJson(CodecId id, const void* record, size_t size, json& out) {
+    const Codec* codec = Get(id);
+    if (!codec || !record || size == 0) {
+        out = nullptr;
+        return;
+    }
+
+    const auto* base = static_cast<const uint8_t*>(record);
+    out = json::object();
+
+    for (size_t i = 0; i < codec->groupCount; ++i) {
+        const GroupDesc& g = codec->groups[i];
+        bool present = g.presentOffset < size && base[g.presentOffset] != 0;
+        out[g.name] = present ? json::object() : json(nullptr);
+    }
+
+    for (size_t i = 0; i < codec->fieldCount; ++i) {
+        const FieldDesc& f = codec->fields[i];
+        if (f.offset + FieldBytes(f) > size) continue;
+
+        json& target = f.group ? out[f.group] : out;
+        if (target.is_null()) continue;
+
+        switch (f.type) {
+            case FieldType::U8:   target[f.name] = Read<uint8_t>(base, f.offset);  break;
+            case FieldType::U16:  target[f.name] = Read<uint16_t>(base, f.offset); break;
+            case FieldType::U32:  target[f.name] = Read<uint32_t>(base, f.offset); break;
+            case FieldType::U64:  target[f.name] = Read<uint64_t>(base, f.offset); break;
+            case FieldType::I32:  target[f.name] = Read<int32_t>(base, f.offset);  break;
+            case FieldType::F32:  target[f.name] = Read<float>(base, f.offset);    break;
+            case FieldType::Bool: target[f.name] = base[f.offset] != 0;            break;
+            case FieldType::Chars: {
+                const char* s = reinterpret_cast<const char*>(base + f.offset);
+                target[f.name] = std::string(s, strnlen(s, f.size));
+                break;
+            }
+        }
+    }
+}
+
+// ---- Field keys (render thread) ----
+
+static const GroupDesc* FindGroup(const Codec& codec, std::string_view name) {
+    for (size_t i = 0; i < codec.groupCount; ++i) {
+        if (name == codec.groups[i].name) return &codec.groups[i];
+    }
+    return nullptr;
+}
+
+const FieldDesc* FindField(CodecId id, std::string_view path) {
+    const Codec* codec = Get(id);
+    if (!codec) return nullptr;
+
+    std::string_view group;
+    std::string_view name = path;
+    size_t dot = path.find('.');
+    if (dot != std::string_view::npos) {
+        group = path.substr(0, dot);
+        name = path.substr(dot + 1);
+    }
+
+    for (size_t i = 0; i < codec->fieldCount; ++i) {
+        const FieldDesc& f = codec->fields[i];
+        if (name != f.name) continue;
+        if (group.empty() ? f.group == nullptr : (f.group && group == f.group)) return &f;
+    }
+    return nullptr;
+}
+
+// The field's bytes in `record`, or nullptr if it is not there.
+static const uint8_t* FieldData(CodecId id, const FieldDesc& field, const void* record,
+                                size_t size) {
+    const Codec* codec = Get(id);
+    if (!codec || !record || field.offset + FieldBytes(field) > size) return nullptr;
+
+    const auto* base = static_cast<const uint8_t*>(record);
+    if (field.group) {
+        const GroupDesc* g = FindGroup(*codec, field.group);
+        if (!g || g->presentOffset >= size || base[g->presentOffset] == 0) return nullptr;
+    }
+    return base + field.offset;
+}
+
+bool FieldKey(CodecId id, const FieldDesc& field, const void* record, size_t size,
+              uint64_t& key) {
+    const uint8_t* data = FieldData(id, field, record, size);
+    if (!data) return false;
+
+    size_t bytes = FieldBytes(field);
+    if (field.type == FieldType::Chars) {
+        bytes = strnlen(reinterpret_cast<const char*>(data), field.size);
+    }
+
+    // FNV-1a over the raw value bytes
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < bytes; ++i) {
+        h = (h ^ data[i]) * 1099511628211ull;
+    }
+    key = h;
+    return true;
+}
+
+bool FieldNumber(CodecId id, const FieldDesc& field, const void* record, size_t size,
+                 double& value) {
+    const uint8_t* data = FieldData(id, field, record, size);
+    if (!data) return false;
+
+    switch (field.type) {
+        case FieldType::U8:    value = Read<uint8_t>(data, 0);  return true;
+        case FieldType::U16:   value = Read<uint16_t>(data, 0); return true;
+        case FieldType::U32:   value = Read<uint32_t>(data, 0); return true;
+        case FieldType::U64:   value = static_cast<double>(Read<uint64_t>(data, 0)); return true;
+        case FieldType::I32:   value = Read<int32_t>(data, 0);  return true;
+        case FieldType::F32:   value = Read<float>(data, 0);    return true;
+        case FieldType::Bool:  value = data[0] != 0 ? 1 : 0;    return true;
+        case FieldType::Chars: return false;
+    }
+    return false;
+}
+
+} // namespace EventCodecs
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "nlohmann/json.hpp"
+
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// Payload codecs for Nexus events whose aEventArgs we understand.
+//
+// On the firing thread a codec copies the argument struct (following any
+// pointers it contains) into a fixed-size binary record. On the render
+// thread the record is turned into JSON from a table of {field, offset,
+// type}, once per event occurrence. Events without a codec carry no payload
+// and are delivered with `data: null`.
+namespace EventCodecs {
+
+// Largest record any codec produces; fits the per-addon event queue slot.
+constexpr size_t MAX_RECORD_BYTES = 368;
+
+// Index into the codec table. 0 = no codec.
+using CodecId = uint8_t;
+constexpr CodecId NONE = 0;
+
+enum class FieldType : uint8_t {
+    U8, U16, U32, U64, I32, F32, Bool,
+    Chars, // fixed-size NUL-terminated char array of `size` bytes
+};
+
+struct FieldDesc {
+    const char* group;   // nested object name, or nullptr for top level
+    const char* name;
+    uint16_t    offset;
+    uint16_t    size;    // Chars only
+    FieldType   type;
+};
+
+// A group whose presence byte is zero is emitted as null.
+struct GroupDesc {
+    const char* name;
+    uint16_t    presentOffset;
+};
+
+// Copy `args` into `out` (at most MAX_RECORD_BYTES). Returns bytes written,
+// 0 if there is nothing to copy. Runs on the firing thread: no allocation,
+// no locks.
+using CaptureFn = uint16_t (*)(const void* args, void* out);
+
+struct Codec {
+    const char*      eventName;
+    CaptureFn        capture;
+    const FieldDesc* fields;
+    size_t           fieldCount;
+    const GroupDesc* groups;
+    size_t           groupCount;
+};
+
+// Codec for an event name, or NONE.
+CodecId Find(std::string_view eventName);
+
+// Codec by ID (nullptr for NONE / out of range).
+const Codec* Get(CodecId id);
+
+// Decode a captured record into JSON (render thread). `out` becomes null if
+// the record is empty.
+void ToJson(CodecId id, const void* record, size_t size, nlohmann::json& out);
+
+// Field of a codec by path: "name" for top-level fields, "group.name" for
+// grouped ones. nullptr if the codec has no such field.
+const FieldDesc* FindField(CodecId id, std::string_view path);
+
+// Hash of one field's value in a captured record, for coalescing records by
+// key without decoding them. Returns false if the field is outside the record
+// or its group is absent.
+bool FieldKey(CodecId id, const FieldDesc& field, const void* record, size_t size,
+              uint64_t& key);
+
+// Value of a numeric field in a captured record (aggregation). Returns false
+// for Chars fields, or if the field is outside the record or its group is
+// absent. No allocation; safe on the firing thread.
+bool FieldNumber(CodecId id, const FieldDesc& field, const void* record, size_t size,
+                 double& value);
+
+} // namespace EventCodecs
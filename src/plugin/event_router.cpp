@@ -0,0 +1,347 @@
+#include "event_router.h"
+#include "addon_instance.h"
+#include "name_intern.h"
+#include "event_codecs.h"
+#include "event_aggregator.h"
+#include "globals.h"
+#include "shared/version.h"
+
+#include <windows.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_M_X64) && !defined(__x86_64__)
+#error "EventRouter thunks are generated for x64 only"
+#endif
+
+namespace EventRouter {
+
+// ---- Routes ----
+// One per event name that has ever been subscribed. Routes and their thunks
+// are never freed, so a thunk never points at a freed route: Nexus may still
+// be inside a thunk, before Dispatch enters its read section, when the route
+// is unsubscribed. Shutdown only empties them; a later Subscribe reuses them.
+
+// An addon's event queue, or one of its aggregators.
+struct Subscriber {
+    AddonInstance*   addon;
+    EventAggregator* aggregator; // nullptr: queue for the addon's page
+
+    bool operator==(const Subscriber& other) const {
+        return addon == other.addon && aggregator == other.aggregator;
+    }
+};
+
+struct SubscriberList {
+    std::vector<Subscriber> entries;
+};
+
+struct Route {
+    NameIntern::Id                       name = NameIntern::INVALID;
+    std::string                          eventName;
+    std::atomic<const SubscriberList*>   subscribers{nullptr};
+    EventCodecs::CodecId                 codec = EventCodecs::NONE;
+    EVENT_CONSUME                        thunk = nullptr;
+    bool                                 nexusSubscribed = false;
+};
+
+static std::mutex                                                s_writeMutex;
+static std::unordered_map<NameIntern::Id, std::unique_ptr<Route>> s_routes;
+
+// ---- Reader sections / grace periods ----
+// Dispatchers enter a read section tagged with the current epoch parity.
+// Synchronize flips the epoch twice and waits for each parity's readers to
+// drain, after which no dispatcher can still see a list that was replaced
+// before the call. List publication, the reader counters and the list load
+// in Dispatch are all sequentially consistent: a dispatcher whose increment
+// the writer did not observe is guaranteed to load the new list.
+
+static std::atomic<uint32_t> s_epoch{0};
+static std::atomic<uint32_t> s_readers[2];
+
+ReadSection::ReadSection() {
+    parity = s_epoch.load() & 1;
+    s_readers[parity].fetch_add(1);
+}
+
+ReadSection::~ReadSection() {
+    s_readers[parity].fetch_sub(1, std::memory_order_release);
+}
+
+void Synchronize() {
+    for (int flip = 0; flip < 2; ++flip) {
+        uint32_t parity = s_epoch.fetch_add(1) & 1;
+        while (s_readers[parity].load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// ---- Dispatch (game threads) ----
+
+// Every fired event gets a sequence number; subscribers' copies share it so
+// the render thread can serialize the occurrence once for all of them.
+static std::atomic<uint64_t> s_eventSeq{1};
+
+static void Dispatch(void* aEventArgs, Route* route) {
+    ReadSection section;
+    const SubscriberList* list = route->subscribers.load();
+    if (!list) return;
+
+    // Capture the payload once, then copy the record into each queue
+    alignas(8) uint8_t record[EventCodecs::MAX_RECORD_BYTES];
+    uint16_t recordSize = 0;
+    if (const EventCodecs::Codec* codec = EventCodecs::Get(route->codec)) {
+        recordSize = codec->capture(aEventArgs, record);
+    }
+
+    uint64_t seq = s_eventSeq.fetch_add(1, std::memory_order_relaxed);
+    for (const Subscriber& sub : list->entries) {
+        if (sub.aggregator) {
+            sub.aggregator->Add(record, recordSize);
+        } else {
+            sub.addon->QueueEvent(route->name, seq, route->codec, record, recordSize);
+        }
+    }
+}
+
+// ---- Thunks ----
+// Nexus calls EVENT_CONSUME(void* aEventArgs) without a context pointer, so
+// each route gets a 16-byte stub that loads its Route* into the second
+// argument register and jumps to Dispatch:
+//
+//   mov rdx, [rip + context_i]     48 8B 15 <rel32>
+//   jmp [rip + dispatch]           FF 25 <rel32>
+//
+// Stubs live in an execute-only page; the contexts they read live in the
+// writable page right after it, so no page is ever writable and executable.
+//
+// Outside Windows (tools/host_sim) the second argument register is rsi:
+//   mov rsi, [rip + context_i]     48 8B 35 <rel32>
+
+static constexpr size_t THUNK_PAGE_BYTES = 4096;
+static constexpr size_t THUNK_BYTES      = 16;
+static constexpr size_t THUNKS_PER_PAGE  = THUNK_PAGE_BYTES / THUNK_BYTES;
+#ifdef _WIN32
+static constexpr uint8_t THUNK_ARG2_MODRM = 0x15;  // rdx
+#else
+static constexpr uint8_t THUNK_ARG2_MODRM = 0x35;  // rsi
+#endif
+
+struct ThunkPage {
+    uint8_t* code = nullptr;   // THUNK_PAGE_BYTES, PAGE_EXECUTE_READ
+    void**   data = nullptr;   // contexts[THUNKS_PER_PAGE] + dispatch target
+    size_t   used = 0;
+};
+
+static std::vector<ThunkPage> s_thunkPages;
+
+static void WriteRel32(uint8_t* at, const void* target, const uint8_t* nextInstruction) {
+    int32_t rel = static_cast<int32_t>(
+        reinterpret_cast<const uint8_t*>(target) - nextInstruction);
+    std::memcpy(at, &rel, sizeof(rel));
+}
+
+static bool CreateThunkPage() {
+    auto* base = static_cast<uint8_t*>(VirtualAlloc(
+        nullptr, THUNK_PAGE_BYTES * 2, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+    if (!base) return false;
+
+    ThunkPage page;
+    page.code = base;
+    page.data = reinterpret_cast<void**>(base + THUNK_PAGE_BYTES);
+    page.data[THUNKS_PER_PAGE] = reinterpret_cast<void*>(&Dispatch);
+
+    for (size_t i = 0; i < THUNKS_PER_PAGE; ++i) {
+        uint8_t* p = page.code + i * THUNK_BYTES;
+        p[0] = 0x48; p[1] = 0x8B; p[2] = THUNK_ARG2_MODRM;
+        WriteRel32(p + 3, &page.data[i], p + 7);
+        p[7] = 0xFF; p[8] = 0x25;
+        WriteRel32(p + 9, &page.data[THUNKS_PER_PAGE], p + 13);
+        p[13] = p[14] = p[15] = 0xCC;
+    }
+
+    DWORD oldProtect = 0;
+    if (!VirtualProtect(page.code, THUNK_PAGE_BYTES, PAGE_EXECUTE_READ, &oldProtect)) {
+        VirtualFree(base, 0, MEM_RELEASE);
+        return false;
+    }
+    FlushInstructionCache(GetCurrentProcess(), page.code, THUNK_PAGE_BYTES);
+
+    s_thunkPages.push_back(page);
+    return true;
+}
+
+static EVENT_CONSUME AllocateThunk(Route* route) {
+    if (s_thunkPages.empty() || s_thunkPages.back().used == THUNKS_PER_PAGE) {
+        if (!CreateThunkPage()) return nullptr;
+    }
+    ThunkPage& page = s_thunkPages.back();
+    size_t index = page.used++;
+    page.data[index] = route;
+    return reinterpret_cast<EVENT_CONSUME>(page.code + index * THUNK_BYTES);
+}
+
+// ---- Subscription management (render thread) ----
+
+static Route* GetOrCreateRoute(const std::string& eventName) {
+    NameIntern::Id id = NameIntern::Intern(eventName);
+    if (id == NameIntern::INVALID) return nullptr;
+
+    auto it = s_routes.find(id);
+    if (it != s_routes.end()) return it->second.get();
+
+    auto route = std::make_unique<Route>();
+    route->name = id;
+    route->eventName = eventName;
+    route->codec = EventCodecs::Find(eventName);
+    route->thunk = AllocateThunk(route.get());
+    if (!route->thunk) return nullptr;
+
+    Route* raw = route.get();
+    s_routes[id] = std::move(route);
+    return raw;
+}
+
+template <typename Pred>
+static bool ContainsIf(const SubscriberList* list, Pred pred) {
+    if (!list) return false;
+    for (const Subscriber& sub : list->entries) {
+        if (pred(sub)) return true;
+    }
+    return false;
+}
+
+// Publish a copy of the route's list without the entries matching `pred`.
+// Returns the replaced list for the caller to free after Synchronize.
+template <typename Pred>
+static const SubscriberList* RemoveSubscribers(Route* route, Pred pred) {
+    const SubscriberList* old = route->subscribers.load(std::memory_order_relaxed);
+    if (!ContainsIf(old, pred)) return nullptr;
+
+    auto* updated = new SubscriberList();
+    for (const Subscriber& sub : old->entries) {
+        if (!pred(sub)) updated->entries.push_back(sub);
+    }
+    if (updated->entries.empty()) {
+        delete updated;
+        updated = nullptr;
+    }
+    route->subscribers.store(updated);
+
+    if (!updated && route->nexusSubscribed) {
+        if (Globals::API) Globals::API->Events_Unsubscribe(route->eventName.c_str(), route->thunk);
+        route->nexusSubscribed = false;
+    }
+    return old;
+}
+
+// Publish a copy of the route's list with `entry` added and make sure the
+// route has its Nexus subscription. Returns the replaced list, if any.
+static const SubscriberList* AddSubscriber(Route* route, const Subscriber& entry) {
+    const SubscriberList* old = route->subscribers.load(std::memory_order_relaxed);
+    if (ContainsIf(old, [&](const Subscriber& s) { return s == entry; })) return nullptr;
+
+    auto* updated = new SubscriberList();
+    if (old) updated->entries = old->entries;
+    updated->entries.push_back(entry);
+    route->subscribers.store(updated);
+
+    if (!route->nexusSubscribed) {
+        Globals::API->Events_Subscribe(route->eventName.c_str(), route->thunk);
+        route->nexusSubscribed = true;
+    }
+    return old;
+}
+
+static bool Add(const std::string& eventName, const Subscriber& entry) {
+    if (!entry.addon || !Globals::API) return false;
+    std::lock_guard<std::mutex> lock(s_writeMutex);
+
+    Route* route = GetOrCreateRoute(eventName);
+    if (!route) {
+        Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+            ("Could not create event route for: " + eventName).c_str());
+        return false;
+    }
+
+    if (const SubscriberList* old = AddSubscriber(route, entry)) {
+        Synchronize();
+        delete old;
+    }
+    return true;
+}
+
+template <typename Pred>
+static void Remove(const std::string& eventName, Pred pred) {
+    std::lock_guard<std::mutex> lock(s_writeMutex);
+
+    NameIntern::Id id = NameIntern::Find(eventName);
+    auto it = s_routes.find(id);
+    if (it == s_routes.end()) return;
+
+    if (const SubscriberList* old = RemoveSubscribers(it->second.get(), pred)) {
+        Synchronize();
+        delete old;
+    }
+}
+
+bool Subscribe(AddonInstance* addon, const std::string& eventName) {
+    return Add(eventName, Subscriber{addon, nullptr});
+}
+
+void Unsubscribe(AddonInstance* addon, const std::string& eventName) {
+    Remove(eventName, [&](const Subscriber& s) { return s.addon == addon && !s.aggregator; });
+}
+
+bool AddAggregator(AddonInstance* addon, EventAggregator* aggregator) {
+    if (!aggregator) return false;
+    return Add(aggregator->GetEventName(), Subscriber{addon, aggregator});
+}
+
+void RemoveAggregator(EventAggregator* aggregator) {
+    if (!aggregator) return;
+    Remove(aggregator->GetEventName(), [&](const Subscriber& s) { return s.aggregator == aggregator; });
+}
+
+void UnsubscribeAll(AddonInstance* addon) {
+    std::lock_guard<std::mutex> lock(s_writeMutex);
+
+    std::vector<const SubscriberList*> retired;
+    for (auto& [id, route] : s_routes) {
+        if (const SubscriberList* old = RemoveSubscribers(route.get(),
+                [&](const Subscriber& s) { return s.addon == addon; })) {
+            retired.push_back(old);
+        }
+    }
+    if (retired.empty()) return;
+
+    Synchronize();
+    for (const SubscriberList* old : retired) delete old;
+}
+
+void Shutdown() {
+    std::lock_guard<std::mutex> lock(s_writeMutex);
+
+    std::vector<const SubscriberList*> retired;
+    for (auto& [id, route] : s_routes) {
+        if (route->nexusSubscribed && Globals::API) {
+            Globals::API->Events_Unsubscribe(route->eventName.c_str(), route->thunk);
+        }
+        route->nexusSubscribed = false;
+        if (const SubscriberList* old = route->subscribers.exchange(nullptr)) {
+            retired.push_back(old);
+        }
+    }
+
+    Synchronize();
+    for (const SubscriberList* old : retired) delete old;
+}
+
+} // namespace EventRouter
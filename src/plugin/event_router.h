@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class AddonInstance;
+class EventAggregator;
+
+// Shared Nexus event subscriptions with native fan-out.
+//
+// Each unique event name gets exactly one Nexus subscription, however many
+// addons listen to it. Nexus needs a plain function pointer per subscription,
+// so every route gets a small generated thunk that forwards to a common
+// dispatcher with the route as context; there is no fixed slot table.
+//
+// The firing thread walks an immutable subscriber list and pushes into each
+// addon's queue (or feeds an addon's aggregators) by pointer: no locks, no
+// string work. Subscriber lists are replaced copy-on-write on the render
+// thread, and a replaced list is freed only after every dispatcher that could
+// still be reading it has left (see Synchronize in event_router.cpp).
+namespace EventRouter {
+
+// Add/remove an addon as a subscriber of `eventName`. Render thread only.
+// Subscribe returns false if the route could not be created.
+bool Subscribe(AddonInstance* addon, const std::string& eventName);
+void Unsubscribe(AddonInstance* addon, const std::string& eventName);
+
+// Feed an aggregator owned by `addon` with every occurrence of its event,
+// instead of queueing them. After RemoveAggregator returns no game thread
+// references the aggregator. Render thread only.
+bool AddAggregator(AddonInstance* addon, EventAggregator* aggregator);
+void RemoveAggregator(EventAggregator* aggregator);
+
+// Remove an addon (and its aggregators) from every route. When this returns, no game thread holds
+// a reference to the addon. Render thread only.
+void UnsubscribeAll(AddonInstance* addon);
+
+// Drop all Nexus subscriptions and subscribers (addon unload). Routes and
+// their thunk pages stay mapped: a callback Nexus has already entered may
+// still run through them.
+void Shutdown();
+
+// Read section for game-thread callbacks that dereference render-thread
+// state, as the event dispatcher does. Once Synchronize returns, every
+// section entered before the call has left. Synchronize: render thread only.
+struct ReadSection {
+    ReadSection();
+    ~ReadSection();
+    ReadSection(const ReadSection&) = delete;
+    ReadSection& operator=(const ReadSection&) = delete;
+
+    uint32_t parity;
+};
+void Synchronize();
+
+} // namespace EventRouter
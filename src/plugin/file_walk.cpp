@@ -0,0 +1,38 @@
+#include "file_walk.h"
+#include "asset_cache.h"
+
+namespace FileWalk {
+
+void ForEach(const std::string& basePath, const std::function<bool(Entry& entry)>& visit) {
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    fs::path root(basePath);
+    fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        const fs::directory_entry& dirEntry = *it;
+        std::error_code entryEc;
+        if (!dirEntry.is_regular_file(entryEc)) continue;
+
+        Entry entry;
+        entry.size = dirEntry.file_size(entryEc);
+        if (entryEc) continue;
+        entry.mtime = static_cast<int64_t>(
+            dirEntry.last_write_time(entryEc).time_since_epoch().count());
+        if (entryEc) continue;
+
+        try {
+            // Keys are UTF-8, like decoded request paths
+            std::u8string utf8 = dirEntry.path().lexically_relative(root).generic_u8string();
+            entry.key = AssetCache::NormalizePath(
+                std::string(reinterpret_cast<const char*>(utf8.data()), utf8.size()));
+        } catch (...) {
+            continue;  // not valid UTF-16
+        }
+        entry.path = dirEntry.path();
+
+        if (!visit(entry)) break;
+    }
+}
+
+} // namespace FileWalk
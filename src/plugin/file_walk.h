@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+// Recursive listing of the regular files under an addon's directory, keyed
+// the way the scheme handler looks them up. Shared by the file index and the
+// preloader so both see the same set of files under the same keys.
+namespace FileWalk {
+
+struct Entry {
+    std::string           key;    // AssetCache::NormalizePath of the relative path (UTF-8)
+    std::filesystem::path path;   // absolute; open it as a path, names may be outside the ANSI code page
+    uint64_t              size = 0;
+    int64_t               mtime = 0; // last write time (file_time_type ticks)
+};
+
+// Call `visit` for every regular file under `basePath`, in directory order.
+// Sizes and write times come from the enumeration, so there is no per-file
+// stat. Entries that cannot be read are skipped. Stops when `visit` returns
+// false.
+void ForEach(const std::string& basePath, const std::function<bool(Entry& entry)>& visit);
+
+} // namespace FileWalk
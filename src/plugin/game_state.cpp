@@ -0,0 +1,292 @@
+#include "game_state.h"
+#include "mumble_link.h"
+#include "addon_manager.h"
+#include "addon_instance.h"
+#include "in_process_browser.h"
+#include "js_dispatch.h"
+#include "globals.h"
+
+#include <windows.h>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace GameState {
+
+// ---- Field table ----
+
+enum class Kind : uint8_t { U32, F32, Vec3, WStr, Bool };
+
+struct Field {
+    Source      source;
+    const char* name;
+    uint16_t    offset;
+    uint16_t    bytes;
+    Kind        kind;
+};
+
+#define MUMBLE(member, jsonName, kind) \
+    { Source::Mumble, jsonName, offsetof(LinkedMem, member), sizeof(LinkedMem::member), Kind::kind }
+#define NEXUS(member, jsonName, kind) \
+    { Source::Nexus, jsonName, offsetof(NexusLinkData_t, member), sizeof(NexusLinkData_t::member), Kind::kind }
+
+static const Field s_fields[] = {
+    MUMBLE(uiVersion,       "uiVersion",      U32),
+    MUMBLE(uiTick,          "uiTick",         U32),
+    MUMBLE(fAvatarPosition, "avatarPosition", Vec3),
+    MUMBLE(fAvatarFront,    "avatarFront",    Vec3),
+    MUMBLE(fAvatarTop,      "avatarTop",      Vec3),
+    MUMBLE(name,            "name",           WStr),
+    MUMBLE(fCameraPosition, "cameraPosition", Vec3),
+    MUMBLE(fCameraFront,    "cameraFront",    Vec3),
+    MUMBLE(fCameraTop,      "cameraTop",      Vec3),
+    MUMBLE(identity,        "identity",       WStr),
+    MUMBLE(context_len,     "contextLen",     U32),
+    NEXUS(Width,            "width",          U32),
+    NEXUS(Height,           "height",         U32),
+    NEXUS(Scaling,          "scaling",        F32),
+    NEXUS(IsMoving,         "isMoving",       Bool),
+    NEXUS(IsCameraMoving,   "isCameraMoving", Bool),
+    NEXUS(IsGameplay,       "isGameplay",     Bool),
+};
+
+#undef NEXUS
+#undef MUMBLE
+
+static constexpr size_t FIELD_COUNT = sizeof(s_fields) / sizeof(s_fields[0]);
+static constexpr size_t SOURCE_COUNT = 2;
+
+// ---- Sampled state ----
+// Frames are numbered from 1; a subscriber whose last update was frame 0
+// has not received anything yet and gets a full snapshot.
+
+struct SourceState {
+    const char*          name;      // key in the JS message
+    const char*          dataLink;  // DataLink_Get identifier
+    size_t               size;
+    bool                 available = false;
+    uint64_t             availabilityFrame = 0;
+    std::vector<uint8_t> raw;       // bytes of the last sample
+};
+
+static SourceState s_sources[SOURCE_COUNT] = {
+    { "mumble", DL_MUMBLE_LINK, sizeof(LinkedMem) },
+    { "nexus",  DL_NEXUS_LINK,  sizeof(NexusLinkData_t) },
+};
+
+static json     s_fieldValue[FIELD_COUNT];
+static uint64_t s_fieldFrame[FIELD_COUNT];  // frame the field last changed
+static uint64_t s_frame = 1;
+static uint64_t s_sampledFrame = 0;
+static uint64_t s_lastChangeFrame = 0;
+
+// Convert wchar_t string to UTF-8 std::string (Windows WideCharToMultiByte)
+static std::string WcharToUtf8(const wchar_t* wstr, size_t maxLen) {
+    size_t len = 0;
+    while (len < maxLen && wstr[len] != L'\0') ++len;
+    if (len == 0) return "";
+    int size = WideCharToMultiByte(CP_UTF8, 0, wstr, static_cast<int>(len), nullptr, 0, nullptr, nullptr);
+    if (size <= 0) return "";
+    std::string result(size, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, wstr, static_cast<int>(len), &result[0], size, nullptr, nullptr);
+    return result;
+}
+
+template <typename T>
+static T Read(const uint8_t* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+static json Decode(const Field& f, const uint8_t* p) {
+    switch (f.kind) {
+        case Kind::U32:  return Read<uint32_t>(p);
+        case Kind::F32:  return Read<float>(p);
+        case Kind::Bool: return p[0] != 0;
+        case Kind::Vec3: return { Read<float>(p), Read<float>(p + 4), Read<float>(p + 8) };
+        case Kind::WStr: {
+            wchar_t buf[256];
+            size_t count = f.bytes / sizeof(wchar_t);
+            std::memcpy(buf, p, count * sizeof(wchar_t));
+            return WcharToUtf8(buf, count);
+        }
+    }
+    return nullptr;
+}
+
+// Compare each field against the last sample and re-decode only the ones
+// whose bytes changed.
+static void Sample() {
+    s_sampledFrame = s_frame;
+
+    for (size_t s = 0; s < SOURCE_COUNT; ++s) {
+        SourceState& src = s_sources[s];
+        const auto* live = Globals::API
+            ? static_cast<const uint8_t*>(Globals::API->DataLink_Get(src.dataLink))
+            : nullptr;
+
+        bool refresh = false;
+        if ((live != nullptr) != src.available) {
+            src.available = live != nullptr;
+            src.availabilityFrame = s_frame;
+            s_lastChangeFrame = s_frame;
+            refresh = src.available;
+        }
+        if (!live) continue;
+        if (src.raw.size() != src.size) src.raw.assign(src.size, 0);
+
+        for (size_t i = 0; i < FIELD_COUNT; ++i) {
+            const Field& f = s_fields[i];
+            if (static_cast<size_t>(f.source) != s) continue;
+
+            uint8_t* prev = src.raw.data() + f.offset;
+            if (!refresh && std::memcmp(prev, live + f.offset, f.bytes) == 0) continue;
+
+            std::memcpy(prev, live + f.offset, f.bytes);
+            s_fieldValue[i] = Decode(f, prev);
+            s_fieldFrame[i] = s_frame;
+            s_lastChangeFrame = s_frame;
+        }
+    }
+}
+
+bool Get(Source source, json& out) {
+    if (s_sampledFrame != s_frame) Sample();
+
+    const SourceState& src = s_sources[static_cast<size_t>(source)];
+    if (!src.available) return false;
+
+    out = json::object();
+    for (size_t i = 0; i < FIELD_COUNT; ++i) {
+        if (s_fields[i].source == source) out[s_fields[i].name] = s_fieldValue[i];
+    }
+    return true;
+}
+
+// ---- Subscribers ----
+
+struct Subscriber {
+    std::string addonId;
+    std::string windowId;
+    DWORD       intervalMs = 0;
+    DWORD       lastSentTick = 0;
+    uint64_t    lastSentFrame = 0;
+};
+
+static std::vector<Subscriber> s_subscribers;
+
+void Subscribe(const std::string& addonId, const std::string& windowId, uint32_t hz) {
+    Subscriber* sub = nullptr;
+    for (Subscriber& s : s_subscribers) {
+        if (s.addonId == addonId && s.windowId == windowId) sub = &s;
+    }
+    if (!sub) {
+        s_subscribers.push_back({ addonId, windowId });
+        sub = &s_subscribers.back();
+    }
+    sub->intervalMs = hz ? 1000 / hz : 0;
+    sub->lastSentFrame = 0;
+}
+
+void Unsubscribe(const std::string& addonId, const std::string& windowId) {
+    std::erase_if(s_subscribers, [&](const Subscriber& s) {
+        return s.addonId == addonId && s.windowId == windowId;
+    });
+}
+
+void UnsubscribeAddon(const std::string& addonId) {
+    std::erase_if(s_subscribers, [&](const Subscriber& s) { return s.addonId == addonId; });
+}
+
+// The fields that changed after frame `since` (everything when since is 0).
+// A source that went away is sent as null.
+static json BuildDelta(uint64_t since) {
+    json message;
+    message["type"] = "gamestate";
+    message["full"] = since == 0;
+
+    for (size_t s = 0; s < SOURCE_COUNT; ++s) {
+        const SourceState& src = s_sources[s];
+        bool all = since == 0 || src.availabilityFrame > since;
+        if (!src.available) {
+            if (all) message[src.name] = nullptr;
+            continue;
+        }
+
+        json fields = json::object();
+        for (size_t i = 0; i < FIELD_COUNT; ++i) {
+            if (static_cast<size_t>(s_fields[i].source) != s) continue;
+            if (all || s_fieldFrame[i] > since) fields[s_fields[i].name] = s_fieldValue[i];
+        }
+        if (all || !fields.empty()) message[src.name] = std::move(fields);
+    }
+    return message;
+}
+
+static InProcessBrowser* ResolveBrowser(const Subscriber& sub) {
+    AddonInstance* addon = AddonManager::GetAddon(sub.addonId);
+    if (!addon) return nullptr;
+    WindowInfo* window = addon->GetWindow(sub.windowId);
+    return window ? window->browser.get() : nullptr;
+}
+
+void Tick() {
+    if (!s_subscribers.empty()) {
+        Sample();
+
+        // Subscribers last updated at the same frame get the same delta;
+        // build it once and share its encodings. The shared-payload cache is
+        // dropped at the end of this frame, so the frame a delta starts
+        // after identifies it.
+        DWORD now = GetTickCount();
+        for (auto it = s_subscribers.begin(); it != s_subscribers.end();) {
+            InProcessBrowser* browser = ResolveBrowser(*it);
+            if (!browser) {
+                it = s_subscribers.erase(it); // window closed
+                continue;
+            }
+
+            Subscriber& sub = *it++;
+            if (!browser->IsReady()) continue;
+            if (sub.lastSentFrame != 0) {
+                if (s_lastChangeFrame <= sub.lastSentFrame) continue;
+                if (now - sub.lastSentTick < sub.intervalMs) continue;
+            }
+
+            JsDispatch::SharedPayloadRef delta =
+                JsDispatch::FindShared(JsDispatch::PayloadSource::GameState, sub.lastSentFrame);
+            if (!delta) {
+                delta = JsDispatch::AddShared(JsDispatch::PayloadSource::GameState, sub.lastSentFrame,
+                                              BuildDelta(sub.lastSentFrame));
+            }
+            JsDispatch::SendShared(browser, *delta);
+
+            sub.lastSentFrame = s_frame;
+            sub.lastSentTick = now;
+        }
+    }
+
+    // Anything sampled from here on (async getters) belongs to the next frame
+    ++s_frame;
+}
+
+void Shutdown() {
+    s_subscribers.clear();
+    for (SourceState& src : s_sources) {
+        src.available = false;
+        src.availabilityFrame = 0;
+        src.raw.clear();
+    }
+    for (size_t i = 0; i < FIELD_COUNT; ++i) {
+        s_fieldValue[i] = nullptr;
+        s_fieldFrame[i] = 0;
+    }
+    s_sampledFrame = 0;
+    s_lastChangeFrame = 0;
+}
+
+} // namespace GameState
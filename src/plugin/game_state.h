@@ -0,0 +1,42 @@
+#pragma once
+
+#include "nlohmann/json.hpp"
+
+#include <string>
+#include <cstdint>
+
+// Shared game-state channel for MumbleLink and NexusLink.
+//
+// The DataLink blocks are sampled at most once per frame, field by field:
+// a field's JSON fragment is rebuilt only when its raw bytes changed (so the
+// wide-string conversions of `name`/`identity` run only when those change).
+// Subscribed pages receive a delta of the fields that changed since their
+// last update, at their own rate, and keep a mirror in JS that reads
+// synchronously. Pages whose updates cover the same frames share one
+// serialized message. The async datalink getters read the same sample.
+//
+// Render thread only.
+namespace GameState {
+
+enum class Source : uint8_t { Mumble, Nexus };
+
+// Advance one frame and push due deltas to subscribers. Called once per
+// frame from AddonManager::FlushAllPendingEvents.
+void Tick();
+
+// Start (or change the rate of) updates for a page. hz 0 = every frame.
+// The next update is a full snapshot.
+void Subscribe(const std::string& addonId, const std::string& windowId, uint32_t hz);
+void Unsubscribe(const std::string& addonId, const std::string& windowId);
+
+// Drop every subscription of an addon (addon unload).
+void UnsubscribeAddon(const std::string& addonId);
+
+// Current state of a source as a JSON object, sampled at most once per frame.
+// Returns false if the DataLink is not available.
+bool Get(Source source, nlohmann::json& out);
+
+// Drop all subscriptions and cached state.
+void Shutdown();
+
+} // namespace GameState
@@ -280,9 +280,8 @@ bool InProcessBrowser::OnConsoleMessage(CefRefPtr<CefBrowser> /*browser*/,
     // Check for bridge message prefix
     if (msg.size() > NEXUS_PREFIX_LEN &&
         msg.compare(0, NEXUS_PREFIX_LEN, NEXUS_PREFIX) == 0) {
-        // Strip prefix and dispatch JSON to IpcHandler
-        std::string json = msg.substr(NEXUS_PREFIX_LEN);
-        IpcHandler::HandleBridgeMessage(json, this);
+        // Hand the JSON after the prefix to IpcHandler (bridge worker)
+        IpcHandler::HandleBridgeMessage(std::move(msg), NEXUS_PREFIX_LEN, this);
         return true; // Suppress from CEF console output
     }
 
@@ -306,6 +305,12 @@ void InProcessBrowser::OnLoadStart(CefRefPtr<CefBrowser> /*browser*/,
                                     CefRefPtr<CefFrame> frame,
                                     TransitionType /*transition_type*/) {
     if (frame->IsMain()) {
+        std::string origin = "https://" + m_addonId + ".jsloader.local/";
+        m_onAddonOrigin = !m_addonId.empty() &&
+            frame->GetURL().ToString().compare(0, origin.size(), origin) == 0;
+        m_bridgeEncoding = JsDispatch::Encoding::Json;
+        ++m_loadCount;
+
         // Inject bridge early so inline <script> tags can access window.nexus.
         // OnLoadStart fires after the new V8 context is created but before
         // the page's HTML is parsed, so the bridge is available to all scripts.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "d3d11_texture.h"
+#include "js_dispatch.h"
 
 #include "include/cef_client.h"
 #include "include/cef_render_handler.h"
@@ -76,6 +77,19 @@ public:
     const std::string& GetAddonId() const { return m_addonId; }
     const std::string& GetWindowId() const { return m_windowId; }
 
+    // Whether the main frame is currently showing a page served from this
+    // addon's own origin (https://<addon-id>.jsloader.local/).
+    bool IsOnAddonOrigin() const { return m_onAddonOrigin; }
+
+    // Native->JS payload encoding negotiated by the current page. Reset to
+    // JSON whenever the main frame starts loading a new document.
+    JsDispatch::Encoding GetBridgeEncoding() const { return m_bridgeEncoding; }
+    void SetBridgeEncoding(JsDispatch::Encoding encoding) { m_bridgeEncoding = encoding; }
+
+    // Number of documents the main frame has started loading. Changes when
+    // the page is reloaded or navigates, so per-page state can be reset.
+    uint32_t GetLoadCount() const { return m_loadCount; }
+
     // CefClient
     CefRefPtr<CefRenderHandler> GetRenderHandler() override { return this; }
     CefRefPtr<CefDisplayHandler> GetDisplayHandler() override { return this; }
@@ -131,6 +145,9 @@ private:
     // Addon/window identity
     std::string m_addonId;
     std::string m_windowId;
+    bool        m_onAddonOrigin = false;
+    uint32_t    m_loadCount = 0;
+    JsDispatch::Encoding m_bridgeEncoding = JsDispatch::Encoding::Json;
 
     // Build the preamble + bridge script for injection
     std::string BuildBridgeScript() const;
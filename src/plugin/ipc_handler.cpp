@@ -2,12 +2,24 @@
 #include "in_process_browser.h"
 #include "addon_manager.h"
 #include "addon_instance.h"
+#include "js_dispatch.h"
+#include "bridge_api.h"
+#include "game_state.h"
+#include "worker_pool.h"
+#include "bridge_scheduler.h"
+#include "ipc_stats.h"
 #include "globals.h"
 #include "shared/version.h"
 
 #include "nlohmann/json.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <mutex>
 #include <unordered_map>
@@ -15,325 +27,341 @@
 
 using json = nlohmann::json;
 
-// Standard MumbleLink struct (Mumble positional audio protocol).
-// Nexus maps this via DataLink_Get(DL_MUMBLE_LINK).
-struct LinkedMem {
-    uint32_t uiVersion;
-    uint32_t uiTick;
-    float    fAvatarPosition[3];
-    float    fAvatarFront[3];
-    float    fAvatarTop[3];
-    wchar_t  name[256];
-    float    fCameraPosition[3];
-    float    fCameraFront[3];
-    float    fCameraTop[3];
-    wchar_t  identity[256];
-    uint32_t context_len;
-    unsigned char context[256];
-    wchar_t  description[2048];
+namespace IpcHandler {
+
+using namespace BridgeApi;
+
+// Per-message routing state shared by every handler. Worker handlers get no
+// addon (addon state belongs to the render thread).
+struct BridgeContext {
+    int                    requestId = 0;
+    AddonInstance*         addon     = nullptr;
+    InProcessBrowser*      browser   = nullptr;
+    bool                   onWorker  = false;
+    IpcStats::ActionStats* stats     = nullptr;  // the sending addon's, for this action
 };
 
-// Convert wchar_t string to UTF-8 std::string (Windows WideCharToMultiByte)
-static std::string WcharToUtf8(const wchar_t* wstr, size_t maxLen) {
-    size_t len = 0;
-    while (len < maxLen && wstr[len] != L'\0') ++len;
-    if (len == 0) return "";
-    int size = WideCharToMultiByte(CP_UTF8, 0, wstr, static_cast<int>(len), nullptr, 0, nullptr, nullptr);
-    if (size <= 0) return "";
-    std::string result(size, '\0');
-    WideCharToMultiByte(CP_UTF8, 0, wstr, static_cast<int>(len), &result[0], size, nullptr, nullptr);
-    return result;
+// ---- Helper: send async response to JS via JsDispatch ----
+
+// From a worker, the response is posted to the render thread's next batch.
+static void SendAsyncResponse(const BridgeContext& ctx, bool success, const json& value) {
+    if (!ctx.onWorker) {
+        size_t bytes = JsDispatch::SendResponse(ctx.browser, ctx.requestId, success, value);
+        if (ctx.stats) ctx.stats->RecordResponse(bytes);
+        return;
+    }
+    RenderBatch::Post([browser = CefRefPtr<InProcessBrowser>(ctx.browser),
+                       requestId = ctx.requestId, stats = ctx.stats, success, value]() {
+        size_t bytes = JsDispatch::SendResponse(browser.get(), requestId, success, value);
+        if (stats) stats->RecordResponse(bytes);
+    });
 }
 
-namespace IpcHandler {
+// ---- JSON message handlers ----
+// One Handle<Id> per action in NEXUS_BRIDGE_ACTIONS (bridge_api.h). Parameters
+// arrive already decoded; string parameters are never null.
 
-// ---- Helper: send async response to JS via ExecuteJavaScript ----
+static bool HandleLog(const LogParams& p, const BridgeContext&) {
+    if (Globals::API) {
+        Globals::API->Log(static_cast<ELogLevel>(p.level), p.channel, p.message);
+    }
+    return true;
+}
 
-static void SendAsyncResponse(InProcessBrowser* browser, int requestId,
-                               bool success, const std::string& value) {
-    if (!browser) return;
+static bool HandleAlert(const AlertParams& p, const BridgeContext&) {
+    if (Globals::API) {
+        Globals::API->GUI_SendAlert(p.message);
+    }
+    return true;
+}
 
-    json j;
-    j["type"] = "response";
-    j["requestId"] = requestId;
-    j["success"] = success;
+static bool HandleEventsSubscribe(const EventsSubscribeParams& p, const BridgeContext& ctx) {
+    if (!*p.name || !ctx.addon) return true;
 
-    try {
-        j["value"] = json::parse(value);
-    } catch (...) {
-        j["value"] = value;
+    EventPolicyConfig config;
+    if (!ParseEventPolicy(p.policy, config.policy) && Globals::API) {
+        Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+            (std::string("Unknown event policy '") + p.policy + "' for " + p.name +
+             "; delivering all occurrences").c_str());
     }
+    config.max = static_cast<uint32_t>(std::max(p.max, 0));
+    config.key = p.key;
+    config.hz = static_cast<uint32_t>(std::max(p.hz, 0));
+    ctx.addon->SubscribeEvent(p.name, config);
+    return true;
+}
 
-    std::string code = "window.__nexus_dispatch(" + j.dump() + ");";
-    browser->ExecuteJavaScript(code);
+static bool HandleEventsUnsubscribe(const EventsUnsubscribeParams& p, const BridgeContext& ctx) {
+    if (*p.name && ctx.addon) {
+        ctx.addon->UnsubscribeEvent(p.name);
+    }
+    return true;
 }
 
-// ---- JSON message handlers ----
+static bool HandleEventsRaise(const EventsRaiseParams& p, const BridgeContext&) {
+    if (*p.name && Globals::API) {
+        Globals::API->Events_RaiseNotification(p.name);
+    }
+    return true;
+}
 
-static bool HandleLog(const json& msg) {
-    int level = msg.value("level", 3);
-    std::string channel = msg.value("channel", "");
-    std::string text = msg.value("message", "");
+static bool HandleEventsGetStats(const EventsGetStatsParams&, const BridgeContext& ctx) {
+    if (!ctx.addon) {
+        SendAsyncResponse(ctx, false, "Addon not found");
+        return true;
+    }
 
-    if (Globals::API) {
-        Globals::API->Log(static_cast<ELogLevel>(level), channel.c_str(), text.c_str());
+    json events = json::object();
+    for (const auto& [id, sub] : ctx.addon->GetEventSubscriptions()) {
+        json e;
+        e["policy"] = EventPolicyName(sub.config.policy);
+        e["delivered"] = sub.delivered;
+        e["dropped"] = sub.dropped;
+        e["coalesced"] = sub.coalesced;
+        events[sub.eventName] = std::move(e);
     }
+
+    json stats;
+    stats["events"] = std::move(events);
+    stats["queueOverflow"] = {
+        {"events", ctx.addon->GetDroppedEvents()},
+        {"keybinds", ctx.addon->GetDroppedKeybinds()}
+    };
+    stats["coalescedKeybinds"] = ctx.addon->GetCoalescedKeybinds();
+
+    const JsDispatch::SharedStats& shared = JsDispatch::GetSharedStats();
+    stats["sharedPayloads"] = {
+        {"lookups", shared.lookups},
+        {"hits", shared.hits},
+        {"sends", shared.sends},
+        {"reusedSends", shared.reusedSends},
+        {"bytesSaved", shared.bytesSaved}
+    };
+
+    SendAsyncResponse(ctx, true, stats);
     return true;
 }
 
-static bool HandleAlert(const json& msg) {
-    std::string text = msg.value("message", "");
-    if (Globals::API) {
-        Globals::API->GUI_SendAlert(text.c_str());
+static bool HandleEventsAggregate(const EventsAggregateParams& p, const BridgeContext& ctx) {
+    if (!*p.id || !*p.name || !ctx.addon) return true;
+
+    AggregateOp op;
+    if (!ParseAggregateOp(p.op, op)) {
+        if (Globals::API) {
+            Globals::API->Log(LOGL_WARNING, ADDON_NAME,
+                (std::string("Unknown aggregate op '") + p.op + "' for " + p.name).c_str());
+        }
+        return true;
     }
+    ctx.addon->AddAggregator(p.id, p.name, op, p.field,
+                             static_cast<uint32_t>(std::max(p.windowMs, 0)),
+                             static_cast<uint32_t>(std::max(p.emitHz, 0)));
     return true;
 }
 
-static bool HandleEventsSubscribe(const json& msg, AddonInstance* addon) {
-    std::string eventName = msg.value("name", "");
-    if (!eventName.empty() && addon) {
-        addon->SubscribeEvent(eventName);
+static bool HandleEventsStopAggregate(const EventsStopAggregateParams& p, const BridgeContext& ctx) {
+    if (*p.id && ctx.addon) {
+        ctx.addon->RemoveAggregator(p.id);
     }
     return true;
 }
 
-static bool HandleEventsUnsubscribe(const json& msg, AddonInstance* addon) {
-    std::string eventName = msg.value("name", "");
-    if (!eventName.empty() && addon) {
-        addon->UnsubscribeEvent(eventName);
+static bool HandleKeybindsRegister(const KeybindsRegisterParams& p, const BridgeContext& ctx) {
+    if (*p.id && ctx.addon) {
+        ctx.addon->RegisterKeybind(p.id, p.defaultBind);
     }
     return true;
 }
 
-static bool HandleEventsRaise(const json& msg) {
-    std::string eventName = msg.value("name", "");
-    if (!eventName.empty() && Globals::API) {
-        Globals::API->Events_RaiseNotification(eventName.c_str());
+static bool HandleKeybindsDeregister(const KeybindsDeregisterParams& p, const BridgeContext& ctx) {
+    if (*p.id && ctx.addon) {
+        ctx.addon->DeregisterKeybind(p.id);
     }
     return true;
 }
 
-static bool HandleKeybindsRegister(const json& msg, AddonInstance* addon) {
-    std::string identifier = msg.value("id", "");
-    std::string defaultBind = msg.value("defaultBind", "");
-    if (!identifier.empty() && addon) {
-        addon->RegisterKeybind(identifier, defaultBind);
+static bool HandleGameBindsPress(const GameBindsPressParams& p, const BridgeContext&) {
+    if (Globals::API) {
+        Globals::API->GameBinds_PressAsync(static_cast<EGameBinds>(p.bind));
     }
     return true;
 }
 
-static bool HandleKeybindsDeregister(const json& msg, AddonInstance* addon) {
-    std::string identifier = msg.value("id", "");
-    if (!identifier.empty() && addon) {
-        addon->DeregisterKeybind(identifier);
+static bool HandleGameBindsRelease(const GameBindsReleaseParams& p, const BridgeContext&) {
+    if (Globals::API) {
+        Globals::API->GameBinds_ReleaseAsync(static_cast<EGameBinds>(p.bind));
     }
     return true;
 }
 
-static bool HandleGameBinds(const json& msg, const std::string& action,
-                             InProcessBrowser* browser) {
-    int bind = msg.value("bind", 0);
+static bool HandleGameBindsInvoke(const GameBindsInvokeParams& p, const BridgeContext&) {
+    if (Globals::API) {
+        Globals::API->GameBinds_InvokeAsync(static_cast<EGameBinds>(p.bind), p.durationMs);
+    }
+    return true;
+}
 
+static bool HandleGameBindsIsBound(const GameBindsIsBoundParams& p, const BridgeContext& ctx) {
     if (!Globals::API) return true;
+    bool result = Globals::API->GameBinds_IsBound(static_cast<EGameBinds>(p.bind));
+    SendAsyncResponse(ctx, true, result);
+    return true;
+}
 
-    if (action == "gamebinds_press") {
-        Globals::API->GameBinds_PressAsync(static_cast<EGameBinds>(bind));
-    } else if (action == "gamebinds_release") {
-        Globals::API->GameBinds_ReleaseAsync(static_cast<EGameBinds>(bind));
-    } else if (action == "gamebinds_invoke") {
-        int duration = msg.value("durationMs", 0);
-        Globals::API->GameBinds_InvokeAsync(static_cast<EGameBinds>(bind), duration);
-    } else if (action == "gamebinds_isBound") {
-        int requestId = msg.value("requestId", 0);
-        bool result = Globals::API->GameBinds_IsBound(static_cast<EGameBinds>(bind));
-        SendAsyncResponse(browser, requestId, true, result ? "true" : "false");
+// Reply with a Nexus path, or an error if the API is not available yet.
+static bool SendPath(const BridgeContext& ctx, const char* (*getter)(const char*), const char* arg) {
+    if (!Globals::API) {
+        SendAsyncResponse(ctx, false, "API not available");
+        return true;
     }
+    const char* p = getter(arg);
+    SendAsyncResponse(ctx, true, p ? p : "");
     return true;
 }
 
-static bool HandlePaths(const json& msg, const std::string& action,
-                         InProcessBrowser* browser) {
-    int requestId = msg.value("requestId", 0);
+static bool HandlePathsGetGameDirectory(const PathsGetGameDirectoryParams&, const BridgeContext& ctx) {
+    return SendPath(ctx, [](const char*) { return Globals::API->Paths_GetGameDirectory(); }, nullptr);
+}
+
+static bool HandlePathsGetAddonDirectory(const PathsGetAddonDirectoryParams& p, const BridgeContext& ctx) {
+    return SendPath(ctx, [](const char* name) { return Globals::API->Paths_GetAddonDirectory(name); },
+                    *p.name ? p.name : nullptr);
+}
+
+static bool HandlePathsGetCommonDirectory(const PathsGetCommonDirectoryParams&, const BridgeContext& ctx) {
+    return SendPath(ctx, [](const char*) { return Globals::API->Paths_GetCommonDirectory(); }, nullptr);
+}
 
+static bool HandleDataLinkGetMumbleLink(const DataLinkGetMumbleLinkParams&, const BridgeContext& ctx) {
     if (!Globals::API) {
-        SendAsyncResponse(browser, requestId, false, "API not available");
+        SendAsyncResponse(ctx, false, "API not available");
         return true;
     }
 
-    std::string result;
-    if (action == "paths_getGameDirectory") {
-        const char* p = Globals::API->Paths_GetGameDirectory();
-        result = p ? p : "";
-    } else if (action == "paths_getAddonDirectory") {
-        std::string name = msg.value("name", "");
-        const char* p = Globals::API->Paths_GetAddonDirectory(name.empty() ? nullptr : name.c_str());
-        result = p ? p : "";
-    } else if (action == "paths_getCommonDirectory") {
-        const char* p = Globals::API->Paths_GetCommonDirectory();
-        result = p ? p : "";
+    json j;
+    if (!GameState::Get(GameState::Source::Mumble, j)) {
+        SendAsyncResponse(ctx, false, "MumbleLink not available");
+        return true;
     }
-
-    SendAsyncResponse(browser, requestId, true, result);
+    SendAsyncResponse(ctx, true, j);
     return true;
 }
 
-static bool HandleDataLink(const json& msg, const std::string& action,
-                            InProcessBrowser* browser) {
-    int requestId = msg.value("requestId", 0);
-
+static bool HandleDataLinkGetNexusLink(const DataLinkGetNexusLinkParams&, const BridgeContext& ctx) {
     if (!Globals::API) {
-        SendAsyncResponse(browser, requestId, false, "API not available");
+        SendAsyncResponse(ctx, false, "API not available");
         return true;
     }
 
-    if (action == "datalink_getMumbleLink") {
-        void* mumble = Globals::API->DataLink_Get(DL_MUMBLE_LINK);
-        if (mumble) {
-            LinkedMem* lm = static_cast<LinkedMem*>(mumble);
-            json j;
-            j["uiVersion"] = lm->uiVersion;
-            j["uiTick"] = lm->uiTick;
-            j["avatarPosition"] = { lm->fAvatarPosition[0], lm->fAvatarPosition[1], lm->fAvatarPosition[2] };
-            j["avatarFront"] = { lm->fAvatarFront[0], lm->fAvatarFront[1], lm->fAvatarFront[2] };
-            j["avatarTop"] = { lm->fAvatarTop[0], lm->fAvatarTop[1], lm->fAvatarTop[2] };
-            j["name"] = WcharToUtf8(lm->name, 256);
-            j["cameraPosition"] = { lm->fCameraPosition[0], lm->fCameraPosition[1], lm->fCameraPosition[2] };
-            j["cameraFront"] = { lm->fCameraFront[0], lm->fCameraFront[1], lm->fCameraFront[2] };
-            j["cameraTop"] = { lm->fCameraTop[0], lm->fCameraTop[1], lm->fCameraTop[2] };
-            j["identity"] = WcharToUtf8(lm->identity, 256);
-            j["contextLen"] = lm->context_len;
-            SendAsyncResponse(browser, requestId, true, j.dump());
-        } else {
-            SendAsyncResponse(browser, requestId, false, "MumbleLink not available");
-        }
-    } else if (action == "datalink_getNexusLink") {
-        NexusLinkData_t* nexusLink = static_cast<NexusLinkData_t*>(
-            Globals::API->DataLink_Get(DL_NEXUS_LINK));
-        if (nexusLink) {
-            json j;
-            j["width"] = nexusLink->Width;
-            j["height"] = nexusLink->Height;
-            j["scaling"] = nexusLink->Scaling;
-            j["isMoving"] = nexusLink->IsMoving;
-            j["isCameraMoving"] = nexusLink->IsCameraMoving;
-            j["isGameplay"] = nexusLink->IsGameplay;
-            SendAsyncResponse(browser, requestId, true, j.dump());
-        } else {
-            SendAsyncResponse(browser, requestId, false, "NexusLink not available");
-        }
+    json j;
+    if (!GameState::Get(GameState::Source::Nexus, j)) {
+        SendAsyncResponse(ctx, false, "NexusLink not available");
+        return true;
     }
+    SendAsyncResponse(ctx, true, j);
     return true;
 }
 
-static bool HandleQuickAccess(const json& msg, const std::string& action) {
-    if (!Globals::API) return true;
+static bool HandleGameStateSubscribe(const GameStateSubscribeParams& p, const BridgeContext& ctx) {
+    if (ctx.addon && ctx.browser) {
+        GameState::Subscribe(ctx.addon->GetId(), ctx.browser->GetWindowId(),
+                             static_cast<uint32_t>(std::max(p.hz, 0)));
+    }
+    return true;
+}
 
-    if (action == "quickaccess_add") {
-        std::string id      = msg.value("id", "");
-        std::string tex     = msg.value("texture", "");
-        std::string texHov  = msg.value("textureHover", "");
-        std::string keybind = msg.value("keybind", "");
-        std::string tooltip = msg.value("tooltip", "");
-        Globals::API->QuickAccess_Add(
-            id.c_str(), tex.c_str(), texHov.c_str(),
-            keybind.c_str(), tooltip.c_str());
-    } else if (action == "quickaccess_remove") {
-        std::string id = msg.value("id", "");
-        Globals::API->QuickAccess_Remove(id.c_str());
-    } else if (action == "quickaccess_notify") {
-        std::string id = msg.value("id", "");
-        Globals::API->QuickAccess_Notify(id.c_str());
+static bool HandleGameStateUnsubscribe(const GameStateUnsubscribeParams&, const BridgeContext& ctx) {
+    if (ctx.addon && ctx.browser) {
+        GameState::Unsubscribe(ctx.addon->GetId(), ctx.browser->GetWindowId());
     }
     return true;
 }
 
-static bool HandleLocalization(const json& msg, const std::string& action,
-                                InProcessBrowser* browser) {
+static bool HandleQuickAccessAdd(const QuickAccessAddParams& p, const BridgeContext&) {
+    if (Globals::API) {
+        Globals::API->QuickAccess_Add(p.id, p.texture, p.textureHover, p.keybind, p.tooltip);
+    }
+    return true;
+}
+
+static bool HandleQuickAccessRemove(const QuickAccessRemoveParams& p, const BridgeContext&) {
+    if (Globals::API) {
+        Globals::API->QuickAccess_Remove(p.id);
+    }
+    return true;
+}
+
+static bool HandleQuickAccessNotify(const QuickAccessNotifyParams& p, const BridgeContext&) {
+    if (Globals::API) {
+        Globals::API->QuickAccess_Notify(p.id);
+    }
+    return true;
+}
+
+static bool HandleLocalizationTranslate(const LocalizationTranslateParams& p, const BridgeContext& ctx) {
     if (!Globals::API) return true;
+    const char* result = Globals::API->Localization_Translate(p.id);
+    SendAsyncResponse(ctx, true, result ? result : p.id);
+    return true;
+}
 
-    if (action == "localization_translate") {
-        int requestId = msg.value("requestId", 0);
-        std::string id = msg.value("id", "");
-        const char* result = Globals::API->Localization_Translate(id.c_str());
-        SendAsyncResponse(browser, requestId, true, result ? result : id);
-    } else if (action == "localization_set") {
-        std::string id   = msg.value("id", "");
-        std::string lang = msg.value("lang", "");
-        std::string text = msg.value("text", "");
-        Globals::API->Localization_Set(id.c_str(), lang.c_str(), text.c_str());
+static bool HandleLocalizationSet(const LocalizationSetParams& p, const BridgeContext&) {
+    if (Globals::API) {
+        Globals::API->Localization_Set(p.id, p.lang, p.text);
     }
     return true;
 }
 
 // ---- Window management handlers ----
 
-static bool HandleWindowsCreate(const json& msg, AddonInstance* addon,
-                                 InProcessBrowser* browser) {
-    int requestId = msg.value("requestId", 0);
-    std::string windowId = msg.value("windowId", "");
-    std::string url = msg.value("url", "");
-    int width = msg.value("width", 800);
-    int height = msg.value("height", 600);
-    std::string title = msg.value("title", "");
-
-    if (windowId.empty() || !addon) {
-        SendAsyncResponse(browser, requestId, false, "Invalid windowId or addon");
+static bool HandleWindowsCreate(const WindowsCreateParams& p, const BridgeContext& ctx) {
+    if (!*p.windowId || !ctx.addon) {
+        SendAsyncResponse(ctx, false, "Invalid windowId or addon");
         return true;
     }
 
-    bool ok = addon->CreateAddonWindow(windowId, url, width, height, title);
-    SendAsyncResponse(browser, requestId, ok, ok ? "created" : "failed");
+    bool ok = ctx.addon->CreateAddonWindow(p.windowId, p.url, p.width, p.height, p.title);
+    SendAsyncResponse(ctx, ok, ok ? "created" : "failed");
     return true;
 }
 
-static bool HandleWindowsClose(const json& msg, AddonInstance* addon) {
-    std::string windowId = msg.value("windowId", "");
-    if (!windowId.empty() && addon) {
-        addon->CloseWindow(windowId);
+static bool HandleWindowsClose(const WindowsCloseParams& p, const BridgeContext& ctx) {
+    if (*p.windowId && ctx.addon) {
+        ctx.addon->CloseWindow(p.windowId);
     }
     return true;
 }
 
-static bool HandleWindowsUpdate(const json& msg, AddonInstance* addon) {
-    std::string windowId = msg.value("windowId", "");
-    if (windowId.empty() || !addon) return true;
-
-    std::string title = msg.value("title", "");
-    int width = msg.value("width", 0);
-    int height = msg.value("height", 0);
-    bool visible = msg.value("visible", true);
-
-    addon->UpdateWindow(windowId, title, width, height, visible);
+static bool HandleWindowsUpdate(const WindowsUpdateParams& p, const BridgeContext& ctx) {
+    if (!*p.windowId || !ctx.addon) return true;
+    ctx.addon->UpdateWindow(p.windowId, p.title, p.width, p.height, p.visible);
     return true;
 }
 
-static bool HandleWindowsSetInputPassthrough(const json& msg, AddonInstance* addon) {
-    std::string windowId = msg.value("windowId", "");
-    if (windowId.empty() || !addon) return true;
+static bool HandleWindowsSetInputPassthrough(const WindowsSetInputPassthroughParams& p,
+                                             const BridgeContext& ctx) {
+    if (!*p.windowId || !ctx.addon) return true;
 
     int threshold = 0;
-    if (msg.contains("alphaThreshold") && msg["alphaThreshold"].is_number()) {
-        threshold = msg["alphaThreshold"].get<int>();
-    } else if (msg.contains("enabled")) {
+    if (p.Has(WindowsSetInputPassthroughParams::alphaThreshold_idx)) {
+        threshold = p.alphaThreshold;
+    } else if (p.Has(WindowsSetInputPassthroughParams::enabled_idx)) {
         // Backward compatibility: bool maps to 0 (capture) or 256 (full passthrough)
-        threshold = msg["enabled"].get<bool>() ? 256 : 0;
+        threshold = p.enabled ? 256 : 0;
     }
 
-    addon->SetInputPassthrough(windowId, threshold);
+    ctx.addon->SetInputPassthrough(p.windowId, threshold);
     return true;
 }
 
-static bool HandleWindowsList(const json& msg, AddonInstance* addon,
-                               InProcessBrowser* browser) {
-    int requestId = msg.value("requestId", 0);
-
-    if (!addon) {
-        SendAsyncResponse(browser, requestId, false, "Addon not found");
+static bool HandleWindowsList(const WindowsListParams&, const BridgeContext& ctx) {
+    if (!ctx.addon) {
+        SendAsyncResponse(ctx, false, "Addon not found");
         return true;
     }
 
     json windowList = json::array();
-    for (const auto& [id, window] : addon->GetWindows()) {
+    for (const auto& [id, window] : ctx.addon->GetWindows()) {
         json w;
         w["windowId"] = window.windowId;
         w["title"] = window.title;
@@ -345,16 +373,226 @@ static bool HandleWindowsList(const json& msg, AddonInstance* addon,
         windowList.push_back(w);
     }
 
-    SendAsyncResponse(browser, requestId, true, windowList.dump());
+    SendAsyncResponse(ctx, true, windowList);
     return true;
 }
 
-// ---- Public interface ----
+// ---- Bridge protocol handlers ----
+
+// Pick the first native->JS encoding in the page's preference list that we
+// support. The reply goes out in the previous encoding; later payloads use
+// the negotiated one.
+static bool HandleBridgeNegotiate(const BridgeNegotiateParams& p, const BridgeContext& ctx) {
+    if (!ctx.browser) return true;
+
+    JsDispatch::Encoding chosen = JsDispatch::Encoding::Json;
+    if (p.encodings && p.encodings->is_array()) {
+        for (const auto& name : *p.encodings) {
+            if (name.is_string() &&
+                JsDispatch::ParseEncoding(name.get_ref<const std::string&>(), chosen)) {
+                break;
+            }
+        }
+    }
+
+    SendAsyncResponse(ctx, true, JsDispatch::EncodingName(chosen));
+    ctx.browser->SetBridgeEncoding(chosen);
+    return true;
+}
+
+// Latency samples measured by the page: [[wire action, microseconds], ...]
+static bool HandlePerfLatency(const PerfLatencyParams& p, const BridgeContext& ctx) {
+    if (!ctx.browser || !p.samples || !p.samples->is_array()) return true;
+
+    IpcStats::AddonStats& stats = IpcStats::ForAddon(ctx.browser->GetAddonId());
+    for (const auto& sample : *p.samples) {
+        if (!sample.is_array() || sample.size() != 2) continue;
+        if (!sample[0].is_string() || !sample[1].is_number_unsigned()) continue;
+
+        Action action = Lookup(sample[0].get_ref<const std::string&>());
+        if (action == Action::Unknown) continue;
+        stats[action].latencyUs.Record(sample[1].get<uint64_t>());
+    }
+    return true;
+}
+
+static bool HandlePerfGetIpcStats(const PerfGetIpcStatsParams& p, const BridgeContext& ctx) {
+    if (!ctx.browser) return true;
+
+    json result = json::object();
+    if (p.all) {
+        IpcStats::ForEach([&](const std::string& addonId, const IpcStats::AddonStats& stats) {
+            result[addonId] = IpcStats::ToJson(stats);
+        });
+    } else {
+        const std::string& addonId = ctx.browser->GetAddonId();
+        result[addonId] = IpcStats::ToJson(IpcStats::ForAddon(addonId));
+    }
+    SendAsyncResponse(ctx, true, result);
+    return true;
+}
+
+// ---- Message decoding ----
+
+// Messages up to this size are tried on the allocation-free flat path.
+static constexpr size_t FLAT_MAX_BYTES = 2048;
+
+// A bridge message and everything decoded from it. Handler parameters point
+// into this storage, so it is kept alive (CefRefPtr) until the handler has
+// run, on whichever thread that is. The last reference returns it to a small
+// pool, so the flat buffer and DOM are not reallocated per message.
+struct BridgeMessage {
+    void AddRef() const { refs.fetch_add(1, std::memory_order_relaxed); }
+    bool Release() const;
+
+    mutable std::atomic<int>    refs{0};
+
+    std::string                 text;        // console message, JSON at `offset`
+    size_t                      offset = 0;
+    CefRefPtr<InProcessBrowser> browser;
+
+    Action           action = Action::Unknown;
+    int              requestId = 0;
+    std::string_view addonId;                // into flatBuffer or dom
+
+    IpcStats::ActionStats* stats = nullptr;  // sending addon's, for `action`
+
+    bool                       isFlat = false;
+    BridgeScanner::FlatMessage flat;
+    char                       flatBuffer[FLAT_MAX_BYTES];
+    json                       dom;
+
+    std::string_view Json() const { return std::string_view(text).substr(offset); }
+};
+
+// Free messages kept for reuse. Past the cap (a burst from many pages), the
+// extra ones are freed.
+static constexpr size_t MESSAGE_POOL_MAX = 32;
+
+static std::mutex                                  s_poolMutex;
+static std::vector<std::unique_ptr<BridgeMessage>> s_messagePool;
+
+static CefRefPtr<BridgeMessage> AcquireMessage() {
+    std::unique_ptr<BridgeMessage> m;
+    {
+        std::lock_guard<std::mutex> lock(s_poolMutex);
+        if (!s_messagePool.empty()) {
+            m = std::move(s_messagePool.back());
+            s_messagePool.pop_back();
+        }
+    }
+    if (!m) m = std::make_unique<BridgeMessage>();
+    return CefRefPtr<BridgeMessage>(m.release());
+}
+
+bool BridgeMessage::Release() const {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return false;
+
+    // Drop what belongs to this message, keep the buffers
+    std::unique_ptr<BridgeMessage> m(const_cast<BridgeMessage*>(this));
+    m->browser = nullptr;
+    m->text.clear();
+    m->offset = 0;
+    m->action = Action::Unknown;
+    m->requestId = 0;
+    m->addonId = {};
+    m->stats = nullptr;
+    m->isFlat = false;
+    m->dom = nullptr;
+
+    std::lock_guard<std::mutex> lock(s_poolMutex);
+    if (s_messagePool.size() < MESSAGE_POOL_MAX) s_messagePool.push_back(std::move(m));
+    return true;
+}
+
+// A message whose parameters fail to decode never reaches its handler; a
+// pending request is rejected so the page's promise settles.
+static bool RejectInvalid(Action action, const BridgeContext& ctx) {
+    if (Globals::API) {
+        Globals::API->Log(LOGL_DEBUG, ADDON_NAME,
+            ("Invalid parameters for bridge action: " +
+             std::string(ACTION_NAMES[static_cast<size_t>(action)])).c_str());
+    }
+    if (ctx.requestId != 0) SendAsyncResponse(ctx, false, "Invalid parameters");
+    return false;
+}
+
+// Decode the action's parameters (from a DOM or a flat message) and call its
+// handler.
+template <class Message>
+static bool Dispatch(Action action, const Message& msg, const BridgeContext& ctx) {
+    switch (action) {
+#define NEXUS_BRIDGE_DISPATCH_CASE(Id, wire, thread, cls)               \
+        case Action::Id: {                                              \
+            Id##Params params;                                          \
+            if (!Decode(msg, params)) return RejectInvalid(action, ctx); \
+            return Handle##Id(params, ctx);                             \
+        }
+        NEXUS_BRIDGE_ACTIONS(NEXUS_BRIDGE_DISPATCH_CASE)
+#undef NEXUS_BRIDGE_DISPATCH_CASE
+        default:
+            return false;
+    }
+}
+
+static void LogUnknownAction(std::string_view actionName) {
+    if (Globals::API) {
+        Globals::API->Log(LOGL_DEBUG, ADDON_NAME,
+            ("Unhandled bridge action: " + std::string(actionName)).c_str());
+    }
+}
+
+// Addon identity comes from the message, falling back to the browser's.
+static AddonInstance* ResolveAddon(std::string_view addonId, InProcessBrowser* browser) {
+    if (browser && (addonId.empty() || addonId == browser->GetAddonId())) {
+        return AddonManager::GetAddon(browser->GetAddonId());
+    }
+    if (addonId.empty()) return nullptr;
+    return AddonManager::GetAddon(std::string(addonId));
+}
+
+// Flat path: scalar-only messages for actions without Json parameters.
+// Returns false if the message needs the DOM path; sets `known` to false for
+// an unknown action.
+static bool TryParseFlat(BridgeMessage& m, bool& known) {
+    std::string_view message = m.Json();
+    if (message.size() > FLAT_MAX_BYTES) return false;
+
+    std::memcpy(m.flatBuffer, message.data(), message.size());
+    if (!BridgeScanner::Scan(m.flatBuffer, message.size(), m.flat)) return false;
 
-bool HandleBridgeMessage(const std::string& jsonStr, InProcessBrowser* browser) {
-    json msg;
+    const BridgeScanner::Member* actionMember = m.flat.Find("action");
+    if (!actionMember || actionMember->kind != BridgeScanner::ValueKind::String) return false;
+
+    std::string_view actionName(actionMember->str, actionMember->strLen);
+    m.action = Lookup(actionName);
+    if (m.action == Action::Unknown) {
+        LogUnknownAction(actionName);
+        known = false;
+        return true;
+    }
+    if (!IsFlatDecodable(m.action)) return false;
+
+    const BridgeScanner::Member* requestMember = m.flat.Find("requestId");
+    if (requestMember && !ToInt(*requestMember, m.requestId)) m.requestId = 0;
+
+    const BridgeScanner::Member* addonMember = m.flat.Find("__addonId");
+    if (addonMember && addonMember->kind == BridgeScanner::ValueKind::String) {
+        m.addonId = std::string_view(addonMember->str, addonMember->strLen);
+    }
+    m.isFlat = true;
+    return true;
+}
+
+// Parse a message and identify its action. Returns false if it cannot be
+// handled. Thread-safe: touches nothing but the message.
+static bool ParseMessage(BridgeMessage& m) {
+    bool known = true;
+    if (TryParseFlat(m, known)) return known;
+
+    std::string_view message = m.Json();
     try {
-        msg = json::parse(jsonStr);
+        m.dom = json::parse(message.begin(), message.end());
     } catch (const json::parse_error& e) {
         if (Globals::API) {
             Globals::API->Log(LOGL_WARNING, ADDON_NAME,
@@ -362,69 +600,143 @@ bool HandleBridgeMessage(const std::string& jsonStr, InProcessBrowser* browser)
         }
         return false;
     }
+    if (!m.dom.is_object()) return false;
 
-    std::string action = msg.value("action", "");
-    if (action.empty()) return false;
+    auto actionIt = m.dom.find("action");
+    if (actionIt == m.dom.end() || !actionIt->is_string()) return false;
+    const std::string& actionName = actionIt->get_ref<const std::string&>();
 
-    // Extract addon/window identity from message
-    std::string addonId = msg.value("__addonId", "");
-    std::string windowId = msg.value("__windowId", "");
+    m.action = Lookup(actionName);
+    if (m.action == Action::Unknown) {
+        LogUnknownAction(actionName);
+        return false;
+    }
 
-    // Fall back to browser's identity if not in message
-    if (addonId.empty() && browser) {
-        addonId = browser->GetAddonId();
+    auto requestIt = m.dom.find("requestId");
+    if (requestIt != m.dom.end() && !ToInt(*requestIt, m.requestId)) m.requestId = 0;
+
+    auto addonIt = m.dom.find("__addonId");
+    if (addonIt != m.dom.end() && addonIt->is_string()) {
+        m.addonId = addonIt->get_ref<const std::string&>();
     }
-    if (windowId.empty() && browser) {
-        windowId = browser->GetWindowId();
+    return true;
+}
+
+// The requestId of a message that will not be parsed, or 0. The bridge adds
+// requestId after the call's parameters, so the last match is the top-level
+// one even if a parameter holds an object with its own.
+static int FindRequestId(std::string_view message) {
+    static constexpr std::string_view KEY = "\"requestId\":";
+    size_t at = message.rfind(KEY);
+    if (at == std::string_view::npos) return 0;
+
+    int id = 0;
+    for (size_t i = at + KEY.size(); i < message.size() && message[i] >= '0' && message[i] <= '9'; ++i) {
+        int digit = message[i] - '0';
+        if (id > (INT_MAX - digit) / 10) return 0;
+        id = id * 10 + digit;
     }
+    return id;
+}
 
-    // Look up the addon instance
-    AddonInstance* addon = AddonManager::GetAddon(addonId);
+static bool RunMessage(const BridgeMessage& m, bool onWorker) {
+    BridgeContext ctx;
+    ctx.requestId = m.requestId;
+    ctx.browser = m.browser.get();
+    ctx.onWorker = onWorker;
+    ctx.stats = m.stats;
+    if (!onWorker) ctx.addon = ResolveAddon(m.addonId, ctx.browser);
 
-    // Route by action name
-    if (action == "log")                   return HandleLog(msg);
-    if (action == "alert")                 return HandleAlert(msg);
-    if (action == "events_subscribe")      return HandleEventsSubscribe(msg, addon);
-    if (action == "events_unsubscribe")    return HandleEventsUnsubscribe(msg, addon);
-    if (action == "events_raise")          return HandleEventsRaise(msg);
-    if (action == "keybinds_register")     return HandleKeybindsRegister(msg, addon);
-    if (action == "keybinds_deregister")   return HandleKeybindsDeregister(msg, addon);
+    return m.isFlat ? Dispatch(m.action, m.flat, ctx) : Dispatch(m.action, m.dom, ctx);
+}
 
-    if (action == "gamebinds_press" || action == "gamebinds_release" ||
-        action == "gamebinds_invoke" || action == "gamebinds_isBound") {
-        return HandleGameBinds(msg, action, browser);
-    }
+// ---- Bridge worker ----
+// Messages are queued per addon in BridgeScheduler and taken in order by the
+// single worker. A Render handler waits for the next frame's batch, so while
+// an addon has one waiting, its later messages join the batch behind it
+// rather than run on the worker ahead of it.
 
-    if (action == "paths_getGameDirectory" || action == "paths_getAddonDirectory" ||
-        action == "paths_getCommonDirectory") {
-        return HandlePaths(msg, action, browser);
-    }
+using Clock = std::chrono::steady_clock;
 
-    if (action == "datalink_getMumbleLink" || action == "datalink_getNexusLink") {
-        return HandleDataLink(msg, action, browser);
-    }
+static uint64_t MicrosecondsSince(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
 
-    if (action == "quickaccess_add" || action == "quickaccess_remove" ||
-        action == "quickaccess_notify") {
-        return HandleQuickAccess(msg, action);
-    }
+// Rate-limited messages never reach their handler; a pending request is
+// rejected so the page's promise settles. Also used for messages dropped
+// unparsed at enqueue.
+static void RejectThrottled(const BridgeMessage& m, bool onWorker) {
+    if (m.requestId == 0) return;
+    BridgeContext ctx;
+    ctx.requestId = m.requestId;
+    ctx.browser = m.browser.get();
+    ctx.onWorker = onWorker;
+    SendAsyncResponse(ctx, false, "Rate limited");
+}
 
-    if (action == "localization_translate" || action == "localization_set") {
-        return HandleLocalization(msg, action, browser);
+static void ProcessMessage(CefRefPtr<BridgeMessage> m, bool onWorker) {
+    const std::string& source = m->browser->GetAddonId();
+    Clock::time_point start = Clock::now();
+
+    bool parsed = ParseMessage(*m);
+    if (parsed && !BridgeScheduler::Admit(source, GetClass(m->action))) {
+        RejectThrottled(*m, onWorker);
+    } else if (parsed) {
+        m->stats = &IpcStats::ForAddon(source)[m->action];
+
+        if (onWorker && (GetThread(m->action) == Thread::Render ||
+                         BridgeScheduler::IsRenderPending(source))) {
+            uint64_t parseUs = MicrosecondsSince(start);
+            BridgeScheduler::BeginRender(source);
+            RenderBatch::Post([m, parseUs]() {
+                const std::string& addonId = m->browser->GetAddonId();
+                Clock::time_point renderStart = Clock::now();
+                RunMessage(*m, false);
+                uint64_t renderUs = MicrosecondsSince(renderStart);
+                BridgeScheduler::EndRender(addonId);
+                m->stats->RecordCall(m->Json().size(), parseUs + renderUs);
+                BridgeScheduler::AddTime(addonId, Thread::Render, renderUs);
+            });
+        } else {
+            RunMessage(*m, onWorker);
+            m->stats->RecordCall(m->Json().size(), MicrosecondsSince(start));
+        }
     }
 
-    // Window management actions
-    if (action == "windows_create")             return HandleWindowsCreate(msg, addon, browser);
-    if (action == "windows_close")              return HandleWindowsClose(msg, addon);
-    if (action == "windows_update")             return HandleWindowsUpdate(msg, addon);
-    if (action == "windows_setInputPassthrough") return HandleWindowsSetInputPassthrough(msg, addon);
-    if (action == "windows_list")               return HandleWindowsList(msg, addon, browser);
+    BridgeScheduler::AddTime(source, onWorker ? Thread::Worker : Thread::Render,
+                             MicrosecondsSince(start));
+}
 
-    if (Globals::API) {
-        Globals::API->Log(LOGL_DEBUG, ADDON_NAME,
-            (std::string("Unhandled bridge action: ") + action).c_str());
+// ---- Public interface ----
+
+void Initialize() {
+    BridgeScheduler::Start();
+}
+
+void Shutdown() {
+    BridgeScheduler::Stop();
+}
+
+void HandleBridgeMessage(std::string message, size_t offset, InProcessBrowser* browser) {
+    if (!browser) return;
+
+    CefRefPtr<BridgeMessage> m = AcquireMessage();
+    m->text = std::move(message);
+    m->offset = std::min(offset, m->text.size());
+    m->browser = browser;
+
+    BridgeScheduler::Posted posted =
+        BridgeScheduler::Post(browser->GetAddonId(), [m]() { ProcessMessage(m, true); });
+    if (posted == BridgeScheduler::Posted::Queued) return;
+    if (posted == BridgeScheduler::Posted::Dropped) {
+        m->requestId = FindRequestId(m->Json());
+        RejectThrottled(*m, false);
+        return;
     }
-    return false;
+
+    // No worker (not initialized, or shutting down): handle inline
+    ProcessMessage(std::move(m), false);
 }
 
 } // namespace IpcHandler
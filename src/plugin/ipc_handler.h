@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstddef>
 
 class InProcessBrowser;
 
@@ -13,9 +14,19 @@ class InProcessBrowser;
 // the Nexus API call implementations.
 namespace IpcHandler {
 
-// Handle a JSON bridge message from the JS bridge.
-// Called by InProcessBrowser::OnConsoleMessage after stripping the __NEXUS__: prefix.
-// Extracts __addonId and __windowId from the message to route to the correct addon.
-bool HandleBridgeMessage(const std::string& json, InProcessBrowser* browser);
+// Start / stop the bridge worker. Without a worker, messages are handled
+// inline on the calling thread.
+void Initialize();
+void Shutdown();
+
+// Handle a bridge message from the JS bridge. Called by
+// InProcessBrowser::OnConsoleMessage with the console message and the offset
+// of the JSON after the __NEXUS__: prefix. The message is parsed on the
+// bridge worker; each action's handler then runs on the worker or in the
+// render thread's next batch, as declared in NEXUS_BRIDGE_ACTIONS
+// (bridge_api.h). Extracts __addonId from the message to route to the correct
+// addon. Flat messages are decoded without building a JSON DOM (see
+// bridge_scanner.h).
+void HandleBridgeMessage(std::string message, size_t offset, InProcessBrowser* browser);
 
 } // namespace IpcHandler
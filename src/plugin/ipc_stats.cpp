@@ -0,0 +1,104 @@
+#include "ipc_stats.h"
+
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <memory>
+#include <mutex>
+
+using json = nlohmann::json;
+
+namespace IpcStats {
+
+// ---- Histogram ----
+
+void Histogram::Record(uint64_t value) {
+    size_t bucket = std::min<size_t>(std::bit_width(value), BUCKETS - 1);
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+double Histogram::GetMean() const {
+    uint64_t count = GetCount();
+    return count ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / count : 0.0;
+}
+
+uint64_t Histogram::Percentile(double q) const {
+    // Snapshot the buckets (writers may keep adding) and rank within it
+    uint64_t counts[BUCKETS];
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) return 0;
+
+    uint64_t rank = static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t upper = i == 0 ? 0 : (uint64_t(1) << i) - 1;
+            return std::min(upper, GetMax());
+        }
+    }
+    return GetMax();
+}
+
+json Histogram::ToJson() const {
+    return {
+        { "count", GetCount() },
+        { "mean",  GetMean() },
+        { "p50",   Percentile(0.50) },
+        { "p95",   Percentile(0.95) },
+        { "p99",   Percentile(0.99) },
+        { "max",   GetMax() },
+    };
+}
+
+// ---- Tables ----
+
+void ActionStats::RecordCall(uint64_t messageBytes, uint64_t microseconds) {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    bytesIn.fetch_add(messageBytes, std::memory_order_relaxed);
+    cpuUs.Record(microseconds);
+}
+
+static std::mutex                                         s_mutex;
+static std::map<std::string, std::unique_ptr<AddonStats>> s_addons;
+
+AddonStats& ForAddon(const std::string& addonId) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto& stats = s_addons[addonId];
+    if (!stats) stats = std::make_unique<AddonStats>();
+    return *stats;
+}
+
+void ForEach(const std::function<void(const std::string&, const AddonStats&)>& fn) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    for (const auto& [id, stats] : s_addons) fn(id, *stats);
+}
+
+json ToJson(const AddonStats& stats) {
+    json result = json::object();
+    for (size_t i = 0; i < BridgeApi::ACTION_COUNT; ++i) {
+        const ActionStats& action = stats.actions[i];
+        uint64_t calls = action.calls.load(std::memory_order_relaxed);
+        if (calls == 0) continue;
+
+        result[std::string(BridgeApi::ACTION_NAMES[i])] = {
+            { "calls",    calls },
+            { "bytesIn",  action.bytesIn.load(std::memory_order_relaxed) },
+            { "bytesOut", action.bytesOut.load(std::memory_order_relaxed) },
+            { "cpu",      action.cpuUs.ToJson() },
+            { "latency",  action.latencyUs.ToJson() },
+        };
+    }
+    return result;
+}
+
+} // namespace IpcStats
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "bridge_api.h"
+
+#include "nlohmann/json.hpp"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <cstdint>
+
+// Per-addon, per-action bridge call statistics.
+//
+// Counters and histograms are relaxed atomics, recorded without locks from
+// the bridge worker and the render thread. Only finding an addon's table
+// takes a lock; tables live until the process exits, so pointers to them
+// stay valid across threads.
+namespace IpcStats {
+
+// Log2 histogram of microsecond values: bucket 0 holds 0, bucket i holds
+// [2^(i-1), 2^i). The last bucket also holds everything above.
+class Histogram {
+public:
+    static constexpr size_t BUCKETS = 32;
+
+    void Record(uint64_t value);
+
+    uint64_t GetCount() const { return m_count.load(std::memory_order_relaxed); }
+    uint64_t GetMax() const { return m_max.load(std::memory_order_relaxed); }
+    double   GetMean() const;
+
+    // Upper bound of the bucket holding quantile q (0..1), capped at the
+    // largest recorded value. 0 when empty.
+    uint64_t Percentile(double q) const;
+
+    // {count, mean, p50, p95, p99, max}
+    nlohmann::json ToJson() const;
+
+private:
+    std::atomic<uint64_t> m_buckets[BUCKETS] = {};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+struct ActionStats {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> bytesIn{0};   // message JSON
+    std::atomic<uint64_t> bytesOut{0};  // encoded responses
+    Histogram             cpuUs;        // parsing and handler, both threads
+    Histogram             latencyUs;    // JS send to promise settlement (async calls)
+
+    void RecordCall(uint64_t messageBytes, uint64_t microseconds);
+    void RecordResponse(uint64_t bytes) { bytesOut.fetch_add(bytes, std::memory_order_relaxed); }
+};
+
+struct AddonStats {
+    ActionStats actions[BridgeApi::ACTION_COUNT];
+
+    ActionStats& operator[](BridgeApi::Action action) {
+        return actions[static_cast<size_t>(action)];
+    }
+};
+
+// The addon's table, created on first use. Any thread.
+AddonStats& ForAddon(const std::string& addonId);
+
+// Visit every table, in order of addon ID.
+void ForEach(const std::function<void(const std::string& addonId, const AddonStats& stats)>& fn);
+
+// {wire: {calls, bytesIn, bytesOut, cpu: {...}, latency: {...}}} for every
+// action the addon has called.
+nlohmann::json ToJson(const AddonStats& stats);
+
+} // namespace IpcStats
@@ -0,0 +1,220 @@
+#include "js_dispatch.h"
+#include "in_process_browser.h"
+#include "globals.h"
+
+#include "nlohmann/json.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+using json = nlohmann::json;
+
+namespace JsDispatch {
+
+// ---- Blob table ----
+// Written on the render thread (Send), read on the CEF IO thread (TakeBlob).
+// Blobs are normally fetched within a frame or two; anything left behind by a
+// navigation is pruned by age, and the table as a whole is capped in size.
+
+static constexpr DWORD  BLOB_MAX_AGE_MS     = 30000;
+static constexpr size_t BLOB_MAX_TOTAL_BYTES = 64 * 1024 * 1024;
+
+struct StagedBlob {
+    std::string addonId;
+    std::string data;
+    const char* mimeType = "application/json";
+    DWORD       stagedTick = 0;
+};
+
+static std::mutex                               s_blobMutex;
+static std::unordered_map<uint64_t, StagedBlob> s_blobs;
+static size_t                                   s_blobBytes  = 0;
+static uint64_t                                 s_nextBlobId = 1;
+
+// Drop expired blobs, then the oldest ones until `incoming` more bytes fit.
+// Caller holds s_blobMutex.
+static void PruneBlobsLocked(size_t incoming) {
+    DWORD now = GetTickCount();
+    for (auto it = s_blobs.begin(); it != s_blobs.end();) {
+        if (now - it->second.stagedTick > BLOB_MAX_AGE_MS) {
+            s_blobBytes -= it->second.data.size();
+            it = s_blobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    while (!s_blobs.empty() && s_blobBytes + incoming > BLOB_MAX_TOTAL_BYTES) {
+        // Ids are monotonic, so the smallest id is the oldest blob.
+        auto oldest = s_blobs.begin();
+        for (auto it = s_blobs.begin(); it != s_blobs.end(); ++it) {
+            if (it->first < oldest->first) oldest = it;
+        }
+        s_blobBytes -= oldest->second.data.size();
+        s_blobs.erase(oldest);
+    }
+}
+
+static uint64_t StageBlob(const std::string& addonId, const std::string& data,
+                          const char* mimeType) {
+    std::lock_guard<std::mutex> lock(s_blobMutex);
+    PruneBlobsLocked(data.size());
+
+    uint64_t id = s_nextBlobId++;
+    s_blobs[id] = { addonId, data, mimeType, GetTickCount() };
+    s_blobBytes += data.size();
+    return id;
+}
+
+bool TakeBlob(const std::string& addonId, uint64_t blobId,
+              std::string& out, std::string& mimeType) {
+    std::lock_guard<std::mutex> lock(s_blobMutex);
+    auto it = s_blobs.find(blobId);
+    if (it == s_blobs.end() || it->second.addonId != addonId) return false;
+
+    out = std::move(it->second.data);
+    mimeType = it->second.mimeType;
+    s_blobBytes -= out.size();
+    s_blobs.erase(it);
+    return true;
+}
+
+void ClearBlobs(const std::string& addonId) {
+    std::lock_guard<std::mutex> lock(s_blobMutex);
+    for (auto it = s_blobs.begin(); it != s_blobs.end();) {
+        if (it->second.addonId == addonId) {
+            s_blobBytes -= it->second.data.size();
+            it = s_blobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// ---- Dispatch ----
+
+static const char* EncodingMimeType(Encoding encoding) {
+    switch (encoding) {
+        case Encoding::Cbor:    return "application/cbor";
+        case Encoding::MsgPack: return "application/msgpack";
+        default:                return "application/json";
+    }
+}
+
+// Payloads this large are staged in the blob table, if the page can fetch
+// from the addon origin.
+static bool UsesBlob(InProcessBrowser* browser, size_t bytes) {
+    return bytes >= BLOB_MIN_BYTES && browser->IsOnAddonOrigin();
+}
+
+static void SendBlob(InProcessBrowser* browser, Encoding encoding, const std::string& bytes) {
+    uint64_t id = StageBlob(browser->GetAddonId(), bytes, EncodingMimeType(encoding));
+    std::string code;
+    code.reserve(64);
+    code.append("window.__nexus_dispatch_blob(").append(std::to_string(id)).append(",");
+    code.push_back(static_cast<char>('0' + static_cast<int>(encoding)));
+    code.append(");");
+    browser->ExecuteJavaScript(code);
+}
+
+static void SendEncoded(InProcessBrowser* browser, Encoding encoding, const std::string& bytes) {
+    // The blob URL is same-origin only for pages served by our scheme
+    // handler; pages on other origins get the payload inline instead.
+    if (UsesBlob(browser, bytes.size())) {
+        SendBlob(browser, encoding, bytes);
+        return;
+    }
+    std::string code;
+    BuildScript(encoding, bytes, code);
+    browser->ExecuteJavaScript(code);
+}
+
+size_t Send(InProcessBrowser* browser, const json& payload) {
+    if (!browser) return 0;
+
+    Encoding encoding = browser->GetBridgeEncoding();
+    std::string bytes;
+    Encode(encoding, payload, bytes);
+    SendEncoded(browser, encoding, bytes);
+    return bytes.size();
+}
+
+// ---- Shared payloads ----
+
+static std::unordered_map<uint64_t, SharedPayloadRef> s_shared;
+static SharedStats                                     s_sharedStats;
+
+// Event sequence numbers and frame numbers never reach the top byte, which
+// holds the source.
+static uint64_t SharedKey(PayloadSource source, uint64_t seq) {
+    return (static_cast<uint64_t>(source) << 56) ^ seq;
+}
+
+SharedPayloadRef FindShared(PayloadSource source, uint64_t seq) {
+    s_sharedStats.lookups++;
+    auto it = s_shared.find(SharedKey(source, seq));
+    if (it == s_shared.end()) return nullptr;
+    s_sharedStats.hits++;
+    return it->second;
+}
+
+SharedPayloadRef AddShared(PayloadSource source, uint64_t seq, json message) {
+    auto payload = std::make_shared<SharedPayload>(std::move(message));
+    s_shared[SharedKey(source, seq)] = payload;
+    return payload;
+}
+
+void SendShared(InProcessBrowser* browser, SharedPayload& payload) {
+    if (!browser) return;
+
+    Encoding encoding = browser->GetBridgeEncoding();
+    size_t index = static_cast<size_t>(encoding);
+    if (index >= SharedPayload::ENCODING_COUNT) {
+        Send(browser, payload.m_message);
+        return;
+    }
+
+    s_sharedStats.sends++;
+    std::string& bytes = payload.m_encoded[index];
+    if (bytes.empty()) {
+        Encode(encoding, payload.m_message, bytes);
+    } else {
+        s_sharedStats.reusedSends++;
+        s_sharedStats.bytesSaved += bytes.size();
+    }
+
+    if (UsesBlob(browser, bytes.size())) {
+        SendBlob(browser, encoding, bytes);
+        return;
+    }
+
+    std::string& script = payload.m_script[index];
+    if (script.empty()) {
+        BuildScript(encoding, bytes, script);
+    } else {
+        s_sharedStats.bytesSaved += script.size();
+    }
+    browser->ExecuteJavaScript(script);
+}
+
+void EndFrame() {
+    s_shared.clear();
+}
+
+const SharedStats& GetSharedStats() {
+    return s_sharedStats;
+}
+
+size_t SendResponse(InProcessBrowser* browser, int requestId,
+                    bool success, const json& value) {
+    if (!browser) return 0;
+
+    json j;
+    j["type"] = "response";
+    j["requestId"] = requestId;
+    j["success"] = success;
+    j["value"] = value;
+    return Send(browser, j);
+}
+
+} // namespace JsDispatch
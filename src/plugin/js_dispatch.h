@@ -0,0 +1,131 @@
+#pragma once
+
+#include "nlohmann/json.hpp"
+
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+class InProcessBrowser;
+
+// Native->JS delivery of bridge payloads (responses, events, keybinds).
+//
+// Small payloads are embedded directly as an object literal:
+//   window.__nexus_dispatch({...})
+// Medium payloads are passed as a single JSON string literal, which V8 hands
+// to JSON.parse instead of compiling the payload as a JS program:
+//   window.__nexus_dispatch_json("{...}")
+// Large payloads are staged in a per-addon blob table and fetched by the
+// bridge from the addon's scheme handler, so the script itself stays tiny:
+//   window.__nexus_dispatch_blob(<id>, <format>)  ->  GET /__nexus/blob/<id>
+//
+// A page may negotiate a binary encoding (nexus.bridge.negotiate). Binary
+// payloads are sent base64-encoded, or staged as raw bytes in the blob table:
+//   window.__nexus_dispatch_bin(<format>, "<base64>")
+namespace JsDispatch {
+
+// Wire encoding for native->JS payloads. Values are shared with the bridge
+// script, which receives them as the <format> argument.
+enum class Encoding : uint8_t {
+    Json    = 0,
+    Cbor    = 1,
+    MsgPack = 2,
+};
+
+// Parse / name an encoding ("json", "cbor", "msgpack"). Parse returns false
+// for unknown names.
+bool ParseEncoding(const std::string& name, Encoding& out);
+const char* EncodingName(Encoding encoding);
+
+// Payloads up to this size (bytes of JSON) are embedded as an object literal.
+constexpr size_t INLINE_MAX_BYTES = 8 * 1024;
+
+// Payloads at or above this size are staged in the blob table.
+constexpr size_t BLOB_MIN_BYTES = 512 * 1024;
+
+// URL path prefix (relative to the addon origin) served from the blob table.
+constexpr const char* BLOB_PATH_PREFIX = "__nexus/blob/";
+
+// Encode a payload in a wire encoding (js_encoding.cpp, which does not depend
+// on CEF and is also built into host_micro).
+void Encode(Encoding encoding, const nlohmann::json& payload, std::string& out);
+
+// Dispatch script for an encoded payload that is not staged as a blob: an
+// object literal, a JSON string literal or base64, by encoding and size.
+void BuildScript(Encoding encoding, const std::string& bytes, std::string& code);
+
+// Deliver a payload to the browser's __nexus_dispatch, encoded with the
+// browser's negotiated encoding. Call from the render thread. Returns the
+// size of the encoded payload.
+size_t Send(InProcessBrowser* browser, const nlohmann::json& payload);
+
+// Build and deliver an async response for a bridge request. Returns the size
+// of the encoded response.
+size_t SendResponse(InProcessBrowser* browser, int requestId,
+                    bool success, const nlohmann::json& value);
+
+// ---- Shared payloads ----
+// A payload that goes to several browsers (an event occurrence fanned out to
+// every subscribed addon, a game-state delta) is encoded at most once per
+// wire encoding, and the dispatch script built from it is reused by every
+// recipient the payload is not staged as a blob for. Payloads are
+// reference-counted; the per-frame cache below only holds one reference.
+
+enum class PayloadSource : uint8_t {
+    Event,      // seq = EventRouter occurrence number
+    GameState,  // seq = frame the delta starts after (0: full state)
+};
+
+class SharedPayload {
+public:
+    explicit SharedPayload(nlohmann::json message) : m_message(std::move(message)) {}
+
+    const nlohmann::json& Message() const { return m_message; }
+
+private:
+    friend void SendShared(InProcessBrowser* browser, SharedPayload& payload);
+
+    static constexpr size_t ENCODING_COUNT = 3;
+
+    nlohmann::json m_message;
+    std::string    m_encoded[ENCODING_COUNT]; // JSON text / CBOR / MessagePack
+    std::string    m_script[ENCODING_COUNT];  // non-blob dispatch script
+};
+
+using SharedPayloadRef = std::shared_ptr<SharedPayload>;
+
+// The cached payload for (source, seq), or nullptr.
+SharedPayloadRef FindShared(PayloadSource source, uint64_t seq);
+
+// Cache `message` as the payload for (source, seq) and return it.
+SharedPayloadRef AddShared(PayloadSource source, uint64_t seq, nlohmann::json message);
+
+// Deliver a shared payload, encoding it for the browser's encoding on first
+// use. Call from the render thread.
+void SendShared(InProcessBrowser* browser, SharedPayload& payload);
+
+// Release the cache's references. Called once per frame after every addon
+// has flushed; payloads still referenced elsewhere stay alive.
+void EndFrame();
+
+struct SharedStats {
+    uint64_t lookups = 0;       // FindShared calls
+    uint64_t hits = 0;          // ... that found a payload
+    uint64_t sends = 0;         // SendShared calls
+    uint64_t reusedSends = 0;   // ... that reused encoded bytes
+    uint64_t bytesSaved = 0;    // encoded + script bytes not rebuilt
+};
+
+const SharedStats& GetSharedStats();
+
+// Remove a staged blob and return its contents and MIME type. Called by the
+// scheme handler (CEF IO thread). Returns false if the blob does not exist or
+// belongs to a different addon. Blobs are single-use.
+bool TakeBlob(const std::string& addonId, uint64_t blobId,
+              std::string& out, std::string& mimeType);
+
+// Drop all staged blobs for an addon (on shutdown / reload).
+void ClearBlobs(const std::string& addonId);
+
+} // namespace JsDispatch
@@ -0,0 +1,110 @@
+#include "js_dispatch.h"
+
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+namespace JsDispatch {
+
+bool ParseEncoding(const std::string& name, Encoding& out) {
+    if (name == "json")    { out = Encoding::Json;    return true; }
+    if (name == "cbor")    { out = Encoding::Cbor;    return true; }
+    if (name == "msgpack") { out = Encoding::MsgPack; return true; }
+    return false;
+}
+
+const char* EncodingName(Encoding encoding) {
+    switch (encoding) {
+        case Encoding::Cbor:    return "cbor";
+        case Encoding::MsgPack: return "msgpack";
+        default:                return "json";
+    }
+}
+
+// Standard base64 (RFC 4648) for binary payloads embedded in scripts.
+static void AppendBase64(std::string& out, const std::string& bytes) {
+    static const char* TABLE =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const auto* data = reinterpret_cast<const unsigned char*>(bytes.data());
+    size_t len = bytes.size();
+    size_t i = 0;
+    for (; i + 2 < len; i += 3) {
+        uint32_t n = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        out.push_back(TABLE[(n >> 18) & 63]);
+        out.push_back(TABLE[(n >> 12) & 63]);
+        out.push_back(TABLE[(n >> 6) & 63]);
+        out.push_back(TABLE[n & 63]);
+    }
+    if (i + 1 == len) {
+        uint32_t n = data[i] << 16;
+        out.push_back(TABLE[(n >> 18) & 63]);
+        out.push_back(TABLE[(n >> 12) & 63]);
+        out.append("==");
+    } else if (i + 2 == len) {
+        uint32_t n = (data[i] << 16) | (data[i + 1] << 8);
+        out.push_back(TABLE[(n >> 18) & 63]);
+        out.push_back(TABLE[(n >> 12) & 63]);
+        out.push_back(TABLE[(n >> 6) & 63]);
+        out.push_back('=');
+    }
+}
+
+// Append `text` as a JS string literal (JSON string syntax). Runs that need
+// no escaping are copied whole.
+static void AppendStringLiteral(std::string& out, const std::string& text) {
+    static const char* HEX = "0123456789abcdef";
+    out.push_back('"');
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(text, run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"':  out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                out.append("\\u00");
+                out.push_back(HEX[(c >> 4) & 0xF]);
+                out.push_back(HEX[c & 0xF]);
+        }
+    }
+    out.append(text, run, std::string::npos);
+    out.push_back('"');
+}
+
+void Encode(Encoding encoding, const json& payload, std::string& out) {
+    switch (encoding) {
+        case Encoding::Cbor:    json::to_cbor(payload, out); break;
+        case Encoding::MsgPack: json::to_msgpack(payload, out); break;
+        default: out = payload.dump(-1, ' ', false, json::error_handler_t::replace); break;
+    }
+}
+
+// The script is assembled in one reserved buffer.
+void BuildScript(Encoding encoding, const std::string& bytes, std::string& code) {
+    code.clear();
+    if (encoding != Encoding::Json) {
+        code.reserve(bytes.size() * 4 / 3 + 48);
+        code.append("window.__nexus_dispatch_bin(");
+        code.push_back(static_cast<char>('0' + static_cast<int>(encoding)));
+        code.append(",\"");
+        AppendBase64(code, bytes);
+        code.append("\");");
+    } else if (bytes.size() <= INLINE_MAX_BYTES) {
+        code.reserve(bytes.size() + 32);
+        code.append("window.__nexus_dispatch(").append(bytes).append(");");
+    } else {
+        // A JSON string literal, handed to JSON.parse instead of compiled
+        code.reserve(bytes.size() + bytes.size() / 8 + 40);
+        code.append("window.__nexus_dispatch_json(");
+        AppendStringLiteral(code, bytes);
+        code.append(");");
+    }
+}
+
+} // namespace JsDispatch
@@ -82,6 +82,10 @@ void AddonLoad(AddonAPI_t* aAPI) {
     aAPI->Log(LOGL_INFO, ADDON_NAME,
         "Will scan addons when CEF is ready (deferred to render thread).");
 
+    // Meanwhile, read the addons' entry pages and preload lists into the
+    // asset cache on the asset I/O pool
+    AddonManager::Preload();
+
     Globals::IsLoaded = true;
     aAPI->Log(LOGL_INFO, ADDON_NAME, "JS Loader loaded successfully.");
 }
@@ -0,0 +1,47 @@
+#include "mapped_file.h"
+
+#include <windows.h>
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::filesystem::path& filePath,
+                                                   std::string* error) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    const char* reason = nullptr;
+
+    HANDLE handle = CreateFileW(filePath.c_str(), GENERIC_READ,
+        FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        reason = "cannot open file";
+    } else {
+        file->m_file = handle;
+
+        LARGE_INTEGER size;
+        FILETIME written;
+        if (!GetFileSizeEx(handle, &size) || size.QuadPart <= 0) {
+            reason = "empty file";
+        } else {
+            file->m_size = static_cast<size_t>(size.QuadPart);
+            if (GetFileTime(handle, nullptr, nullptr, &written)) {
+                file->m_writeTime = (static_cast<uint64_t>(written.dwHighDateTime) << 32) |
+                                    written.dwLowDateTime;
+            }
+            file->m_mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (file->m_mapping) {
+                file->m_view = static_cast<const char*>(
+                    MapViewOfFile(file->m_mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+            if (!file->m_view) reason = "cannot map file";
+        }
+    }
+
+    if (reason) {
+        if (error) *error = reason;
+        return nullptr;
+    }
+    return file;
+}
+
+MappedFile::~MappedFile() {
+    if (m_view) UnmapViewOfFile(m_view);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+}
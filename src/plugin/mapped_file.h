@@ -0,0 +1,37 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Read-only memory mapping of a whole file. The view stays valid for the
+// object's lifetime; share it (std::shared_ptr aliasing) to keep slices of it
+// alive.
+class MappedFile {
+public:
+    // Returns nullptr if the file cannot be opened or mapped (empty files
+    // cannot be mapped); `error` says why.
+    static std::shared_ptr<const MappedFile> Open(const std::filesystem::path& filePath,
+                                                  std::string* error = nullptr);
+
+    ~MappedFile();
+
+    const char* GetData() const { return m_view; }
+    size_t GetSize() const { return m_size; }
+
+    // Last write time (FILETIME ticks), read when the file was opened.
+    uint64_t GetWriteTime() const { return m_writeTime; }
+
+private:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void*       m_file = nullptr;     // HANDLE
+    void*       m_mapping = nullptr;  // HANDLE
+    const char* m_view = nullptr;
+    size_t      m_size = 0;
+    uint64_t    m_writeTime = 0;
+};
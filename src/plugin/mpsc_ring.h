@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free multi-producer / single-consumer ring (Vyukov's bounded
+// queue). Each cell carries a sequence number that tells producers and the
+// consumer whether it is free or filled, so neither side ever blocks: a push
+// into a full ring fails immediately and the caller counts the drop.
+//
+// Records are written and read in place through callbacks, so the ring's
+// cells double as a preallocated arena for fixed-size payloads.
+template <typename T, size_t Capacity>
+class MpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "MpscRing capacity must be a power of two");
+
+public:
+    MpscRing() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Producer side (any thread). Calls fill(T&) on a reserved cell and
+    // publishes it. Returns false without calling fill if the ring is full.
+    template <typename Fill>
+    bool TryPush(Fill&& fill) {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[pos & (Capacity - 1)];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(cell.value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer side (single thread). Calls consume(T&) on the oldest
+    // published record and frees its cell. Returns false if none is ready.
+    template <typename Consume>
+    bool TryPop(Consume&& consume) {
+        Cell& cell = m_cells[m_tail & (Capacity - 1)];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(m_tail + 1) < 0) {
+            return false;
+        }
+        consume(cell.value);
+        cell.sequence.store(m_tail + Capacity, std::memory_order_release);
+        ++m_tail;
+        return true;
+    }
+
+    // Consumer side: drop every published record.
+    void Clear() {
+        while (TryPop([](T&) {})) {}
+    }
+
+    // Consumer side: records reserved but not yet popped. Includes pushes
+    // still being written, so it may run ahead of what TryPop can see.
+    size_t SizeApprox() const {
+        return m_head.load(std::memory_order_relaxed) - m_tail;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T                   value;
+    };
+
+    alignas(64) std::atomic<size_t> m_head{0}; // next position to reserve
+    alignas(64) size_t              m_tail = 0; // consumer only
+    alignas(64) Cell                m_cells[Capacity];
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// Standard MumbleLink struct (Mumble positional audio protocol).
+// Nexus maps this via DataLink_Get(DL_MUMBLE_LINK).
+struct LinkedMem {
+    uint32_t uiVersion;
+    uint32_t uiTick;
+    float    fAvatarPosition[3];
+    float    fAvatarFront[3];
+    float    fAvatarTop[3];
+    wchar_t  name[256];
+    float    fCameraPosition[3];
+    float    fCameraFront[3];
+    float    fCameraTop[3];
+    wchar_t  identity[256];
+    uint32_t context_len;
+    unsigned char context[256];
+    wchar_t  description[2048];
+};
@@ -0,0 +1,79 @@
+#include "name_intern.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace NameIntern {
+
+// Open-addressing hash table of (ID + 1), 0 = empty. Twice MAX_NAMES so probe
+// chains stay short. Slots are only ever filled, never cleared, so readers
+// can probe without a lock: a slot's ID is published (release) after the
+// name it refers to.
+static constexpr size_t TABLE_SIZE = MAX_NAMES * 2;
+static_assert((TABLE_SIZE & (TABLE_SIZE - 1)) == 0, "TABLE_SIZE must be a power of two");
+
+static std::atomic<uint16_t>           s_table[TABLE_SIZE];
+static std::atomic<const std::string*> s_names[MAX_NAMES];
+
+static std::mutex              s_writeMutex;
+static std::deque<std::string> s_storage; // stable addresses for s_names
+static size_t                  s_count = 0;
+
+static const std::string s_empty;
+
+static size_t HashName(std::string_view name) {
+    // FNV-1a
+    uint64_t h = 14695981039346656037ull;
+    for (char c : name) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 1099511628211ull;
+    }
+    return static_cast<size_t>(h ^ (h >> 32));
+}
+
+Id Find(std::string_view name) {
+    size_t slot = HashName(name) & (TABLE_SIZE - 1);
+    for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+        uint16_t entry = s_table[slot].load(std::memory_order_acquire);
+        if (entry == 0) return INVALID;
+
+        Id id = static_cast<Id>(entry - 1);
+        const std::string* stored = s_names[id].load(std::memory_order_acquire);
+        if (stored && *stored == name) return id;
+
+        slot = (slot + 1) & (TABLE_SIZE - 1);
+    }
+    return INVALID;
+}
+
+Id Intern(std::string_view name) {
+    Id existing = Find(name);
+    if (existing != INVALID) return existing;
+
+    std::lock_guard<std::mutex> lock(s_writeMutex);
+
+    // Re-check under the lock: another writer may have added it.
+    existing = Find(name);
+    if (existing != INVALID) return existing;
+    if (s_count >= MAX_NAMES) return INVALID;
+
+    Id id = static_cast<Id>(s_count++);
+    s_storage.emplace_back(name);
+    s_names[id].store(&s_storage.back(), std::memory_order_release);
+
+    size_t slot = HashName(name) & (TABLE_SIZE - 1);
+    while (s_table[slot].load(std::memory_order_relaxed) != 0) {
+        slot = (slot + 1) & (TABLE_SIZE - 1);
+    }
+    s_table[slot].store(static_cast<uint16_t>(id + 1), std::memory_order_release);
+    return id;
+}
+
+const std::string& Name(Id id) {
+    if (id >= MAX_NAMES) return s_empty;
+    const std::string* stored = s_names[id].load(std::memory_order_acquire);
+    return stored ? *stored : s_empty;
+}
+
+} // namespace NameIntern
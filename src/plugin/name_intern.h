@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// Process-wide table of interned names (event names, keybind identifiers).
+//
+// Names are interned on the render thread when an addon subscribes/registers,
+// and get a small stable ID. Game-thread callbacks then carry the ID instead
+// of a heap string. Find() and Name() are lock-free and safe from any thread;
+// Intern() serializes writers with a mutex. Interned names live until process
+// exit, so AddonInstance caps what each addon can add (MAX_NAMES_PER_ADDON).
+namespace NameIntern {
+
+using Id = uint16_t;
+
+constexpr Id INVALID = 0xFFFF;
+
+// Maximum number of distinct names.
+constexpr size_t MAX_NAMES = 4096;
+
+// Return the ID for `name`, adding it if needed. Returns INVALID if the table
+// is full.
+Id Intern(std::string_view name);
+
+// Return the ID for `name` if it was interned, else INVALID. Lock-free.
+Id Find(std::string_view name);
+
+// Name for an ID returned by Intern/Find. Lock-free.
+const std::string& Name(Id id);
+
+} // namespace NameIntern
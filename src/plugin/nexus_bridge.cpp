@@ -1,4 +1,7 @@
 #include "nexus_bridge.h"
+#include "bridge_api.h"
+
+#include <cstring>
 
 namespace NexusBridge {
 
@@ -12,13 +15,16 @@ namespace NexusBridge {
 //
 // Native->JS: window.__nexus_dispatch({type, ...})
 //   Called by IpcHandler via InProcessBrowser::ExecuteJavaScript for async
-//   responses, event callbacks, and keybind invocations.
+//   responses, event callbacks, and keybind invocations. Larger payloads use
+//   __nexus_dispatch_json / __nexus_dispatch_blob (see js_dispatch.h).
 //
 // Each browser gets addon/window identity injected as a preamble before this
 // script (window.__nexus_addon_id, window.__nexus_window_id). The _send()
 // function includes these in every message for routing.
 
-static const std::string s_bridgeScript = R"JS(
+static const char* STUBS_PLACEHOLDER = "/*__NEXUS_API_STUBS__*/";
+
+static const char* s_bridgeTemplate = R"JS(
 (function() {
     'use strict';
 
@@ -33,37 +39,68 @@ static const std::string s_bridgeScript = R"JS(
     var _pendingRequests = {};    // requestId -> { resolve, reject }
     var _eventCallbacks = {};    // eventName -> [callback, ...]
     var _keybindCallbacks = {};  // keybindId -> callback
+    var _aggregateCallbacks = {}; // aggregateId -> callback
+    var _nextAggregateId = 1;
+    var _gameState = { mumble: null, nexus: null }; // mirror of native GameState
+    var _gameStateCallbacks = [];
+    var _latencySamples = [];     // [[action, microseconds], ...] for perf_latency
+
+    // Generated from bridge_api.h: _ACTIONS (known action names) and
+    // _STUBS (window.nexus.* method table).
+/*__NEXUS_API_STUBS__*/
 
     // ---- Internal: send message to native ----
     function _send(msg) {
+        if (!_ACTIONS.hasOwnProperty(msg.action)) {
+            console.warn('nexus: unknown bridge action ' + msg.action);
+        }
         msg.__addonId = _addonId;
         msg.__windowId = _windowId;
         console.log('__NEXUS__:' + JSON.stringify(msg));
     }
 
+    // ---- Internal: end-to-end latency of async requests ----
+    // Measured from the send timestamp to the promise settling, and reported
+    // to native in batches (at most once a second).
+    function _flushLatency() {
+        if (!_latencySamples.length) return;
+        var samples = _latencySamples;
+        _latencySamples = [];
+        _send({ action: 'perf_latency', samples: samples });
+    }
+
+    function _recordLatency(action, sentAt) {
+        _latencySamples.push([action, Math.round((performance.now() - sentAt) * 1000)]);
+        if (_latencySamples.length === 1) setTimeout(_flushLatency, 1000);
+        else if (_latencySamples.length >= 256) _flushLatency();
+    }
+
     // ---- Internal: send async request, returns Promise ----
     function _sendAsync(action, params) {
         return new Promise(function(resolve, reject) {
             var id = _nextRequestId++;
-            _pendingRequests[id] = { resolve: resolve, reject: reject };
-            var msg = { action: action, requestId: id };
+            _pendingRequests[id] = { resolve: resolve, reject: reject, action: action, sentAt: performance.now() };
+            var msg = {};
             if (params) {
                 for (var k in params) {
                     if (params.hasOwnProperty(k)) msg[k] = params[k];
                 }
             }
+            msg.action = action;
+            msg.requestId = id;
             _send(msg);
         });
     }
 
     // ---- Native->JS dispatch handler ----
-    window.__nexus_dispatch = function(data) {
+    function _deliver(data) {
         if (!data || !data.type) return;
 
         if (data.type === 'response') {
             var req = _pendingRequests[data.requestId];
             if (req) {
                 delete _pendingRequests[data.requestId];
+                _recordLatency(req.action, req.sentAt);
                 if (data.success) {
                     req.resolve(data.value);
                 } else {
@@ -84,6 +121,28 @@ static const std::string s_bridgeScript = R"JS(
             return;
         }
 
+        if (data.type === 'aggregate') {
+            var acb = _aggregateCallbacks[data.id];
+            if (acb) {
+                try { acb(data.value, data.count); } catch(e) { console.error('Aggregate callback error:', e); }
+            }
+            return;
+        }
+
+        if (data.type === 'gamestate') {
+            ['mumble', 'nexus'].forEach(function(src) {
+                if (!data.hasOwnProperty(src)) return;
+                var fields = data[src];
+                if (fields === null) { _gameState[src] = null; return; }
+                if (data.full || !_gameState[src]) _gameState[src] = {};
+                for (var k in fields) _gameState[src][k] = fields[k];
+            });
+            for (var g = 0; g < _gameStateCallbacks.length; g++) {
+                try { _gameStateCallbacks[g](data); } catch(e) { console.error('Game state callback error:', e); }
+            }
+            return;
+        }
+
         if (data.type === 'keybind') {
             var cb = _keybindCallbacks[data.id];
             if (cb) {
@@ -91,26 +150,197 @@ static const std::string s_bridgeScript = R"JS(
             }
             return;
         }
+    }
+
+    // Payloads are delivered in the order native sent them. A large payload
+    // staged in the native blob table is fetched asynchronously; anything that
+    // arrives while the fetch is in flight waits in _inbox behind it.
+    var _inbox = [];  // [{ ready, data }]
+
+    function _drainInbox() {
+        while (_inbox.length && _inbox[0].ready) {
+            var entry = _inbox.shift();
+            if (entry.data) _deliver(entry.data);
+        }
+    }
+
+    window.__nexus_dispatch = function(data) {
+        if (_inbox.length) {
+            _inbox.push({ ready: true, data: data });
+            return;
+        }
+        _deliver(data);
+    };
+
+    // ---- Binary payload decoders (negotiated via nexus.bridge.negotiate) ----
+    // Both decoders cover the subset nlohmann::json emits: definite-length
+    // containers, integers, floats, strings, byte strings, bool and null.
+    var _utf8 = new TextDecoder('utf-8');
+
+    function _decodeCbor(bytes) {
+        var view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+        var pos = 0;
+        function len(info) {
+            if (info < 24) return info;
+            if (info === 24) { pos += 1; return view.getUint8(pos - 1); }
+            if (info === 25) { pos += 2; return view.getUint16(pos - 2); }
+            if (info === 26) { pos += 4; return view.getUint32(pos - 4); }
+            pos += 8;
+            return view.getUint32(pos - 8) * 4294967296 + view.getUint32(pos - 4);
+        }
+        function item() {
+            var b = view.getUint8(pos++), major = b >> 5, info = b & 31, n, i, out;
+            switch (major) {
+                case 0: return len(info);
+                case 1: return -1 - len(info);
+                case 2: n = len(info); pos += n; return bytes.slice(pos - n, pos);
+                case 3: n = len(info); pos += n; return _utf8.decode(bytes.subarray(pos - n, pos));
+                case 4: n = len(info); out = new Array(n); for (i = 0; i < n; i++) out[i] = item(); return out;
+                case 5: n = len(info); out = {}; for (i = 0; i < n; i++) { var k = item(); out[k] = item(); } return out;
+                case 6: len(info); return item();  // tag: ignore, decode the tagged item
+            }
+            switch (info) {
+                case 20: return false;
+                case 21: return true;
+                case 22: case 23: return null;
+                case 25: {
+                    var h = view.getUint16(pos); pos += 2;
+                    var e = (h >> 10) & 31, m = h & 1023, s = (h & 32768) ? -1 : 1;
+                    if (e === 0) return s * m * Math.pow(2, -24);
+                    if (e === 31) return m ? NaN : s * Infinity;
+                    return s * (1 + m / 1024) * Math.pow(2, e - 15);
+                }
+                case 26: pos += 4; return view.getFloat32(pos - 4);
+                case 27: pos += 8; return view.getFloat64(pos - 8);
+            }
+            throw new Error('Unsupported CBOR item 0x' + b.toString(16));
+        }
+        return item();
+    }
+
+    function _decodeMsgPack(bytes) {
+        var view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+        var pos = 0;
+        function str(n) { pos += n; return _utf8.decode(bytes.subarray(pos - n, pos)); }
+        function bin(n) { pos += n; return bytes.slice(pos - n, pos); }
+        function arr(n) { var out = new Array(n); for (var i = 0; i < n; i++) out[i] = item(); return out; }
+        function map(n) { var out = {}; for (var i = 0; i < n; i++) { var k = item(); out[k] = item(); } return out; }
+        function u8()  { pos += 1; return view.getUint8(pos - 1); }
+        function u16() { pos += 2; return view.getUint16(pos - 2); }
+        function u32() { pos += 4; return view.getUint32(pos - 4); }
+        function item() {
+            var b = view.getUint8(pos++);
+            if (b < 0x80) return b;
+            if (b < 0x90) return map(b & 15);
+            if (b < 0xa0) return arr(b & 15);
+            if (b < 0xc0) return str(b & 31);
+            if (b >= 0xe0) return b - 256;
+            switch (b) {
+                case 0xc0: return null;
+                case 0xc2: return false;
+                case 0xc3: return true;
+                case 0xc4: return bin(u8());
+                case 0xc5: return bin(u16());
+                case 0xc6: return bin(u32());
+                case 0xca: pos += 4; return view.getFloat32(pos - 4);
+                case 0xcb: pos += 8; return view.getFloat64(pos - 8);
+                case 0xcc: return u8();
+                case 0xcd: return u16();
+                case 0xce: return u32();
+                case 0xcf: return u32() * 4294967296 + u32();
+                case 0xd0: pos += 1; return view.getInt8(pos - 1);
+                case 0xd1: pos += 2; return view.getInt16(pos - 2);
+                case 0xd2: pos += 4; return view.getInt32(pos - 4);
+                case 0xd3: { var hi = view.getInt32(pos); pos += 4; return hi * 4294967296 + u32(); }
+                case 0xd9: return str(u8());
+                case 0xda: return str(u16());
+                case 0xdb: return str(u32());
+                case 0xdc: return arr(u16());
+                case 0xdd: return arr(u32());
+                case 0xde: return map(u16());
+                case 0xdf: return map(u32());
+            }
+            throw new Error('Unsupported MessagePack byte 0x' + b.toString(16));
+        }
+        return item();
+    }
+
+    // format: 0 = JSON text, 1 = CBOR, 2 = MessagePack (JsDispatch::Encoding)
+    function _decodePayload(format, bytes) {
+        if (format === 1) return _decodeCbor(bytes);
+        if (format === 2) return _decodeMsgPack(bytes);
+        return JSON.parse(_utf8.decode(bytes));
+    }
+
+    // Medium payloads arrive as one JSON string literal (cheaper than
+    // compiling the payload as JS source).
+    window.__nexus_dispatch_json = function(text) {
+        window.__nexus_dispatch(JSON.parse(text));
+    };
+
+    // Binary payloads arrive base64-encoded.
+    window.__nexus_dispatch_bin = function(format, b64) {
+        var raw = atob(b64);
+        var bytes = new Uint8Array(raw.length);
+        for (var i = 0; i < raw.length; i++) bytes[i] = raw.charCodeAt(i);
+        window.__nexus_dispatch(_decodePayload(format, bytes));
+    };
+
+    // Large payloads are fetched from the addon origin's blob endpoint.
+    window.__nexus_dispatch_blob = function(id, format) {
+        var entry = { ready: false, data: null };
+        _inbox.push(entry);
+        fetch('/__nexus/blob/' + id, { cache: 'no-store' })
+            .then(function(r) { return r.ok ? r.arrayBuffer() : null; })
+            .then(function(buf) { if (buf) entry.data = _decodePayload(format || 0, new Uint8Array(buf)); })
+            .catch(function(e) { console.error('Bridge blob fetch failed:', e); })
+            .then(function() { entry.ready = true; _drainInbox(); });
     };
 
     // ---- Public API: window.nexus ----
+    // Methods that only forward their arguments are generated from the
+    // native API description (bridge_api.h) and installed by _installStubs.
+    // Methods that keep JS-side state are written out here.
     window.nexus = {
-        log: {
-            info:     function(channel, message) { _send({ action: 'log', level: 3, channel: channel, message: message }); },
-            warning:  function(channel, message) { _send({ action: 'log', level: 2, channel: channel, message: message }); },
-            critical: function(channel, message) { _send({ action: 'log', level: 1, channel: channel, message: message }); },
-            debug:    function(channel, message) { _send({ action: 'log', level: 4, channel: channel, message: message }); },
-            trace:    function(channel, message) { _send({ action: 'log', level: 5, channel: channel, message: message }); }
-        },
-
         events: {
-            subscribe: function(name, callback) {
-                if (!_eventCallbacks[name]) {
-                    _eventCallbacks[name] = [];
-                    _send({ action: 'events_subscribe', name: name });
+            // options: { policy: 'all'|'latest'|'coalesce'|'sample', max, key, hz }.
+            // The policy is applied natively and covers every callback of
+            // the event; passing options again replaces it.
+            subscribe: function(name, callback, options) {
+                if (!_eventCallbacks[name] || options) {
+                    var msg = { action: 'events_subscribe', name: name };
+                    if (options) {
+                        if (options.policy) msg.policy = String(options.policy);
+                        if (options.max) msg.max = Math.floor(options.max);
+                        if (options.key) msg.key = String(options.key);
+                        if (options.hz) msg.hz = Math.floor(options.hz);
+                    }
+                    _send(msg);
                 }
+                if (!_eventCallbacks[name]) _eventCallbacks[name] = [];
                 _eventCallbacks[name].push(callback);
             },
+            // options: { op: 'count'|'rate'|'sum'|'latest', field, windowMs, emitHz }.
+            // Aggregated natively; callback(value, count) runs at most emitHz
+            // times per second, when the value changed. Returns { stop() }.
+            aggregate: function(name, options, callback) {
+                options = options || {};
+                var id = 'agg' + (_nextAggregateId++);
+                var msg = { action: 'events_aggregate', id: id, name: name,
+                            op: String(options.op || 'count') };
+                if (options.field) msg.field = String(options.field);
+                if (options.windowMs !== undefined) msg.windowMs = Math.max(0, Math.floor(options.windowMs));
+                if (options.emitHz) msg.emitHz = Math.floor(options.emitHz);
+                _aggregateCallbacks[id] = callback;
+                _send(msg);
+                return {
+                    stop: function() {
+                        if (!_aggregateCallbacks[id]) return;
+                        delete _aggregateCallbacks[id];
+                        _send({ action: 'events_stopAggregate', id: id });
+                    }
+                };
+            },
             unsubscribe: function(name, callback) {
                 var cbs = _eventCallbacks[name];
                 if (!cbs) return;
@@ -120,9 +350,6 @@ static const std::string s_bridgeScript = R"JS(
                     delete _eventCallbacks[name];
                     _send({ action: 'events_unsubscribe', name: name });
                 }
-            },
-            raise: function(name, data) {
-                _send({ action: 'events_raise', name: name });
             }
         },
 
@@ -137,65 +364,23 @@ static const std::string s_bridgeScript = R"JS(
             }
         },
 
-        gamebinds: {
-            press:   function(bind) { _send({ action: 'gamebinds_press', bind: bind }); },
-            release: function(bind) { _send({ action: 'gamebinds_release', bind: bind }); },
-            invoke:  function(bind, durationMs) { _send({ action: 'gamebinds_invoke', bind: bind, durationMs: durationMs }); },
-            isBound: function(bind) { return _sendAsync('gamebinds_isBound', { bind: bind }); }
-        },
-
-        datalink: {
-            getMumbleLink: function() { return _sendAsync('datalink_getMumbleLink'); },
-            getNexusLink:  function() { return _sendAsync('datalink_getNexusLink'); }
-        },
-
-        paths: {
-            getGameDirectory:   function()     { return _sendAsync('paths_getGameDirectory'); },
-            getAddonDirectory:  function(name) { return _sendAsync('paths_getAddonDirectory', { name: name || '' }); },
-            getCommonDirectory: function()     { return _sendAsync('paths_getCommonDirectory'); }
-        },
-
-        quickaccess: {
-            add: function(id, texture, textureHover, keybind, tooltip) {
-                _send({ action: 'quickaccess_add', id: id, texture: texture,
-                         textureHover: textureHover, keybind: keybind, tooltip: tooltip });
-            },
-            remove: function(id) { _send({ action: 'quickaccess_remove', id: id }); },
-            notify: function(id) { _send({ action: 'quickaccess_notify', id: id }); }
-        },
-
-        localization: {
-            translate: function(id) { return _sendAsync('localization_translate', { id: id }); },
-            set: function(id, lang, text) {
-                _send({ action: 'localization_set', id: id, lang: lang, text: text });
+        // Synchronous mirror of MumbleLink / NexusLink, kept current by
+        // nexus.gamestate.subscribe({ hz }). onChange(callback) receives each
+        // delta ({ mumble: {changed fields}, nexus: {...} }) and returns a
+        // function that removes the callback.
+        gamestate: {
+            get mumble() { return _gameState.mumble; },
+            get nexus() { return _gameState.nexus; },
+            onChange: function(callback) {
+                _gameStateCallbacks.push(callback);
+                return function() {
+                    var idx = _gameStateCallbacks.indexOf(callback);
+                    if (idx !== -1) _gameStateCallbacks.splice(idx, 1);
+                };
             }
         },
 
         windows: {
-            create: function(windowId, options) {
-                options = options || {};
-                return _sendAsync('windows_create', {
-                    windowId: windowId,
-                    url: options.url || '',
-                    width: options.width || 800,
-                    height: options.height || 600,
-                    title: options.title || ''
-                });
-            },
-            close: function(windowId) {
-                _send({ action: 'windows_close', windowId: windowId });
-            },
-            update: function(windowId, options) {
-                options = options || {};
-                _send({
-                    action: 'windows_update',
-                    windowId: windowId,
-                    title: options.title,
-                    width: options.width,
-                    height: options.height,
-                    visible: options.visible
-                });
-            },
             setInputPassthrough: function(windowId, value) {
                 var msg = { action: 'windows_setInputPassthrough', windowId: windowId };
                 if (typeof value === 'boolean') {
@@ -206,18 +391,58 @@ static const std::string s_bridgeScript = R"JS(
                     msg.enabled = !!value;
                 }
                 _send(msg);
-            },
-            list: function() {
-                return _sendAsync('windows_list');
             }
-        },
-
-        alert: function(message) { _send({ action: 'alert', message: message }); }
+        }
     };
+
+    // Build a method that maps positional arguments onto message fields.
+    // An argument named '*name' is an options object whose keys are copied.
+    function _makeStub(action, isAsync, args, fixed) {
+        return function() {
+            var msg = {};
+            for (var i = 0; i < args.length; i++) {
+                var value = arguments[i];
+                if (args[i].charAt(0) === '*') {
+                    if (value) {
+                        for (var k in value) {
+                            if (value.hasOwnProperty(k)) msg[k] = value[k];
+                        }
+                    }
+                } else {
+                    msg[args[i]] = value;
+                }
+            }
+            for (var f in fixed) msg[f] = fixed[f];
+            if (isAsync) return _sendAsync(action, msg);
+            msg.action = action;
+            _send(msg);
+        };
+    }
+
+    function _installStubs(target) {
+        for (var i = 0; i < _STUBS.length; i++) {
+            var s = _STUBS[i];
+            var ns = target;
+            if (s[0]) ns = target[s[0]] = target[s[0]] || {};
+            ns[s[1]] = _makeStub(s[2], s[3], s[4], s[5]);
+        }
+    }
+
+    _installStubs(window.nexus);
 })();
 )JS";
 
+static std::string BuildBridgeScript() {
+    std::string script = s_bridgeTemplate;
+    size_t pos = script.find(STUBS_PLACEHOLDER);
+    if (pos != std::string::npos) {
+        script.replace(pos, std::strlen(STUBS_PLACEHOLDER), BridgeApi::GetJsStubs());
+    }
+    return script;
+}
+
 const std::string& GetBridgeScript() {
+    static const std::string s_bridgeScript = BuildBridgeScript();
     return s_bridgeScript;
 }
 
@@ -3,6 +3,11 @@
 #include "addon_manager.h"
 #include "addon_instance.h"
 #include "in_process_browser.h"
+#include "js_dispatch.h"
+#include "bridge_scheduler.h"
+#include "ipc_stats.h"
+#include "asset_cache.h"
+#include "asset_io.h"
 #include "shared/version.h"
 
 #include "imgui.h"
@@ -200,6 +205,64 @@ void Render() {
     }
 }
 
+// Per-addon, per-action bridge call table (IpcStats). Times in microseconds;
+// latency is end to end as measured by the page, for async calls only.
+static void RenderIpcStats() {
+    ImGui::Separator();
+    if (!ImGui::TreeNode("Bridge calls")) return;
+
+    constexpr ImGuiTableFlags flags =
+        ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("ipc_stats", 9, flags)) {
+        ImGui::TableSetupColumn("Addon");
+        ImGui::TableSetupColumn("Action");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("In KB");
+        ImGui::TableSetupColumn("Out KB");
+        ImGui::TableSetupColumn("CPU p50 us");
+        ImGui::TableSetupColumn("CPU p99 us");
+        ImGui::TableSetupColumn("Latency p50 us");
+        ImGui::TableSetupColumn("Latency p99 us");
+        ImGui::TableHeadersRow();
+
+        IpcStats::ForEach([](const std::string& addonId, const IpcStats::AddonStats& stats) {
+            for (size_t i = 0; i < BridgeApi::ACTION_COUNT; ++i) {
+                const IpcStats::ActionStats& action = stats.actions[i];
+                uint64_t calls = action.calls.load(std::memory_order_relaxed);
+                if (calls == 0) continue;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(addonId.c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(BridgeApi::ACTION_NAMES[i].data());
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(calls));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", action.bytesIn.load(std::memory_order_relaxed) / 1024.0);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", action.bytesOut.load(std::memory_order_relaxed) / 1024.0);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(action.cpuUs.Percentile(0.50)));
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(action.cpuUs.Percentile(0.99)));
+                ImGui::TableNextColumn();
+                if (action.latencyUs.GetCount()) {
+                    ImGui::Text("%llu", static_cast<unsigned long long>(action.latencyUs.Percentile(0.50)));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(action.latencyUs.Percentile(0.99)));
+                } else {
+                    ImGui::TextDisabled("-");
+                    ImGui::TableNextColumn();
+                    ImGui::TextDisabled("-");
+                }
+            }
+        });
+        ImGui::EndTable();
+    }
+    ImGui::TreePop();
+}
+
 void RenderOptions() {
     ImGui::SetCurrentContext(static_cast<ImGuiContext*>(Globals::API->ImguiContext));
 
@@ -209,6 +272,27 @@ void RenderOptions() {
     ImGui::Text("Overlay toggle: ALT+SHIFT+L");
     ImGui::Text("Status: %s", Globals::OverlayVisible ? "Visible" : "Hidden");
 
+    // Payloads fanned out to several browsers (JsDispatch shared payloads)
+    const JsDispatch::SharedStats& shared = JsDispatch::GetSharedStats();
+    ImGui::Text("Shared payloads: %llu/%llu lookups hit, %llu/%llu sends reused, %.1f KB saved",
+        static_cast<unsigned long long>(shared.hits),
+        static_cast<unsigned long long>(shared.lookups),
+        static_cast<unsigned long long>(shared.reusedSends),
+        static_cast<unsigned long long>(shared.sends),
+        shared.bytesSaved / 1024.0);
+
+    // Identical files cached by several addons, held once
+    AssetCache::SharedStats assetsShared = AssetCache::GetSharedStats();
+    ImGui::Text("Asset dedup: %.1f MB cached in %.1f MB (%.2fx), %.1f MB saved, %u buffer(s), %llu shared load(s)",
+        assetsShared.cachedBytes / (1024.0 * 1024.0),
+        assetsShared.residentBytes / (1024.0 * 1024.0),
+        assetsShared.residentBytes ? static_cast<double>(assetsShared.cachedBytes) /
+                                     assetsShared.residentBytes : 1.0,
+        assetsShared.cachedBytes > assetsShared.residentBytes
+            ? (assetsShared.cachedBytes - assetsShared.residentBytes) / (1024.0 * 1024.0) : 0.0,
+        assetsShared.buffers,
+        static_cast<unsigned long long>(assetsShared.sharedLoads));
+
     ImGui::Separator();
 
     const auto& addons = AddonManager::GetAddons();
@@ -258,6 +342,80 @@ void RenderOptions() {
                         ptLabel);
                 }
 
+                // Event subscriptions and what their policies filtered out
+                const auto& subscriptions = addon->GetEventSubscriptions();
+                ImGui::Text("Events (%d):", static_cast<int>(subscriptions.size()));
+                for (const auto& [nameId, sub] : subscriptions) {
+                    ImGui::BulletText("%s [%s]: %llu delivered, %llu dropped, %llu coalesced",
+                        sub.eventName.c_str(), EventPolicyName(sub.config.policy),
+                        static_cast<unsigned long long>(sub.delivered),
+                        static_cast<unsigned long long>(sub.dropped),
+                        static_cast<unsigned long long>(sub.coalesced));
+                }
+                for (const auto& [aggId, aggregator] : addon->GetAggregators()) {
+                    ImGui::BulletText("%s [%s]: %.2f (%llu total)",
+                        aggregator->GetEventName().c_str(), AggregateOpName(aggregator->GetOp()),
+                        aggregator->Value(),
+                        static_cast<unsigned long long>(aggregator->GetTotalCount()));
+                }
+                uint32_t overflowEvents = addon->GetDroppedEvents();
+                uint32_t overflowKeybinds = addon->GetDroppedKeybinds();
+                if (overflowEvents || overflowKeybinds) {
+                    ImGui::TextDisabled("Queue overflow: %u event(s), %u keybind(s)",
+                        overflowEvents, overflowKeybinds);
+                }
+
+                // Bridge traffic, time spent on it and rate limiting
+                BridgeScheduler::AddonStats bridge;
+                if (BridgeScheduler::GetStats(addonId, bridge)) {
+                    uint64_t throttled = 0;
+                    for (uint64_t count : bridge.throttled) throttled += count;
+                    ImGui::Text("Bridge: %llu message(s), %llu throttled, queue %u (max %u)",
+                        static_cast<unsigned long long>(bridge.admitted + throttled),
+                        static_cast<unsigned long long>(throttled),
+                        bridge.queued, bridge.maxQueued);
+                    ImGui::Text("Bridge time: %.1f ms worker, %.1f ms render",
+                        bridge.workerUs / 1000.0, bridge.renderUs / 1000.0);
+                    if (bridge.overBudget || bridge.overflowed) {
+                        ImGui::BulletText("Dropped unparsed: %llu over budget (%.0f/s), %llu queue full",
+                            static_cast<unsigned long long>(bridge.overBudget),
+                            BridgeScheduler::GetMessageLimit().ratePerSecond,
+                            static_cast<unsigned long long>(bridge.overflowed));
+                    }
+                    for (size_t i = 0; i < BridgeApi::ACTION_CLASS_COUNT; ++i) {
+                        if (!bridge.throttled[i]) continue;
+                        auto cls = static_cast<BridgeApi::ActionClass>(i);
+                        ImGui::BulletText("%s: %llu throttled (limit %.0f/s)",
+                            BridgeApi::ActionClassName(cls),
+                            static_cast<unsigned long long>(bridge.throttled[i]),
+                            BridgeScheduler::GetLimit(cls).ratePerSecond);
+                    }
+                }
+
+                // Files served over the scheme handler
+                AssetCache::Stats assets;
+                if (AssetCache::GetStats(addonId, assets)) {
+                    ImGui::Text("Assets: %llu hit(s), %llu miss(es), %llu uncached",
+                        static_cast<unsigned long long>(assets.hits),
+                        static_cast<unsigned long long>(assets.misses),
+                        static_cast<unsigned long long>(assets.uncached));
+                    ImGui::Text("Asset cache: %.1f MB in %u file(s), %llu evicted, %.1f MB read, %.1f MB served",
+                        assets.residentBytes / (1024.0 * 1024.0), assets.entries,
+                        static_cast<unsigned long long>(assets.evictions),
+                        assets.bytesRead / (1024.0 * 1024.0),
+                        assets.bytesServed / (1024.0 * 1024.0));
+                }
+                AssetIo::Stats io;
+                if (AssetIo::GetStats(addonId, io)) {
+                    ImGui::Text("Asset I/O: %llu job(s), %.1f ms busy, running %u, queue %u (max %u)",
+                        static_cast<unsigned long long>(io.jobs), io.busyUs / 1000.0,
+                        io.running, io.queued, io.maxQueued);
+                    ImGui::Text("Asset I/O wait: p50 %llu us, p95 %llu us, max %llu us",
+                        static_cast<unsigned long long>(io.queueP50Us),
+                        static_cast<unsigned long long>(io.queueP95Us),
+                        static_cast<unsigned long long>(io.queueMaxUs));
+                }
+
                 // Actions
                 if (state == AddonState::Running) {
                     if (ImGui::Button(("DevTools##dt_" + addonId).c_str())) {
@@ -267,6 +425,7 @@ void RenderOptions() {
                     if (ImGui::Button(("Reload##rl_" + addonId).c_str())) {
                         auto* mainWin = addon->GetWindow("main");
                         if (mainWin && mainWin->browser) {
+                            AssetCache::Invalidate(addonId);
                             mainWin->browser->Reload();
                         }
                     }
@@ -276,6 +435,8 @@ void RenderOptions() {
             }
         }
     }
+
+    RenderIpcStats();
 }
 
 HitTestResult HitTestAll(int clientX, int clientY) {
@@ -0,0 +1,102 @@
+#include "worker_pool.h"
+
+// ---- WorkerPool ----
+
+WorkerPool::WorkerPool(size_t threadCount) {
+    if (threadCount == 0) threadCount = 1;
+    m_threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back([this] { Run(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    Stop();
+}
+
+bool WorkerPool::Post(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return false;
+        m_jobs.push_back(std::move(job));
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+void WorkerPool::Stop() {
+    std::deque<Job> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping && m_threads.empty()) return;
+        m_stopping = true;
+        dropped.swap(m_jobs);
+    }
+    m_wake.notify_all();
+
+    for (std::thread& t : m_threads) {
+        if (t.joinable()) t.join();
+    }
+    m_threads.clear();
+    // `dropped` is destroyed here, outside the lock
+}
+
+size_t WorkerPool::GetPending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobs.size();
+}
+
+void WorkerPool::Run() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+// ---- RenderBatch ----
+
+namespace RenderBatch {
+
+static std::mutex                  s_mutex;
+static std::vector<WorkerPool::Job> s_jobs;
+static std::vector<WorkerPool::Job> s_running; // render thread
+
+void Post(WorkerPool::Job job) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_jobs.push_back(std::move(job));
+}
+
+size_t Run() {
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_jobs.empty()) return 0;
+        s_running.swap(s_jobs);
+    }
+
+    size_t count = s_running.size();
+    for (WorkerPool::Job& job : s_running) job();
+    s_running.clear();
+    return count;
+}
+
+void Clear() {
+    std::vector<WorkerPool::Job> dropped;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        dropped.swap(s_jobs);
+    }
+}
+
+size_t GetPending() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_jobs.size();
+}
+
+} // namespace RenderBatch
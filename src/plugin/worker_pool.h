@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads draining one FIFO job queue. With a
+// single thread, jobs run strictly in the order they were posted.
+class WorkerPool {
+public:
+    using Job = std::function<void()>;
+
+    explicit WorkerPool(size_t threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Queue a job. Returns false (and drops it) once the pool is stopping.
+    bool Post(Job job);
+
+    // Drop queued jobs, let running ones finish, and join the threads.
+    void Stop();
+
+    size_t GetPending() const;
+
+private:
+    void Run();
+
+    mutable std::mutex       m_mutex;
+    std::condition_variable  m_wake;
+    std::deque<Job>          m_jobs;
+    std::vector<std::thread> m_threads;
+    bool                     m_stopping = false;
+};
+
+// Work handed back to the render thread (CEF UI thread), run in one batch
+// per frame from AddonManager::FlushAllPendingEvents.
+namespace RenderBatch {
+
+// Queue a job for the next batch (any thread).
+void Post(WorkerPool::Job job);
+
+// Run every job queued so far (render thread). Jobs posted while the batch
+// runs wait for the next one. Returns the number of jobs run.
+size_t Run();
+
+// Drop queued jobs without running them (shutdown).
+void Clear();
+
+// Jobs waiting for the next batch (any thread).
+size_t GetPending();
+
+} // namespace RenderBatch
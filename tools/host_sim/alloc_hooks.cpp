@@ -0,0 +1,47 @@
+#include "sim_host.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Global operator new/delete, counting every allocation made by the core
+// (and by the harness, which keeps its own allocations out of the measured
+// part of the frame).
+
+static std::atomic<uint64_t> s_allocations{0};
+static std::atomic<uint64_t> s_bytes{0};
+
+namespace SimAlloc {
+
+Counters Read() {
+    return { s_allocations.load(std::memory_order_relaxed), s_bytes.load(std::memory_order_relaxed) };
+}
+
+} // namespace SimAlloc
+
+static void* Allocate(std::size_t size, std::size_t alignment) {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+
+    void* p = alignment > alignof(std::max_align_t)
+        ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+        : std::malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size) { return Allocate(size, 0); }
+void* operator new[](std::size_t size) { return Allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al) { return Allocate(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return Allocate(size, static_cast<std::size_t>(al)); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
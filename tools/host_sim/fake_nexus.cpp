@@ -0,0 +1,252 @@
+#include "fake_nexus.h"
+#include "globals.h"
+#include "mumble_link.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// The API table is filled with captureless lambdas. Parameters are `auto`
+// where possible, so the table keeps compiling if a Nexus.h revision changes
+// an enum or typedef; the arity and return types must still match.
+
+namespace FakeNexus {
+
+static AddonAPI_t  s_api = {};
+static std::string s_addonRoot;
+static bool        s_verbose = false;
+
+static std::mutex                                   s_mutex;
+static std::map<std::string, std::vector<EVENT_CONSUME>> s_events;
+static std::map<std::string, INPUTBINDS_PROCESS>     s_keybinds;
+static std::vector<std::string>                      s_keybindOrder;
+static std::vector<WNDPROC_CALLBACK>                 s_wndProcs;
+static std::map<std::string, std::string>            s_strings;      // stable c_str()s
+static std::map<std::string, const char*>           s_translations; // Localization_Set, any language
+
+static std::atomic<uint64_t> s_logs[LOGL_ALL + 1];
+static std::atomic<uint64_t> s_raised{0};
+static std::atomic<uint64_t> s_eventCallbacks{0};
+static std::atomic<uint64_t> s_keybindsFired{0};
+static std::atomic<uint64_t> s_gameBinds{0};
+static std::atomic<uint64_t> s_alerts{0};
+static std::atomic<uint64_t> s_wndProc{0};
+static std::atomic<uint64_t> s_wndProcConsumed{0};
+
+static LinkedMem       s_mumble = {};
+static NexusLinkData_t s_nexus = {};
+
+static const char* StoreString(const std::string& str) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_strings.emplace(str, str).first->second.c_str();
+}
+
+static void Log(int level, const char* channel, const char* message) {
+    if (level < 0 || level > LOGL_ALL) level = LOGL_ALL;
+    s_logs[level].fetch_add(1, std::memory_order_relaxed);
+    if (s_verbose || (level != LOGL_OFF && level <= LOGL_WARNING)) {
+        static const char* NAMES[] = { "OFF", "CRITICAL", "WARNING", "INFO", "DEBUG", "TRACE", "ALL" };
+        std::fprintf(stderr, "[%s] %s: %s\n", NAMES[level], channel ? channel : "", message ? message : "");
+    }
+}
+
+static void* ImguiMalloc(size_t size, void*) { return std::malloc(size); }
+static void  ImguiFree(void* p, void*) { std::free(p); }
+
+AddonAPI_t* Initialize(const std::string& addonRoot, void* imguiContext, bool verbose) {
+    s_addonRoot = addonRoot;
+    s_verbose = verbose;
+
+    s_api = {};
+    s_api.SwapChain    = nullptr;  // D3D11Texture is stubbed out
+    s_api.ImguiContext = imguiContext;
+    s_api.ImguiMalloc  = reinterpret_cast<void*>(ImguiMalloc);
+    s_api.ImguiFree    = reinterpret_cast<void*>(ImguiFree);
+
+    s_api.GUI_Register   = [](auto, auto) {};
+    s_api.GUI_Deregister = [](auto) {};
+    s_api.GUI_SendAlert  = [](auto) { s_alerts.fetch_add(1, std::memory_order_relaxed); };
+
+    s_api.Log = [](auto level, auto channel, auto message) {
+        Log(static_cast<int>(level), channel, message);
+    };
+
+    s_api.Events_Subscribe = [](auto identifier, auto callback) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_events[identifier].push_back(callback);
+    };
+    s_api.Events_Unsubscribe = [](auto identifier, auto callback) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto it = s_events.find(identifier);
+        if (it == s_events.end()) return;
+        auto& callbacks = it->second;
+        for (size_t i = 0; i < callbacks.size(); ++i) {
+            if (callbacks[i] == callback) {
+                callbacks.erase(callbacks.begin() + i);
+                break;
+            }
+        }
+    };
+    s_api.Events_RaiseNotification = [](auto identifier) { RaiseEvent(identifier, nullptr); };
+
+    s_api.WndProc_Register = [](auto callback) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_wndProcs.push_back(callback);
+    };
+    s_api.WndProc_Deregister = [](auto callback) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (size_t i = 0; i < s_wndProcs.size(); ++i) {
+            if (s_wndProcs[i] == callback) {
+                s_wndProcs.erase(s_wndProcs.begin() + i);
+                break;
+            }
+        }
+    };
+
+    s_api.InputBinds_RegisterWithString = [](auto identifier, auto callback, auto) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (!s_keybinds.count(identifier)) s_keybindOrder.push_back(identifier);
+        s_keybinds[identifier] = callback;
+    };
+    s_api.InputBinds_Deregister = [](auto identifier) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_keybinds.erase(identifier);
+    };
+
+    s_api.GameBinds_PressAsync   = [](auto) { s_gameBinds.fetch_add(1, std::memory_order_relaxed); };
+    s_api.GameBinds_ReleaseAsync = [](auto) { s_gameBinds.fetch_add(1, std::memory_order_relaxed); };
+    s_api.GameBinds_InvokeAsync  = [](auto, auto) { s_gameBinds.fetch_add(1, std::memory_order_relaxed); };
+    s_api.GameBinds_IsBound      = [](auto) { return true; };
+
+    s_api.Paths_GetGameDirectory   = []() { return StoreString(s_addonRoot + "/.."); };
+    s_api.Paths_GetAddonDirectory  = [](auto name) {
+        return StoreString(name && *name ? s_addonRoot + "/" + name : s_addonRoot);
+    };
+    s_api.Paths_GetCommonDirectory = []() { return StoreString(s_addonRoot + "/common"); };
+
+    s_api.DataLink_Get = [](auto identifier) -> void* {
+        std::string id(identifier);
+        if (id == DL_MUMBLE_LINK) return &s_mumble;
+        if (id == DL_NEXUS_LINK) return &s_nexus;
+        return nullptr;
+    };
+
+    s_api.QuickAccess_Add    = [](auto, auto, auto, auto, auto) {};
+    s_api.QuickAccess_Remove = [](auto) {};
+    s_api.QuickAccess_Notify = [](auto) {};
+
+    s_api.Localization_Translate = [](auto identifier) -> const char* {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto it = s_translations.find(identifier);
+        return it == s_translations.end() ? identifier : it->second;
+    };
+    s_api.Localization_Set = [](auto identifier, auto, auto text) {
+        const char* stored = StoreString(text);
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_translations[identifier] = stored;
+    };
+
+    s_mumble.uiVersion = 2;
+    std::swprintf(s_mumble.name, 256, L"Guild Wars 2");
+    std::swprintf(s_mumble.identity, 256, L"{\"name\":\"Sim Character\",\"map_id\":15}");
+    s_nexus.Width = 1920;
+    s_nexus.Height = 1080;
+    s_nexus.Scaling = 1.0f;
+    s_nexus.IsGameplay = true;
+
+    Globals::API = &s_api;
+    return &s_api;
+}
+
+void RaiseEvent(const char* identifier, void* args) {
+    s_raised.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<EVENT_CONSUME> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto it = s_events.find(identifier);
+        if (it == s_events.end()) return;
+        callbacks = it->second;
+    }
+    for (EVENT_CONSUME callback : callbacks) callback(args);
+    s_eventCallbacks.fetch_add(callbacks.size(), std::memory_order_relaxed);
+}
+
+bool TriggerKeybind(const std::string& identifier, bool isRelease) {
+    INPUTBINDS_PROCESS callback = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto it = s_keybinds.find(identifier);
+        if (it == s_keybinds.end()) return false;
+        callback = it->second;
+    }
+    callback(identifier.c_str(), isRelease);
+    s_keybindsFired.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::string GetKeybind(size_t index) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return index < s_keybindOrder.size() ? s_keybindOrder[index] : std::string();
+}
+
+size_t GetKeybindCount() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_keybindOrder.size();
+}
+
+UINT SendWndProc(UINT msg, WPARAM wParam, LPARAM lParam) {
+    std::vector<WNDPROC_CALLBACK> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        callbacks = s_wndProcs;
+    }
+    s_wndProc.fetch_add(1, std::memory_order_relaxed);
+    for (WNDPROC_CALLBACK callback : callbacks) {
+        if (callback(nullptr, msg, wParam, lParam) == 0) {
+            s_wndProcConsumed.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        }
+    }
+    return msg;
+}
+
+void TickDataLink(uint64_t frame) {
+    // Walk a circle; the camera trails the avatar. Identity (a wide-string
+    // field, expensive to decode) changes every 600 frames.
+    float t = static_cast<float>(frame) / 60.0f;
+    s_mumble.uiTick = static_cast<uint32_t>(frame);
+    s_mumble.fAvatarPosition[0] = 100.0f * std::cos(t);
+    s_mumble.fAvatarPosition[2] = 100.0f * std::sin(t);
+    s_mumble.fAvatarFront[0] = -std::sin(t);
+    s_mumble.fAvatarFront[2] = std::cos(t);
+    s_mumble.fCameraPosition[0] = s_mumble.fAvatarPosition[0] + 5.0f * std::sin(t);
+    s_mumble.fCameraPosition[1] = 3.0f;
+    s_mumble.fCameraPosition[2] = s_mumble.fAvatarPosition[2] - 5.0f * std::cos(t);
+    if (frame % 600 == 0) {
+        std::swprintf(s_mumble.identity, 256,
+            L"{\"name\":\"Sim Character\",\"map_id\":%u}", static_cast<unsigned>(15 + frame / 600));
+    }
+    s_nexus.IsMoving = (frame / 120) % 2 == 0;
+    s_nexus.IsCameraMoving = s_nexus.IsMoving;
+}
+
+Counters GetCounters() {
+    Counters c;
+    for (int i = 0; i <= LOGL_ALL; ++i) c.logs[i] = s_logs[i].load(std::memory_order_relaxed);
+    c.events          = s_raised.load(std::memory_order_relaxed);
+    c.eventCallbacks  = s_eventCallbacks.load(std::memory_order_relaxed);
+    c.keybinds        = s_keybindsFired.load(std::memory_order_relaxed);
+    c.gameBinds       = s_gameBinds.load(std::memory_order_relaxed);
+    c.alerts          = s_alerts.load(std::memory_order_relaxed);
+    c.wndProc         = s_wndProc.load(std::memory_order_relaxed);
+    c.wndProcConsumed = s_wndProcConsumed.load(std::memory_order_relaxed);
+    return c;
+}
+
+} // namespace FakeNexus
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <windows.h>
+#include "Nexus.h"
+
+#include <cstdint>
+#include <string>
+
+// In-process stand-in for the Nexus host: the AddonAPI_t table the core
+// calls into, plus the game-side hooks the driver uses to fire events,
+// keybinds, WndProc messages and DataLink updates.
+namespace FakeNexus {
+
+// Build the API table and point Globals::API at it. `addonRoot` is the
+// directory Paths_GetAddonDirectory resolves names under; `imguiContext`
+// is the context the core's overlay renders into.
+AddonAPI_t* Initialize(const std::string& addonRoot, void* imguiContext, bool verbose);
+
+// Raise a Nexus event with the given args, on the calling thread (the game
+// thread in the real host).
+void RaiseEvent(const char* identifier, void* args);
+
+// Fire a registered input bind. Returns false if nothing is bound to it.
+bool TriggerKeybind(const std::string& identifier, bool isRelease);
+
+// Identifier of the n-th registered input bind (registration order), or
+// empty if there are fewer.
+std::string GetKeybind(size_t index);
+size_t GetKeybindCount();
+
+// Pass a window message through the registered WndProc callbacks. Returns
+// 0 if one consumed it (Nexus convention), otherwise the message.
+UINT SendWndProc(UINT msg, WPARAM wParam, LPARAM lParam);
+
+// Advance the synthetic MumbleLink / NexusLink blocks by one frame.
+void TickDataLink(uint64_t frame);
+
+struct Counters {
+    uint64_t logs[LOGL_ALL + 1] = {};
+    uint64_t events = 0;         // events raised (driver and core)
+    uint64_t eventCallbacks = 0; // callbacks run for them
+    uint64_t keybinds = 0;
+    uint64_t gameBinds = 0;
+    uint64_t alerts = 0;
+    uint64_t wndProc = 0;
+    uint64_t wndProcConsumed = 0;
+};
+
+Counters GetCounters();
+
+} // namespace FakeNexus
@@ -0,0 +1,577 @@
+// host_sim: runs the plugin core headlessly against a fake Nexus host and a
+// stub CEF browser, and reports what each frame costs on the render thread.
+//
+// Each frame mirrors the real host: the game thread fires Nexus events and
+// keybinds, pages send bridge messages, the input trace goes through the
+// WndProc, then the render thread runs what OnPreRender / OnRender /
+// OnOptionsRender run (watchdog, frame flush, event flush, overlay).
+
+#include "fake_nexus.h"
+#include "sim_cef.h"
+#include "sim_host.h"
+
+#include "addon_instance.h"
+#include "addon_manager.h"
+#include "bridge_scheduler.h"
+#include "globals.h"
+#include "input_handler.h"
+#include "ipc_handler.h"
+#include "ipc_stats.h"
+#include "overlay.h"
+#include "worker_pool.h"
+
+#include "imgui.h"
+#include "nlohmann/json.hpp"
+
+#include <windows.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+struct Options {
+    int         addons = 4;
+    int         windows = 2;     // per addon, including "main"
+    int         frames = 600;
+    int         warmup = 60;     // frames left out of the summary
+    int         msgs = 2;        // bridge messages per page per frame
+    int         events = 8;      // Nexus events per frame (game thread)
+    std::string trace;           // input trace file; built-in pattern if empty
+    std::string csv;             // per-frame samples
+    bool        pace = false;    // hold frames to 16 ms of wall time
+    bool        ipcStats = false;
+    bool        verbose = false;
+};
+
+static void Usage() {
+    std::fprintf(stderr,
+        "usage: host_sim [--addons N] [--windows M] [--frames F] [--warmup W]\n"
+        "                [--msgs K] [--events E] [--trace FILE] [--csv FILE]\n"
+        "                [--pace] [--ipc-stats] [--verbose]\n"
+        "Bridge rate limits refill in wall time: without --pace, frames run\n"
+        "back to back and pages are throttled sooner than at 60 fps.\n");
+}
+
+static bool ParseOptions(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if      (arg == "--addons"  && (v = next())) o.addons = std::atoi(v);
+        else if (arg == "--windows" && (v = next())) o.windows = std::atoi(v);
+        else if (arg == "--frames"  && (v = next())) o.frames = std::atoi(v);
+        else if (arg == "--warmup"  && (v = next())) o.warmup = std::atoi(v);
+        else if (arg == "--msgs"    && (v = next())) o.msgs = std::atoi(v);
+        else if (arg == "--events"  && (v = next())) o.events = std::atoi(v);
+        else if (arg == "--trace"   && (v = next())) o.trace = v;
+        else if (arg == "--csv"     && (v = next())) o.csv = v;
+        else if (arg == "--pace")      o.pace = true;
+        else if (arg == "--ipc-stats") o.ipcStats = true;
+        else if (arg == "--verbose")   o.verbose = true;
+        else return false;
+    }
+    o.addons = std::max(o.addons, 1);
+    o.windows = std::max(o.windows, 1);
+    o.frames = std::max(o.frames, 1);
+    o.warmup = std::clamp(o.warmup, 0, o.frames - 1);
+    return true;
+}
+
+// ---- Input trace ----
+//
+// One event per line, "<frame> <kind> <args...>", '#' starts a comment:
+//   move X Y          mouse move (client coordinates)
+//   down|up B X Y     button l, r or m
+//   wheel X Y DELTA
+//   key VK down|up    virtual key (decimal); 16/17/18 also set modifiers
+//   char C            character code (decimal)
+//   bind N press|release   the N-th input bind registered with Nexus
+
+struct InputEvent {
+    int         frame = 0;
+    std::string kind;
+    std::string a, b;
+    int         x = 0, y = 0, value = 0;
+};
+
+static bool LoadTrace(const std::string& path, std::vector<InputEvent>& out) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::istringstream in(line);
+        InputEvent e;
+        if (!(in >> e.frame >> e.kind)) continue;
+        if (e.kind == "move")                        in >> e.x >> e.y;
+        else if (e.kind == "down" || e.kind == "up") in >> e.a >> e.x >> e.y;
+        else if (e.kind == "wheel")                  in >> e.x >> e.y >> e.value;
+        else if (e.kind == "key")                    in >> e.value >> e.b;
+        else if (e.kind == "char")                   in >> e.value;
+        else if (e.kind == "bind")                   in >> e.value >> e.b;
+        else continue;
+        out.push_back(e);
+    }
+    std::stable_sort(out.begin(), out.end(),
+        [](const InputEvent& l, const InputEvent& r) { return l.frame < r.frame; });
+    return true;
+}
+
+// Built-in pattern: the cursor sweeps over the first window, with a click,
+// a typed key and a keybind press at regular intervals.
+static void BuiltinInput(int frame, std::vector<InputEvent>& out) {
+    int x = 120 + (frame * 7) % 600;
+    int y = 140 + (frame * 3) % 400;
+    out.push_back({ frame, "move", "", "", x, y, 0 });
+    if (frame % 30 == 0) {
+        out.push_back({ frame, "down", "l", "", x, y, 0 });
+        out.push_back({ frame, "up", "l", "", x, y, 0 });
+    }
+    if (frame % 45 == 0) {
+        out.push_back({ frame, "key", "", "down", 0, 0, 'A' });
+        out.push_back({ frame, "char", "", "", 0, 0, 'a' });
+        out.push_back({ frame, "key", "", "up", 0, 0, 'A' });
+    }
+    if (frame % 20 == 0) out.push_back({ frame, "wheel", "", "", x, y, -120 });
+    if (frame % 90 == 0) {
+        out.push_back({ frame, "bind", "", "press", 0, 0, 0 });
+        out.push_back({ frame, "bind", "", "release", 0, 0, 0 });
+    }
+}
+
+static void DispatchInput(const InputEvent& e) {
+    ImGuiIO& io = ImGui::GetIO();
+    LPARAM pos = MAKELPARAM(e.x, e.y);
+
+    if (e.kind == "move") {
+        io.MousePos = ImVec2(static_cast<float>(e.x), static_cast<float>(e.y));
+        FakeNexus::SendWndProc(WM_MOUSEMOVE, 0, pos);
+    } else if (e.kind == "down" || e.kind == "up") {
+        bool down = e.kind == "down";
+        int button = e.a == "r" ? 1 : e.a == "m" ? 2 : 0;
+        static const UINT DOWN[] = { WM_LBUTTONDOWN, WM_RBUTTONDOWN, WM_MBUTTONDOWN };
+        static const UINT UP[]   = { WM_LBUTTONUP,   WM_RBUTTONUP,   WM_MBUTTONUP };
+        io.MousePos = ImVec2(static_cast<float>(e.x), static_cast<float>(e.y));
+        io.MouseDown[button] = down;
+        FakeNexus::SendWndProc(down ? DOWN[button] : UP[button], 0, pos);
+    } else if (e.kind == "wheel") {
+        io.MouseWheel += e.value / 120.0f;
+        FakeNexus::SendWndProc(WM_MOUSEWHEEL, MAKEWPARAM(0, e.value), pos);
+    } else if (e.kind == "key") {
+        bool down = e.b == "down";
+        SimKeys::SetDown(e.value, down);
+        FakeNexus::SendWndProc(down ? WM_KEYDOWN : WM_KEYUP, static_cast<WPARAM>(e.value), 0);
+    } else if (e.kind == "char") {
+        FakeNexus::SendWndProc(WM_CHAR, static_cast<WPARAM>(e.value), 0);
+    } else if (e.kind == "bind") {
+        std::string id = FakeNexus::GetKeybind(static_cast<size_t>(e.value));
+        if (!id.empty()) FakeNexus::TriggerKeybind(id, e.b == "release");
+    }
+}
+
+// ---- Pages ----
+
+static uint64_t s_nextRequestId = 1;
+
+// What a page does once after its bridge loads: subscribe to events, game
+// state and a keybind; the main window opens the addon's other windows.
+// Pairs whose second message must see the first: a Render handler followed
+// by a Worker one. Sent first, while the page's buckets are still full.
+static void CheckOrder(SimCef::SimPage& page) {
+    std::string tag = page.GetAddonId() + "_" + page.GetWindowId();
+
+    std::string id = "sim.order." + tag;
+    std::string text = "SIM_TRANSLATED_" + tag;
+    page.Send({ { "action", "localization_set" }, { "id", id }, { "lang", "en" }, { "text", text } });
+    page.Send({ { "action", "localization_translate" }, { "requestId", s_nextRequestId++ }, { "id", id } });
+    page.Expect(text);
+
+    // Events are delivered to the addon's main window only
+    if (page.GetWindowId() != "main") return;
+    std::string name = "SIM_ORDER_" + tag;
+    page.Send({ { "action", "events_subscribe" }, { "name", name } });
+    page.Send({ { "action", "events_raise" }, { "name", name } });
+    page.Expect(name);
+}
+
+static void SetupPage(SimCef::SimPage& page, const Options& o) {
+    CheckOrder(page);
+    page.Send({ { "action", "events_subscribe" }, { "name", "EV_ADDON_LOADED" } });
+    page.Send({ { "action", "events_subscribe" }, { "name", "SIM_TICK" }, { "policy", "latest" } });
+    page.Send({ { "action", "gamestate_subscribe" }, { "hz", 30 } });
+
+    if (page.GetWindowId() == "main") {
+        page.Send({ { "action", "keybinds_register" }, { "id", "toggle" }, { "defaultBind", "ALT+K" } });
+        for (int w = 1; w < o.windows; ++w) {
+            page.Send({ { "action", "windows_create" }, { "requestId", s_nextRequestId++ },
+                        { "windowId", "w" + std::to_string(w) }, { "url", "index.html" },
+                        { "width", 400 }, { "height", 300 } });
+        }
+    }
+}
+
+// Steady-state traffic: a mix of the bridge's action classes.
+static void SendTraffic(SimCef::SimPage& page, int frame, int count) {
+    for (int i = 0; i < count; ++i) {
+        switch ((frame + i) % 5) {
+        case 0:
+            page.Send({ { "action", "log" }, { "level", 4 }, { "channel", "sim" },
+                        { "message", "frame " + std::to_string(frame) } });
+            break;
+        case 1:
+            page.Send({ { "action", "events_raise" }, { "name", "SIM_PAGE" } });
+            break;
+        case 2:
+            page.Send({ { "action", "datalink_getMumbleLink" }, { "requestId", s_nextRequestId++ } });
+            break;
+        case 3:
+            page.Send({ { "action", "windows_list" }, { "requestId", s_nextRequestId++ } });
+            break;
+        default:
+            page.Send({ { "action", "localization_translate" }, { "requestId", s_nextRequestId++ },
+                        { "id", "sim.greeting" } });
+            break;
+        }
+    }
+}
+
+// ---- Measurement ----
+
+static uint64_t ThreadCpuUs() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+struct FrameSample {
+    uint64_t bridgeUs = 0;    // render-thread CPU handing page messages to the core
+    uint64_t frameUs = 0;     // render-thread CPU in the frame callbacks
+    uint64_t allocations = 0; // all threads, both sections
+    uint64_t allocBytes = 0;
+    uint64_t schedulerQueued = 0;  // bridge messages waiting for the worker
+    uint64_t renderBatch = 0;      // worker results waiting for the render thread
+    uint64_t eventQueue = 0;       // records in the addons' event rings
+    uint64_t keybindQueue = 0;
+};
+
+struct Summary {
+    const char* name;
+    uint64_t FrameSample::* field;
+};
+
+static void PrintSummary(const std::vector<FrameSample>& samples) {
+    static const Summary ROWS[] = {
+        { "frame cpu (us)",     &FrameSample::frameUs },
+        { "bridge cpu (us)",    &FrameSample::bridgeUs },
+        { "allocations",        &FrameSample::allocations },
+        { "allocated bytes",    &FrameSample::allocBytes },
+        { "scheduler queued",   &FrameSample::schedulerQueued },
+        { "render batch",       &FrameSample::renderBatch },
+        { "event queue",        &FrameSample::eventQueue },
+        { "keybind queue",      &FrameSample::keybindQueue },
+    };
+
+    std::printf("\n%-18s %10s %10s %10s %10s %10s\n", "per frame", "mean", "p50", "p95", "p99", "max");
+    std::vector<uint64_t> values(samples.size());
+    for (const Summary& row : ROWS) {
+        double sum = 0;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            values[i] = samples[i].*row.field;
+            sum += static_cast<double>(values[i]);
+        }
+        std::sort(values.begin(), values.end());
+        auto at = [&](double q) { return values[static_cast<size_t>(q * (values.size() - 1))]; };
+        std::printf("%-18s %10.1f %10llu %10llu %10llu %10llu\n", row.name, sum / values.size(),
+            static_cast<unsigned long long>(at(0.50)), static_cast<unsigned long long>(at(0.95)),
+            static_cast<unsigned long long>(at(0.99)), static_cast<unsigned long long>(values.back()));
+    }
+}
+
+// Let the bridge worker finish what the pages sent, so the frame sees the
+// same render batch from run to run.
+static void WaitForWorker(const std::vector<std::string>& addonIds) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (std::chrono::steady_clock::now() < deadline) {
+        uint64_t queued = 0;
+        for (const std::string& id : addonIds) {
+            BridgeScheduler::AddonStats stats;
+            if (BridgeScheduler::GetStats(id, stats)) queued += stats.queued;
+        }
+        if (queued == 0) return;
+        std::this_thread::yield();
+    }
+}
+
+// ---- Setup ----
+
+static bool WriteAddons(const fs::path& root, int count, std::vector<std::string>& ids) {
+    std::error_code ec;
+    fs::create_directories(root / "jsloader", ec);
+    if (ec) return false;
+
+    for (int i = 0; i < count; ++i) {
+        std::string id = "sim" + std::to_string(i);
+        fs::path dir = root / "jsloader" / id;
+        fs::create_directories(dir, ec);
+        if (ec) return false;
+
+        json manifest = {
+            { "name", "Sim Addon " + std::to_string(i) },
+            { "version", "1.0.0" },
+            { "author", "host_sim" },
+            { "description", "Synthetic addon" },
+            { "entry", "index.html" },
+            { "preload", json::array({ "*.js" }) },
+        };
+        std::ofstream(dir / "manifest.json") << manifest.dump(2);
+        std::ofstream(dir / "index.html") << "<!doctype html><title>sim</title>\n";
+        std::ofstream(dir / "app.js") << "console.log('sim');\n";
+        ids.push_back(id);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!ParseOptions(argc, argv, o)) {
+        Usage();
+        return 2;
+    }
+
+    std::vector<InputEvent> trace;
+    if (!o.trace.empty() && !LoadTrace(o.trace, trace)) {
+        std::fprintf(stderr, "host_sim: cannot read trace %s\n", o.trace.c_str());
+        return 1;
+    }
+
+    fs::path root = fs::temp_directory_path() / ("host_sim_" + std::to_string(getpid()));
+    std::vector<std::string> addonIds;
+    if (!WriteAddons(root, o.addons, addonIds)) {
+        std::fprintf(stderr, "host_sim: cannot write addons under %s\n", root.string().c_str());
+        return 1;
+    }
+
+    // ImGui as Nexus sets it up: one shared context, fonts built, a display
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+    io.IniFilename = nullptr;
+    unsigned char* fontPixels = nullptr;
+    int fontW = 0, fontH = 0;
+    io.Fonts->GetTexDataAsRGBA32(&fontPixels, &fontW, &fontH);
+
+    FakeNexus::Initialize(root.string(), ImGui::GetCurrentContext(), o.verbose);
+
+    // AddonLoad, minus what only the real host can do
+    InputHandler::Initialize();
+    Globals::IsLoaded = true;
+    Globals::OverlayVisible = true;
+    AddonManager::Preload();
+    AddonManager::Initialize();
+
+    WorkerPool gameThread(1);
+    std::ofstream csv;
+    if (!o.csv.empty()) {
+        csv.open(o.csv);
+        csv << "frame,frame_us,bridge_us,allocations,alloc_bytes,scheduler_queued,render_batch,"
+               "event_queue,keybind_queue\n";
+    }
+
+    std::vector<FrameSample> samples;
+    samples.reserve(o.frames);
+    std::vector<InputEvent> frameInput;
+    size_t traceIndex = 0;
+    int eventArg = 0;
+
+    auto frameStart = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < o.frames; ++frame) {
+        if (o.pace) {
+            frameStart += std::chrono::milliseconds(16);
+            std::this_thread::sleep_until(frameStart);
+        }
+        SimClock::Advance(16);
+        FakeNexus::TickDataLink(static_cast<uint64_t>(frame));
+        io.DeltaTime = 1.0f / 60.0f;
+
+        // Game thread: Nexus events, one with a payload codec
+        std::promise<void> fired;
+        gameThread.Post([&]() {
+            for (int i = 0; i < o.events; ++i) {
+                if (i % 4 == 0) FakeNexus::RaiseEvent("EV_ADDON_LOADED", &eventArg);
+                else FakeNexus::RaiseEvent("SIM_TICK", nullptr);
+            }
+            fired.set_value();
+        });
+        fired.get_future().wait();
+
+        // Browsers created last frame come up; pages load and get the bridge
+        SimCef::Pump();
+
+        FrameSample sample;
+        SimAlloc::Counters allocStart = SimAlloc::Read();
+
+        // Pages send their messages (CEF UI thread = render thread)
+        uint64_t cpuStart = ThreadCpuUs();
+        SimCef::ForEachPage([&](SimCef::SimPage& page) {
+            if (!page.IsBridgeLoaded()) return;
+            if (page.driverState == 0) {
+                SetupPage(page, o);
+                page.driverState = 1;
+            }
+            SendTraffic(page, frame, o.msgs);
+        });
+        sample.bridgeUs = ThreadCpuUs() - cpuStart;
+
+        // Input for this frame, through the WndProc
+        frameInput.clear();
+        if (o.trace.empty()) {
+            BuiltinInput(frame, frameInput);
+        } else {
+            while (traceIndex < trace.size() && trace[traceIndex].frame <= frame) {
+                frameInput.push_back(trace[traceIndex++]);
+            }
+        }
+        for (const InputEvent& e : frameInput) DispatchInput(e);
+
+        WaitForWorker(addonIds);
+
+        // Queue depths as the frame starts
+        sample.renderBatch = RenderBatch::GetPending();
+        for (const std::string& id : addonIds) {
+            BridgeScheduler::AddonStats stats;
+            if (BridgeScheduler::GetStats(id, stats)) sample.schedulerQueued += stats.queued;
+            if (AddonInstance* addon = AddonManager::GetAddon(id)) {
+                sample.eventQueue += addon->GetQueuedEvents();
+                sample.keybindQueue += addon->GetQueuedKeybinds();
+            }
+        }
+
+        // OnPreRender, OnRender, OnOptionsRender
+        cpuStart = ThreadCpuUs();
+        ImGui::NewFrame();
+        AddonManager::CheckWatchdog();
+        AddonManager::FlushAllFrames();
+        AddonManager::FlushAllPendingEvents();
+        Overlay::Render();
+        ImGui::Begin("Nexus Options");
+        Overlay::RenderOptions();
+        ImGui::End();
+        ImGui::Render();
+        sample.frameUs = ThreadCpuUs() - cpuStart;
+        io.MouseWheel = 0.0f;
+
+        SimAlloc::Counters allocEnd = SimAlloc::Read();
+        sample.allocations = allocEnd.allocations - allocStart.allocations;
+        sample.allocBytes = allocEnd.bytes - allocStart.bytes;
+
+        if (csv.is_open()) {
+            csv << frame << ',' << sample.frameUs << ',' << sample.bridgeUs << ','
+                << sample.allocations << ',' << sample.allocBytes << ','
+                << sample.schedulerQueued << ',' << sample.renderBatch << ','
+                << sample.eventQueue << ',' << sample.keybindQueue << '\n';
+        }
+        if (frame >= o.warmup) samples.push_back(sample);
+    }
+
+    // ---- Report ----
+
+    uint64_t sent = 0, sentBytes = 0, scripts = 0, scriptBytes = 0, inputEvents = 0;
+    size_t pages = 0, outOfOrder = 0, unchecked = 0, unanswered = 0;
+    SimCef::ForEachPage([&](SimCef::SimPage& page) {
+        const SimCef::PageStats& stats = page.GetStats();
+        ++pages;
+        unanswered += page.GetUnanswered();
+        if (size_t missing = page.GetMissing()) {
+            // A throttled or dropped message also loses its reply
+            BridgeScheduler::AddonStats scheduler;
+            bool limited = BridgeScheduler::GetStats(page.GetAddonId(), scheduler) &&
+                           (scheduler.overBudget || scheduler.overflowed ||
+                            std::any_of(std::begin(scheduler.throttled), std::end(scheduler.throttled),
+                                        [](uint64_t n) { return n != 0; }));
+            (limited ? unchecked : outOfOrder) += missing;
+        }
+        sent += stats.sent;
+        sentBytes += stats.sentBytes;
+        scripts += stats.scripts;
+        scriptBytes += stats.scriptBytes;
+        inputEvents += stats.inputEvents;
+    });
+
+    std::printf("host_sim: %d addon(s) x %d window(s), %d frame(s) (%d warm-up), %d msg(s)/page/frame, "
+                "%d event(s)/frame\n", o.addons, o.windows, o.frames, o.warmup, o.msgs, o.events);
+    std::printf("pages: %zu open, %llu created\n", pages,
+        static_cast<unsigned long long>(SimCef::GetCreatedCount()));
+    PrintSummary(samples);
+
+    std::printf("\nbridge: %llu message(s) sent (%.1f KB), %llu script(s) executed (%.1f KB), "
+                "%llu input event(s) delivered\n",
+        static_cast<unsigned long long>(sent), sentBytes / 1024.0,
+        static_cast<unsigned long long>(scripts), scriptBytes / 1024.0,
+        static_cast<unsigned long long>(inputEvents));
+
+    for (const std::string& id : addonIds) {
+        BridgeScheduler::AddonStats stats;
+        if (!BridgeScheduler::GetStats(id, stats)) continue;
+        std::printf("  %-8s admitted %llu, worker %llu us, render %llu us, max queued %u, throttled",
+            id.c_str(), static_cast<unsigned long long>(stats.admitted),
+            static_cast<unsigned long long>(stats.workerUs),
+            static_cast<unsigned long long>(stats.renderUs), stats.maxQueued);
+        for (size_t c = 0; c < BridgeScheduler::ACTION_CLASS_COUNT; ++c) {
+            std::printf(" %s=%llu", BridgeApi::ActionClassName(static_cast<BridgeApi::ActionClass>(c)),
+                static_cast<unsigned long long>(stats.throttled[c]));
+        }
+        std::printf(", dropped over budget %llu, queue full %llu",
+            static_cast<unsigned long long>(stats.overBudget),
+            static_cast<unsigned long long>(stats.overflowed));
+        std::printf("\n");
+    }
+
+    FakeNexus::Counters host = FakeNexus::GetCounters();
+    std::printf("host: %llu event(s) raised, %llu callback(s), %llu keybind(s), %llu game bind(s), "
+                "%llu/%llu wndproc consumed, %llu warning(s), %llu error(s)\n",
+        static_cast<unsigned long long>(host.events), static_cast<unsigned long long>(host.eventCallbacks),
+        static_cast<unsigned long long>(host.keybinds), static_cast<unsigned long long>(host.gameBinds),
+        static_cast<unsigned long long>(host.wndProcConsumed), static_cast<unsigned long long>(host.wndProc),
+        static_cast<unsigned long long>(host.logs[LOGL_WARNING]),
+        static_cast<unsigned long long>(host.logs[LOGL_CRITICAL]));
+    std::printf("order: %zu reply(s) or event(s) missing", outOfOrder);
+    if (unchecked) std::printf(", %zu not checked (rate limited)", unchecked);
+    std::printf("; %zu request(s) unanswered\n", unanswered);
+
+    if (o.ipcStats) {
+        json all = json::object();
+        IpcStats::ForEach([&](const std::string& addonId, const IpcStats::AddonStats& stats) {
+            all[addonId] = IpcStats::ToJson(stats);
+        });
+        std::printf("\n%s\n", all.dump(2).c_str());
+    }
+
+    // AddonUnload
+    gameThread.Stop();
+    InputHandler::Shutdown();
+    AddonManager::Shutdown();
+    SimCef::Pump();
+    SimCef::Shutdown();
+    Globals::IsLoaded = false;
+    ImGui::DestroyContext();
+
+    std::error_code ec;
+    fs::remove_all(root, ec);
+    return outOfOrder || unanswered ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#include "micro.h"
+
+#include "bridge_api.h"
+#include "bridge_scanner.h"
+
+#include "nlohmann/json.hpp"
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// BridgeScanner and the flat BridgeApi decoders, against the DOM path that
+// IpcHandler falls back to.
+
+using nlohmann::json;
+
+namespace {
+
+// Messages shaped as the generated JS stubs send them, plus the __addonId the
+// bridge adds: mostly logs and raised events, some input.
+const char* const TRAFFIC[] = {
+    R"({"action":"log","channel":"sim","message":"frame 1841 took 3.2 ms","level":4,"__addonId":"sim0"})",
+    R"({"action":"events_raise","name":"SIM_PING","__addonId":"sim1"})",
+    R"({"action":"log","channel":"net","message":"reply \"ok\"\n","level":3,"__addonId":"sim2"})",
+    R"({"action":"gamebinds_invoke","bind":42,"durationMs":50,"__addonId":"sim3"})",
+    R"({"action":"events_raise","name":"SIM_PONG","__addonId":"sim0"})",
+    R"({"action":"log","channel":"sim","message":"tick","level":5,"__addonId":"sim1"})",
+    R"({"action":"gamebinds_isBound","bind":7,"requestId":118,"__addonId":"sim2"})",
+    R"({"action":"log","channel":"ui","message":"window resized to 800x600","level":3,"__addonId":"sim3"})",
+};
+constexpr size_t TRAFFIC_COUNT = sizeof(TRAFFIC) / sizeof(TRAFFIC[0]);
+
+// What the handlers read, so both paths do the same work
+uint64_t Use(BridgeApi::Action action, const BridgeApi::LogParams& log,
+             const BridgeApi::EventsRaiseParams& raise, const BridgeApi::GameBindsInvokeParams& invoke) {
+    switch (action) {
+        case BridgeApi::Action::Log:             return log.level + std::strlen(log.message);
+        case BridgeApi::Action::EventsRaise:     return std::strlen(raise.name);
+        case BridgeApi::Action::GameBindsInvoke: return invoke.bind + invoke.durationMs;
+        default:                                 return 1;
+    }
+}
+
+template <typename Msg>
+uint64_t DecodeAndUse(BridgeApi::Action action, const Msg& msg) {
+    BridgeApi::LogParams log;
+    BridgeApi::EventsRaiseParams raise;
+    BridgeApi::GameBindsInvokeParams invoke;
+    switch (action) {
+        case BridgeApi::Action::Log:             BridgeApi::Decode(msg, log); break;
+        case BridgeApi::Action::EventsRaise:     BridgeApi::Decode(msg, raise); break;
+        case BridgeApi::Action::GameBindsInvoke: BridgeApi::Decode(msg, invoke); break;
+        default: break;
+    }
+    return Use(action, log, raise, invoke);
+}
+
+struct Scanned {
+    char                       buffer[2048];
+    BridgeScanner::FlatMessage flat;
+
+    bool Scan(const char* message) {
+        size_t length = std::strlen(message);
+        std::memcpy(buffer, message, length);
+        return BridgeScanner::Scan(buffer, length, flat);
+    }
+};
+
+} // namespace
+
+MICRO_TEST("scanner: flat message members and unescaped strings") {
+    Scanned s;
+    CHECK(s.Scan(TRAFFIC[2]));
+    CHECK_EQ(s.flat.count, 5u);
+
+    const BridgeScanner::Member* message = s.flat.Find("message");
+    CHECK(message && message->kind == BridgeScanner::ValueKind::String);
+    if (message) CHECK(std::string_view(message->str, message->strLen) == "reply \"ok\"\n");
+
+    const BridgeScanner::Member* level = s.flat.Find("level");
+    CHECK(level && level->kind == BridgeScanner::ValueKind::Number && level->integral);
+    if (level) CHECK_EQ(level->integer, int64_t(3));
+}
+
+MICRO_TEST("scanner: rejects what only the DOM path handles") {
+    Scanned s;
+    CHECK(!s.Scan(R"({"action":"perf_latency","samples":[1,2,3]})"));
+    CHECK(!s.Scan(R"({"action":"log","message":{"nested":true}})"));
+    CHECK(!s.Scan(R"({"action":"log","message":"unterminated})"));
+    CHECK(!s.Scan(R"(["log"])"));
+}
+
+MICRO_TEST("scanner: flat decode matches the DOM decode on the traffic") {
+    for (const char* message : TRAFFIC) {
+        Scanned s;
+        CHECK(s.Scan(message));
+        json dom = json::parse(message);
+
+        const BridgeScanner::Member* action = s.flat.Find("action");
+        CHECK(action != nullptr);
+        if (!action) continue;
+        BridgeApi::Action id = BridgeApi::Lookup(std::string_view(action->str, action->strLen));
+        CHECK(id == BridgeApi::Lookup(dom["action"].get<std::string>()));
+        CHECK(id != BridgeApi::Action::Unknown);
+        CHECK_EQ(DecodeAndUse(id, s.flat), DecodeAndUse(id, dom));
+    }
+}
+
+MICRO_TEST("decode: Int params truncate fractions, fail on what no int holds") {
+    struct Case {
+        const char* message;
+        bool        ok;
+        int         width;
+    };
+    const Case cases[] = {
+        { R"({"action":"windows_update","width":400.5})", true, 400 },
+        { R"({"action":"windows_update","width":-2.7})", true, -2 },
+        { R"({"action":"windows_update","width":2147483647.9})", true, 2147483647 },
+        { R"({"action":"windows_update","width":-2147483648})", true, -2147483648 },
+        { R"({"action":"windows_update","width":"400"})", true, 0 },
+        { R"({"action":"windows_update","width":2147483648})", false, 0 },
+        { R"({"action":"windows_update","width":1e20})", false, 0 },
+    };
+    for (const Case& c : cases) {
+        BridgeApi::WindowsUpdateParams dom;
+        CHECK_EQ(BridgeApi::Decode(json::parse(c.message), dom), c.ok);
+        if (c.ok) CHECK_EQ(dom.width, c.width);
+
+        Scanned s;
+        CHECK(s.Scan(c.message));
+        BridgeApi::WindowsUpdateParams flat;
+        CHECK_EQ(BridgeApi::Decode(s.flat, flat), c.ok);
+        if (c.ok) CHECK_EQ(flat.width, c.width);
+    }
+}
+
+MICRO_BENCH("bridge message decode") {
+    Micro::Bench("flat: copy + Scan + Lookup + Decode", 2000000, [](uint64_t i) {
+        Scanned s;
+        if (!s.Scan(TRAFFIC[i % TRAFFIC_COUNT])) return;
+        const BridgeScanner::Member* action = s.flat.Find("action");
+        BridgeApi::Action id = BridgeApi::Lookup(std::string_view(action->str, action->strLen));
+        Micro::Consume(DecodeAndUse(id, s.flat));
+    });
+
+    Micro::Bench("DOM: json::parse + Lookup + Decode", 2000000, [](uint64_t i) {
+        const char* message = TRAFFIC[i % TRAFFIC_COUNT];
+        json dom = json::parse(message, message + std::strlen(message));
+        BridgeApi::Action id = BridgeApi::Lookup(dom["action"].get_ref<const std::string&>());
+        Micro::Consume(DecodeAndUse(id, dom));
+    });
+}
@@ -0,0 +1,199 @@
+#include "micro.h"
+
+#include "event_aggregator.h"
+#include "event_codecs.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// EventAggregator over EV_ADDON_LOADED, whose record is one I32 "signature":
+// each test picks the value it adds.
+
+namespace {
+
+struct SignatureEvents {
+    EventCodecs::CodecId          codec = EventCodecs::Find("EV_ADDON_LOADED");
+    const EventCodecs::FieldDesc* field = EventCodecs::FindField(codec, "signature");
+    alignas(8) uint8_t            record[EventCodecs::MAX_RECORD_BYTES];
+    uint16_t                      size = 0;
+
+    void Set(int32_t signature) {
+        size = EventCodecs::Get(codec)->capture(&signature, record);
+    }
+};
+
+constexpr DWORD T0 = 100000;
+
+} // namespace
+
+MICRO_TEST("aggregator: count rolls out of the window bucket by bucket") {
+    SignatureEvents ev;
+    ev.Set(1);
+    EventAggregator agg("a", "EV_ADDON_LOADED", AggregateOp::Count, ev.codec, nullptr, 1000, 4, T0);
+
+    for (int i = 0; i < 10; ++i) agg.Add(ev.record, ev.size);
+    agg.Advance(T0);
+    CHECK_EQ(agg.WindowCount(), 10u);
+
+    for (int i = 0; i < 5; ++i) agg.Add(ev.record, ev.size);
+    agg.Advance(T0 + 500);
+    CHECK_EQ(agg.WindowCount(), 15u);
+    CHECK_EQ(agg.Value(), 15.0);
+
+    // The first ten are still inside the window shortly before it ends...
+    agg.Advance(T0 + 900);
+    CHECK_EQ(agg.WindowCount(), 15u);
+
+    // ...and expire once it has moved past their bucket
+    agg.Advance(T0 + 1000);
+    CHECK_EQ(agg.WindowCount(), 5u);
+
+    // A gap longer than the window clears everything
+    agg.Advance(T0 + 10000);
+    CHECK_EQ(agg.WindowCount(), 0u);
+    CHECK_EQ(agg.GetTotalCount(), 15u);
+}
+
+MICRO_TEST("aggregator: window 0 aggregates over the whole lifetime") {
+    SignatureEvents ev;
+    ev.Set(1);
+    EventAggregator agg("a", "EV_ADDON_LOADED", AggregateOp::Count, ev.codec, nullptr, 0, 4, T0);
+
+    for (DWORD t = 0; t < 10; ++t) {
+        agg.Add(ev.record, ev.size);
+        agg.Advance(T0 + t * 60000);
+    }
+    CHECK_EQ(agg.WindowCount(), 10u);
+}
+
+MICRO_TEST("aggregator: rate divides by the age until a full window has passed") {
+    SignatureEvents ev;
+    ev.Set(1);
+    EventAggregator agg("a", "EV_ADDON_LOADED", AggregateOp::Rate, ev.codec, nullptr, 1000, 4, T0);
+
+    CHECK_EQ(agg.Value(), 0.0);
+    for (int i = 0; i < 50; ++i) agg.Add(ev.record, ev.size);
+    agg.Advance(T0 + 500);
+    CHECK_EQ(agg.Value(), 100.0);
+}
+
+MICRO_TEST("aggregator: sum of a numeric field over the window") {
+    SignatureEvents ev;
+    EventAggregator agg("a", "EV_ADDON_LOADED", AggregateOp::Sum, ev.codec, ev.field, 1000, 4, T0);
+
+    for (int32_t v : { 3, -1, 40 }) {
+        ev.Set(v);
+        agg.Add(ev.record, ev.size);
+    }
+    agg.Advance(T0);
+    CHECK_EQ(agg.Value(), 42.0);
+    CHECK_EQ(agg.WindowCount(), 3u);
+
+    // A record too short for the field counts, but adds nothing
+    agg.Add(ev.record, 0);
+    agg.Advance(T0 + 10);
+    CHECK_EQ(agg.Value(), 42.0);
+    CHECK_EQ(agg.WindowCount(), 4u);
+
+    agg.Advance(T0 + 5000);
+    CHECK_EQ(agg.Value(), 0.0);
+}
+
+MICRO_TEST("aggregator: latest keeps the most recent value, not emitted before one") {
+    SignatureEvents ev;
+    EventAggregator agg("a", "EV_ADDON_LOADED", AggregateOp::Latest, ev.codec, ev.field, 1000, 4, T0);
+
+    agg.Advance(T0);
+    CHECK(!agg.TakeEmit(T0));
+
+    for (int32_t v : { 5, 9, 7 }) {
+        ev.Set(v);
+        agg.Add(ev.record, ev.size);
+    }
+    agg.Advance(T0 + 1);
+    CHECK_EQ(agg.Value(), 7.0);
+    CHECK(agg.TakeEmit(T0 + 1));
+
+    // Latest does not expire with the window
+    agg.Advance(T0 + 5000);
+    CHECK_EQ(agg.Value(), 7.0);
+}
+
+MICRO_TEST("aggregator: emits at most once per interval, and only on change") {
+    SignatureEvents ev;
+    ev.Set(1);
+    EventAggregator agg("a", "EV_ADDON_LOADED", AggregateOp::Count, ev.codec, nullptr, 0, 4, T0);
+
+    // Nothing emitted yet: the first value goes out even if it is 0
+    agg.Advance(T0);
+    CHECK(agg.TakeEmit(T0));
+    CHECK(!agg.TakeEmit(T0));
+
+    // Changed, but inside the 250 ms interval
+    agg.Add(ev.record, ev.size);
+    agg.Advance(T0 + 100);
+    CHECK(!agg.TakeEmit(T0 + 100));
+
+    // Interval up and changed
+    agg.Advance(T0 + 250);
+    CHECK(agg.TakeEmit(T0 + 250));
+
+    // Interval up, unchanged
+    agg.Advance(T0 + 600);
+    CHECK(!agg.TakeEmit(T0 + 600));
+
+    agg.Add(ev.record, ev.size);
+    agg.Advance(T0 + 700);
+    CHECK(agg.TakeEmit(T0 + 700));
+    CHECK_EQ(agg.Value(), 2.0);
+}
+
+MICRO_TEST("aggregator: adds from several threads are all counted") {
+    SignatureEvents ev;
+    ev.Set(2);
+    EventAggregator agg("a", "EV_ADDON_LOADED", AggregateOp::Sum, ev.codec, ev.field, 0, 4, T0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 10000; ++i) agg.Add(ev.record, ev.size);
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    agg.Advance(T0);
+    CHECK_EQ(agg.WindowCount(), 40000u);
+    CHECK_EQ(agg.Value(), 80000.0);
+}
+
+MICRO_BENCH("event aggregator") {
+    SignatureEvents ev;
+    ev.Set(3);
+
+    EventAggregator count("a", "EV_ADDON_LOADED", AggregateOp::Count, ev.codec, nullptr, 1000, 4, T0);
+    Micro::Bench("Add, count", 10000000, [&](uint64_t) { count.Add(ev.record, ev.size); });
+
+    EventAggregator sum("a", "EV_ADDON_LOADED", AggregateOp::Sum, ev.codec, ev.field, 1000, 4, T0);
+    Micro::Bench("Add, sum of a field", 10000000, [&](uint64_t) { sum.Add(ev.record, ev.size); });
+
+    // One frame's worth of render-thread work at 60 fps with events in between
+    EventAggregator frame("a", "EV_ADDON_LOADED", AggregateOp::Sum, ev.codec, ev.field, 1000, 4, T0);
+    Micro::Bench("Advance + Value + TakeEmit (per frame)", 1000000, [&](uint64_t i) {
+        frame.Add(ev.record, ev.size);
+        DWORD now = T0 + static_cast<DWORD>(i * 16);
+        frame.Advance(now);
+        if (frame.TakeEmit(now)) Micro::Consume(static_cast<uint64_t>(frame.Value()));
+    });
+
+    // Contended adds: four game threads firing the same event
+    EventAggregator shared("a", "EV_ADDON_LOADED", AggregateOp::Sum, ev.codec, ev.field, 1000, 4, T0);
+    Micro::Bench("Add, sum, 4 threads x 250k (per batch)", 4, [&](uint64_t) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < 250000; ++i) shared.Add(ev.record, ev.size);
+            });
+        }
+        for (std::thread& t : threads) t.join();
+    });
+}
@@ -0,0 +1,165 @@
+#include "micro.h"
+
+#include "js_dispatch.h"
+
+#include "nlohmann/json.hpp"
+
+#include <string>
+
+// JsDispatch's encode and script-building stage: everything Send does for a
+// non-blob payload before handing the script to CEF.
+
+using nlohmann::json;
+using JsDispatch::Encoding;
+
+namespace {
+
+json Response(json value) {
+    return { { "type", "response" }, { "requestId", 118 }, { "success", true },
+             { "value", std::move(value) } };
+}
+
+// An async response carrying a short string (paths, translations)
+json SmallPayload() {
+    return Response("C:\\Program Files\\Guild Wars 2\\addons\\sim0");
+}
+
+// A datalink_getMumbleLink response: mostly numbers
+json MumblePayload() {
+    json avatar = { { "position", { 151.25, 22.5, -803.75 } }, { "front", { 0.7071, 0.0, 0.7071 } },
+                    { "top", { 0.0, 1.0, 0.0 } } };
+    json camera = { { "position", { 148.5, 26.0, -810.0 } }, { "front", { 0.6, -0.2, 0.77 } },
+                    { "top", { 0.0, 1.0, 0.0 } } };
+    json context = { { "mapId", 1206 }, { "mapType", 5 }, { "shardId", 2006 }, { "instance", 0 },
+                     { "buildId", 151853 }, { "uiState", 58 }, { "compassWidth", 362 },
+                     { "compassHeight", 300 }, { "compassRotation", 0.0 }, { "playerX", 43520.5 },
+                     { "playerY", 31000.25 }, { "mapCenterX", 43500.0 }, { "mapCenterY", 31050.0 },
+                     { "mapScale", 1.0 }, { "processId", 4242 }, { "mountIndex", 0 } };
+    return Response({ { "uiVersion", 2 }, { "uiTick", 981733 }, { "avatar", avatar },
+                      { "camera", camera }, { "identity", "{\"name\":\"Sim Char\",\"profession\":4}" },
+                      { "context", context } });
+}
+
+// A response above INLINE_MAX_BYTES, which JSON sends as a string literal
+json LargePayload() {
+    json windows = json::array();
+    for (int i = 0; i < 120; ++i) {
+        windows.push_back({ { "windowId", "window-" + std::to_string(i) },
+                            { "title", "Sim \"window\" " + std::to_string(i) },
+                            { "width", 800 }, { "height", 600 }, { "visible", i % 3 != 0 } });
+    }
+    return Response(windows);
+}
+
+std::string ScriptFor(Encoding encoding, const json& payload) {
+    std::string bytes, code;
+    JsDispatch::Encode(encoding, payload, bytes);
+    JsDispatch::BuildScript(encoding, bytes, code);
+    return code;
+}
+
+// A response of about `bytes` bytes of JSON: lines of text with quotes to
+// escape, like a log or chat history
+json PayloadOfSize(size_t bytes) {
+    json lines = json::array();
+    for (size_t size = 0; size < bytes; size += 64) {
+        lines.push_back("[12:00:01] \"Sim Char\": line " + std::to_string(size / 64) +
+                        " of the recorded history");
+    }
+    return Response(lines);
+}
+
+bool StartsWith(const std::string& s, const char* prefix) {
+    return s.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+} // namespace
+
+MICRO_TEST("encoding: binary encodings round-trip") {
+    for (const json& payload : { SmallPayload(), MumblePayload(), LargePayload() }) {
+        std::string cbor, msgpack;
+        JsDispatch::Encode(Encoding::Cbor, payload, cbor);
+        JsDispatch::Encode(Encoding::MsgPack, payload, msgpack);
+        CHECK(json::from_cbor(cbor) == payload);
+        CHECK(json::from_msgpack(msgpack) == payload);
+    }
+}
+
+MICRO_TEST("encoding: JSON picks an object literal or a string literal by size") {
+    std::string small = ScriptFor(Encoding::Json, MumblePayload());
+    CHECK(StartsWith(small, "window.__nexus_dispatch({"));
+
+    json large = LargePayload();
+    std::string script = ScriptFor(Encoding::Json, large);
+    CHECK(StartsWith(script, "window.__nexus_dispatch_json(\""));
+
+    // The literal is a JSON string whose contents are the payload
+    const size_t prefix = std::char_traits<char>::length("window.__nexus_dispatch_json(");
+    std::string literal = script.substr(prefix, script.size() - prefix - 2);
+    CHECK(json::parse(json::parse(literal).get<std::string>()) == large);
+}
+
+MICRO_TEST("encoding: binary payloads are sent as base64") {
+    std::string code;
+    JsDispatch::BuildScript(Encoding::Cbor, "Man", code);
+    CHECK(code == "window.__nexus_dispatch_bin(1,\"TWFu\");");
+    JsDispatch::BuildScript(Encoding::MsgPack, "Ma", code);
+    CHECK(code == "window.__nexus_dispatch_bin(2,\"TWE=\");");
+    JsDispatch::BuildScript(Encoding::Cbor, "M", code);
+    CHECK(code == "window.__nexus_dispatch_bin(1,\"TQ==\");");
+}
+
+MICRO_BENCH("payload encoding") {
+    const json payloads[] = { SmallPayload(), MumblePayload(), LargePayload() };
+    static const char* const LABELS[3][3] = {
+        { "small, json: Encode + BuildScript", "small, cbor: Encode + BuildScript",
+          "small, msgpack: Encode + BuildScript" },
+        { "mumble, json: Encode + BuildScript", "mumble, cbor: Encode + BuildScript",
+          "mumble, msgpack: Encode + BuildScript" },
+        { "large, json: Encode + BuildScript", "large, cbor: Encode + BuildScript",
+          "large, msgpack: Encode + BuildScript" },
+    };
+
+    // Fresh buffers per message, as Send uses
+    for (size_t p = 0; p < 3; ++p) {
+        for (Encoding encoding : { Encoding::Json, Encoding::Cbor, Encoding::MsgPack }) {
+            const json& payload = payloads[p];
+            Micro::Bench(LABELS[p][static_cast<size_t>(encoding)], p == 2 ? 20000 : 500000,
+                [&](uint64_t) {
+                    std::string bytes, code;
+                    JsDispatch::Encode(encoding, payload, bytes);
+                    JsDispatch::BuildScript(encoding, bytes, code);
+                    Micro::Consume(code.size());
+                });
+            std::string bytes, code;
+            JsDispatch::Encode(encoding, payload, bytes);
+            JsDispatch::BuildScript(encoding, bytes, code);
+            std::printf("    %zu payload bytes, %zu script bytes\n", bytes.size(), code.size());
+        }
+    }
+}
+
+// Native cost of getting a JSON payload into a dispatch script, by size: up
+// to INLINE_MAX_BYTES as an object literal, then as a string literal. The
+// largest case is just under BLOB_MIN_BYTES; above it the payload is staged
+// and the script is a few dozen bytes. What V8 spends on each form is not
+// measurable against the stub CEF.
+MICRO_BENCH("dispatch by payload size") {
+    static const size_t SIZES[] = { 1024, 8 * 1024, 64 * 1024, 500 * 1024 };
+    static const char* const LABELS[] = { "1 KB: Encode + BuildScript", "8 KB: Encode + BuildScript",
+                                          "64 KB: Encode + BuildScript", "500 KB: Encode + BuildScript" };
+    for (size_t i = 0; i < 4; ++i) {
+        json payload = PayloadOfSize(SIZES[i]);
+        Micro::Bench(LABELS[i], SIZES[i] >= 64 * 1024 ? 500 : 20000, [&](uint64_t) {
+            std::string bytes, code;
+            JsDispatch::Encode(Encoding::Json, payload, bytes);
+            JsDispatch::BuildScript(Encoding::Json, bytes, code);
+            Micro::Consume(code.size());
+        });
+        std::string bytes, code;
+        JsDispatch::Encode(Encoding::Json, payload, bytes);
+        JsDispatch::BuildScript(Encoding::Json, bytes, code);
+        std::printf("    %zu payload bytes, %s\n", bytes.size(),
+            StartsWith(code, "window.__nexus_dispatch_json(") ? "string literal" : "object literal");
+    }
+}
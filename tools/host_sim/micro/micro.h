@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal unit checks and microbenchmarks for plugin modules that build
+// without the rest of the core (host_micro). A file registers its cases with
+// MICRO_TEST / MICRO_BENCH; host_micro runs every test, and with --bench the
+// benchmarks too.
+
+namespace Micro {
+
+struct Case {
+    const char*           name;
+    std::function<void()> run;
+};
+
+std::vector<Case>& Tests();
+std::vector<Case>& Benches();
+
+struct Registrar {
+    Registrar(std::vector<Case>& list, const char* name, std::function<void()> run) {
+        list.push_back({ name, std::move(run) });
+    }
+};
+
+// Record a failed check in the running test (reported, and fails the run).
+void Fail(const char* file, int line, const std::string& what);
+
+// Run `op` `iterations` times after a short warm-up and print the time and
+// heap allocations per iteration. `op` receives the iteration index.
+void Bench(const char* name, uint64_t iterations, const std::function<void(uint64_t)>& op);
+
+// Keep a computed value alive so the optimizer cannot drop its computation.
+void Consume(uint64_t value);
+
+} // namespace Micro
+
+#define MICRO_CONCAT2(a, b) a##b
+#define MICRO_CONCAT(a, b)  MICRO_CONCAT2(a, b)
+
+#define MICRO_CASE(list, name)                                                     \
+    static void MICRO_CONCAT(MicroCase_, __LINE__)();                              \
+    static Micro::Registrar MICRO_CONCAT(s_microCase_, __LINE__)(                  \
+        Micro::list(), name, MICRO_CONCAT(MicroCase_, __LINE__));                  \
+    static void MICRO_CONCAT(MicroCase_, __LINE__)()
+
+#define MICRO_TEST(name)  MICRO_CASE(Tests, name)
+#define MICRO_BENCH(name) MICRO_CASE(Benches, name)
+
+#define CHECK(cond)                                                                \
+    do {                                                                           \
+        if (!(cond)) Micro::Fail(__FILE__, __LINE__, #cond);                       \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                             \
+    do {                                                                           \
+        auto _a = (a);                                                             \
+        auto _b = (b);                                                             \
+        if (!(_a == _b)) {                                                         \
+            Micro::Fail(__FILE__, __LINE__, std::string(#a " == " #b ": ") +       \
+                        std::to_string(_a) + " vs " + std::to_string(_b));         \
+        }                                                                          \
+    } while (0)
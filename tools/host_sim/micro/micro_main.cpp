@@ -0,0 +1,91 @@
+// host_micro: unit checks and microbenchmarks of single plugin modules.
+//
+//   host_micro                  run the checks
+//   host_micro --bench          run the checks, then the benchmarks
+//   host_micro --bench NAME     ... only benchmarks whose name contains NAME
+
+#include "micro.h"
+#include "sim_host.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace Micro {
+
+static int         s_failures = 0;
+static const char* s_current = "";
+
+std::vector<Case>& Tests() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+std::vector<Case>& Benches() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+void Fail(const char* file, int line, const std::string& what) {
+    ++s_failures;
+    std::fprintf(stderr, "FAIL %s: %s:%d: %s\n", s_current, file, line, what.c_str());
+}
+
+static volatile uint64_t s_sink = 0;
+
+void Consume(uint64_t value) {
+    s_sink = s_sink + value;
+}
+
+void Bench(const char* name, uint64_t iterations, const std::function<void(uint64_t)>& op) {
+    using Clock = std::chrono::steady_clock;
+    for (uint64_t i = 0; i < iterations / 10 + 1; ++i) op(i);
+
+    SimAlloc::Counters before = SimAlloc::Read();
+    Clock::time_point start = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) op(i);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    SimAlloc::Counters after = SimAlloc::Read();
+
+    std::printf("  %-44s %10.1f ns/op %8.2f allocs/op %10.1f B/op\n", name,
+        ns / iterations,
+        static_cast<double>(after.allocations - before.allocations) / iterations,
+        static_cast<double>(after.bytes - before.bytes) / iterations);
+}
+
+} // namespace Micro
+
+int main(int argc, char** argv) {
+    bool bench = false;
+    const char* filter = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bench") == 0) {
+            bench = true;
+            if (i + 1 < argc) filter = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: host_micro [--bench [NAME]]\n");
+            return 2;
+        }
+    }
+
+    for (const Micro::Case& test : Micro::Tests()) {
+        Micro::s_current = test.name;
+        int before = Micro::s_failures;
+        test.run();
+        std::printf("%s %s\n", Micro::s_failures == before ? "ok  " : "FAIL", test.name);
+    }
+    if (Micro::s_failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", Micro::s_failures);
+        return 1;
+    }
+
+    if (bench) {
+        std::printf("\n");
+        for (const Micro::Case& b : Micro::Benches()) {
+            if (filter && !std::strstr(b.name, filter)) continue;
+            std::printf("%s\n", b.name);
+            Micro::s_current = b.name;
+            b.run();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Declarations only: host_sim replaces D3D11Texture (sim_stubs.cpp), so no
+// D3D object is ever created.
+#include <windows.h>
+
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+struct ID3D11Texture2D;
+struct ID3D11ShaderResourceView;
+struct IDXGISwapChain;
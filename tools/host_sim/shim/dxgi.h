@@ -0,0 +1,3 @@
+#pragma once
+
+#include <d3d11.h>
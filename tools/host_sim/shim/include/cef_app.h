@@ -0,0 +1,3 @@
+#pragma once
+
+#include "include/cef_sim.h"
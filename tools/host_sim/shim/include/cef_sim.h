@@ -0,0 +1,290 @@
+#pragma once
+
+// The slice of the CEF C++ API the plugin core uses, for host_sim.
+//
+// Declared to match the real headers closely enough that the core compiles
+// unchanged (ref counting, CefRefPtr, handler interfaces). CefBrowserHost::
+// CreateBrowser and CefDictionaryValue::Create are implemented by the stub
+// browser in ../../sim_cef.cpp.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ---- Ref counting ----
+
+class CefBaseRefCounted {
+public:
+    virtual void AddRef() const = 0;
+    virtual bool Release() const = 0;
+    virtual bool HasOneRef() const = 0;
+    virtual bool HasAtLeastOneRef() const = 0;
+
+protected:
+    virtual ~CefBaseRefCounted() = default;
+};
+
+template <class T>
+class CefRefPtr {
+public:
+    CefRefPtr() = default;
+    CefRefPtr(std::nullptr_t) {}
+    CefRefPtr(T* p) : m_ptr(p) { if (m_ptr) m_ptr->AddRef(); }
+    CefRefPtr(const CefRefPtr& other) : CefRefPtr(other.m_ptr) {}
+    template <class U>
+    CefRefPtr(const CefRefPtr<U>& other) : CefRefPtr(other.get()) {}
+    CefRefPtr(CefRefPtr&& other) noexcept : m_ptr(other.m_ptr) { other.m_ptr = nullptr; }
+    ~CefRefPtr() { if (m_ptr) m_ptr->Release(); }
+
+    CefRefPtr& operator=(T* p) {
+        if (p) p->AddRef();
+        T* old = m_ptr;
+        m_ptr = p;
+        if (old) old->Release();
+        return *this;
+    }
+    CefRefPtr& operator=(const CefRefPtr& other) { return *this = other.m_ptr; }
+    CefRefPtr& operator=(CefRefPtr&& other) noexcept {
+        if (this != &other) {
+            T* old = m_ptr;
+            m_ptr = other.m_ptr;
+            other.m_ptr = nullptr;
+            if (old) old->Release();
+        }
+        return *this;
+    }
+    CefRefPtr& operator=(std::nullptr_t) { return *this = static_cast<T*>(nullptr); }
+
+    T* get() const { return m_ptr; }
+    T* operator->() const { return m_ptr; }
+    T& operator*() const { return *m_ptr; }
+    operator T*() const { return m_ptr; }
+
+private:
+    T* m_ptr = nullptr;
+};
+
+#define IMPLEMENT_REFCOUNTING(ClassName)                                        \
+public:                                                                         \
+    void AddRef() const override { m_simRefs.fetch_add(1); }                    \
+    bool Release() const override {                                             \
+        if (m_simRefs.fetch_sub(1) == 1) {                                      \
+            delete static_cast<const ClassName*>(this);                         \
+            return true;                                                        \
+        }                                                                       \
+        return false;                                                           \
+    }                                                                           \
+    bool HasOneRef() const override { return m_simRefs.load() == 1; }           \
+    bool HasAtLeastOneRef() const override { return m_simRefs.load() >= 1; }    \
+                                                                                \
+private:                                                                        \
+    mutable std::atomic<int> m_simRefs{0}
+
+#define DISALLOW_COPY_AND_ASSIGN(TypeName) \
+    TypeName(const TypeName&) = delete;    \
+    TypeName& operator=(const TypeName&) = delete
+
+// ---- Value types ----
+
+// UTF-8 throughout (the real CefString is UTF-16 on Windows).
+class CefString {
+public:
+    CefString() = default;
+    CefString(const std::string& s) : m_str(s) {}
+    CefString(std::string&& s) : m_str(std::move(s)) {}
+    CefString(const char* s) : m_str(s ? s : "") {}
+
+    std::string ToString() const { return m_str; }
+    const std::string& str() const { return m_str; }
+    bool empty() const { return m_str.empty(); }
+    size_t length() const { return m_str.size(); }
+
+private:
+    std::string m_str;
+};
+
+struct CefRect {
+    int x = 0, y = 0, width = 0, height = 0;
+    CefRect() = default;
+    CefRect(int x, int y, int width, int height) : x(x), y(y), width(width), height(height) {}
+};
+
+struct CefPoint {
+    int x = 0, y = 0;
+};
+
+struct CefMouseEvent {
+    int      x = 0;
+    int      y = 0;
+    uint32_t modifiers = 0;
+};
+
+enum cef_key_event_type_t {
+    KEYEVENT_RAWKEYDOWN,
+    KEYEVENT_KEYDOWN,
+    KEYEVENT_KEYUP,
+    KEYEVENT_CHAR,
+};
+
+struct CefKeyEvent {
+    cef_key_event_type_t type = KEYEVENT_RAWKEYDOWN;
+    uint32_t modifiers = 0;
+    int      windows_key_code = 0;
+    int      native_key_code = 0;
+    int      is_system_key = 0;
+    uint16_t character = 0;
+    uint16_t unmodified_character = 0;
+    int      focus_on_editable_field = 0;
+};
+
+typedef uint32_t cef_color_t;
+
+inline cef_color_t CefColorSetARGB(unsigned a, unsigned r, unsigned g, unsigned b) {
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+class CefWindowInfo {
+public:
+    void SetAsWindowless(void* /*parent*/) { windowless_rendering_enabled = 1; }
+    int windowless_rendering_enabled = 0;
+};
+
+struct CefBrowserSettings {
+    int         windowless_frame_rate = 30;
+    cef_color_t background_color = 0;
+};
+
+enum cef_log_severity_t {
+    LOGSEVERITY_DEFAULT,
+    LOGSEVERITY_VERBOSE,
+    LOGSEVERITY_INFO,
+    LOGSEVERITY_WARNING,
+    LOGSEVERITY_ERROR,
+};
+
+// ---- Browser objects ----
+
+class CefDictionaryValue : public virtual CefBaseRefCounted {
+public:
+    static CefRefPtr<CefDictionaryValue> Create();
+};
+
+class CefRequestContext : public virtual CefBaseRefCounted {};
+
+class CefFrame : public virtual CefBaseRefCounted {
+public:
+    virtual void ExecuteJavaScript(const CefString& code, const CefString& scriptUrl, int startLine) = 0;
+    virtual bool IsMain() = 0;
+    virtual void LoadURL(const CefString& url) = 0;
+    virtual CefString GetURL() = 0;
+};
+
+class CefClient;
+class CefBrowserHost;
+
+class CefBrowser : public virtual CefBaseRefCounted {
+public:
+    virtual CefRefPtr<CefBrowserHost> GetHost() = 0;
+    virtual CefRefPtr<CefFrame> GetMainFrame() = 0;
+    virtual void Reload() = 0;
+    virtual int GetIdentifier() = 0;
+};
+
+class CefBrowserHost : public virtual CefBaseRefCounted {
+public:
+    enum MouseButtonType { MBT_LEFT, MBT_MIDDLE, MBT_RIGHT };
+
+    static bool CreateBrowser(const CefWindowInfo& windowInfo,
+                              CefRefPtr<CefClient> client,
+                              const CefString& url,
+                              const CefBrowserSettings& settings,
+                              CefRefPtr<CefDictionaryValue> extraInfo,
+                              CefRefPtr<CefRequestContext> requestContext);
+
+    virtual void CloseBrowser(bool forceClose) = 0;
+    virtual void WasResized() = 0;
+    virtual void SendMouseMoveEvent(const CefMouseEvent& event, bool mouseLeave) = 0;
+    virtual void SendMouseClickEvent(const CefMouseEvent& event, MouseButtonType type,
+                                     bool mouseUp, int clickCount) = 0;
+    virtual void SendMouseWheelEvent(const CefMouseEvent& event, int deltaX, int deltaY) = 0;
+    virtual void SendKeyEvent(const CefKeyEvent& event) = 0;
+    virtual void ShowDevTools(const CefWindowInfo& windowInfo, CefRefPtr<CefClient> client,
+                              const CefBrowserSettings& settings, const CefPoint& inspectElementAt) = 0;
+    virtual void CloseDevTools() = 0;
+};
+
+constexpr auto MBT_LEFT   = CefBrowserHost::MBT_LEFT;
+constexpr auto MBT_MIDDLE = CefBrowserHost::MBT_MIDDLE;
+constexpr auto MBT_RIGHT  = CefBrowserHost::MBT_RIGHT;
+
+// ---- Handlers ----
+
+class CefRenderHandler : public virtual CefBaseRefCounted {
+public:
+    enum PaintElementType { PET_VIEW, PET_POPUP };
+    typedef std::vector<CefRect> RectList;
+
+    virtual void GetViewRect(CefRefPtr<CefBrowser> browser, CefRect& rect) = 0;
+    virtual void OnPopupShow(CefRefPtr<CefBrowser> /*browser*/, bool /*show*/) {}
+    virtual void OnPopupSize(CefRefPtr<CefBrowser> /*browser*/, const CefRect& /*rect*/) {}
+    virtual void OnPaint(CefRefPtr<CefBrowser> browser, PaintElementType type,
+                         const RectList& dirtyRects, const void* buffer,
+                         int width, int height) = 0;
+};
+
+constexpr auto PET_VIEW  = CefRenderHandler::PET_VIEW;
+constexpr auto PET_POPUP = CefRenderHandler::PET_POPUP;
+
+class CefDisplayHandler : public virtual CefBaseRefCounted {
+public:
+    virtual bool OnConsoleMessage(CefRefPtr<CefBrowser> /*browser*/, cef_log_severity_t /*level*/,
+                                  const CefString& /*message*/, const CefString& /*source*/,
+                                  int /*line*/) {
+        return false;
+    }
+};
+
+class CefLoadHandler : public virtual CefBaseRefCounted {
+public:
+    typedef int TransitionType;
+
+    virtual void OnLoadStart(CefRefPtr<CefBrowser> /*browser*/, CefRefPtr<CefFrame> /*frame*/,
+                             TransitionType /*transitionType*/) {}
+    virtual void OnLoadEnd(CefRefPtr<CefBrowser> /*browser*/, CefRefPtr<CefFrame> /*frame*/,
+                           int /*httpStatusCode*/) {}
+};
+
+class CefLifeSpanHandler : public virtual CefBaseRefCounted {
+public:
+    virtual void OnAfterCreated(CefRefPtr<CefBrowser> /*browser*/) {}
+    virtual void OnBeforeClose(CefRefPtr<CefBrowser> /*browser*/) {}
+};
+
+class CefRequestHandler : public virtual CefBaseRefCounted {
+public:
+    enum TerminationStatus {
+        TS_ABNORMAL_TERMINATION,
+        TS_PROCESS_WAS_KILLED,
+        TS_PROCESS_CRASHED,
+        TS_PROCESS_OOM,
+    };
+
+    virtual void OnRenderProcessTerminated(CefRefPtr<CefBrowser> /*browser*/,
+                                           TerminationStatus /*status*/) {}
+};
+
+constexpr auto TS_ABNORMAL_TERMINATION = CefRequestHandler::TS_ABNORMAL_TERMINATION;
+constexpr auto TS_PROCESS_WAS_KILLED   = CefRequestHandler::TS_PROCESS_WAS_KILLED;
+constexpr auto TS_PROCESS_CRASHED      = CefRequestHandler::TS_PROCESS_CRASHED;
+constexpr auto TS_PROCESS_OOM          = CefRequestHandler::TS_PROCESS_OOM;
+
+class CefClient : public virtual CefBaseRefCounted {
+public:
+    virtual CefRefPtr<CefRenderHandler> GetRenderHandler() { return nullptr; }
+    virtual CefRefPtr<CefDisplayHandler> GetDisplayHandler() { return nullptr; }
+    virtual CefRefPtr<CefLoadHandler> GetLoadHandler() { return nullptr; }
+    virtual CefRefPtr<CefLifeSpanHandler> GetLifeSpanHandler() { return nullptr; }
+    virtual CefRefPtr<CefRequestHandler> GetRequestHandler() { return nullptr; }
+};
@@ -0,0 +1,4 @@
+#pragma once
+
+// Included by some Nexus.h revisions; nothing from it is used by the core.
+#include <windows.h>
@@ -0,0 +1,81 @@
+#pragma once
+
+// Minimal Win32 surface for building the plugin core on Linux (host_sim).
+// Only the types, constants and functions the core actually uses; the
+// functions are implemented in ../win32.cpp.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+
+typedef unsigned long  DWORD;
+typedef int            BOOL;
+typedef unsigned char  BYTE;
+typedef unsigned short WORD;
+typedef unsigned int   UINT;
+typedef long           LONG;
+typedef long           HRESULT;
+typedef uintptr_t      WPARAM;
+typedef intptr_t       LPARAM;
+typedef intptr_t       LRESULT;
+typedef void*          HANDLE;
+typedef void*          HMODULE;
+typedef void*          HINSTANCE;
+typedef void*          HWND;
+typedef void*          LPVOID;
+typedef const char*    LPCSTR;
+typedef char*          LPSTR;
+typedef const wchar_t* LPCWSTR;
+
+typedef struct tagPOINT { LONG x, y; } POINT;
+
+#define TRUE  1
+#define FALSE 0
+#define MAX_PATH 260
+#define WINAPI
+#define APIENTRY
+#define CALLBACK
+#define CP_UTF8 65001
+
+#define WM_KEYDOWN     0x0100
+#define WM_KEYUP       0x0101
+#define WM_CHAR        0x0102
+#define WM_SYSKEYDOWN  0x0104
+#define WM_SYSKEYUP    0x0105
+#define WM_SYSCHAR     0x0106
+#define WM_MOUSEMOVE   0x0200
+#define WM_LBUTTONDOWN 0x0201
+#define WM_LBUTTONUP   0x0202
+#define WM_RBUTTONDOWN 0x0204
+#define WM_RBUTTONUP   0x0205
+#define WM_MBUTTONDOWN 0x0207
+#define WM_MBUTTONUP   0x0208
+#define WM_MOUSEWHEEL  0x020A
+
+#define MEM_COMMIT        0x1000
+#define MEM_RESERVE       0x2000
+#define MEM_RELEASE       0x8000
+#define PAGE_READWRITE    0x04
+#define PAGE_EXECUTE_READ 0x20
+
+#define VK_SHIFT   0x10
+#define VK_CONTROL 0x11
+#define VK_MENU    0x12
+
+#define MAKELPARAM(lo, hi) ((LPARAM)(DWORD)(((WORD)(lo)) | (((DWORD)(WORD)(hi)) << 16)))
+#define MAKEWPARAM(lo, hi) ((WPARAM)(DWORD)(((WORD)(lo)) | (((DWORD)(WORD)(hi)) << 16)))
+
+DWORD GetTickCount();
+DWORD GetCurrentThreadId();
+short GetKeyState(int virtualKey);
+BOOL  ScreenToClient(HWND window, POINT* point);
+DWORD GetModuleFileNameA(HMODULE module, char* path, DWORD size);
+HANDLE GetCurrentProcess();
+LPVOID VirtualAlloc(LPVOID address, size_t size, DWORD allocationType, DWORD protect);
+BOOL   VirtualProtect(LPVOID address, size_t size, DWORD protect, DWORD* oldProtect);
+BOOL   VirtualFree(LPVOID address, size_t size, DWORD freeType);
+BOOL   FlushInstructionCache(HANDLE process, const void* address, size_t size);
+int   WideCharToMultiByte(UINT codePage, DWORD flags, const wchar_t* wide, int wideLen,
+                          char* out, int outSize, const char* defaultChar, BOOL* usedDefault);
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <windows.h>
+
+#define GET_X_LPARAM(lp) ((int)(short)((lp) & 0xffff))
+#define GET_Y_LPARAM(lp) ((int)(short)(((lp) >> 16) & 0xffff))
+#define GET_WHEEL_DELTA_WPARAM(wp) ((short)(((wp) >> 16) & 0xffff))
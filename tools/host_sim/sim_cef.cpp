@@ -0,0 +1,253 @@
+#include "sim_cef.h"
+
+#include "include/cef_browser.h"
+#include "include/cef_client.h"
+#include "include/cef_values.h"
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace SimCef {
+
+class SimBrowser : public CefBrowser,
+                   public CefBrowserHost,
+                   public CefFrame,
+                   public SimPage {
+public:
+    SimBrowser(CefRefPtr<CefClient> client, const std::string& url, int id)
+        : m_client(client), m_url(url), m_id(id) {}
+
+    // CefBrowser
+    CefRefPtr<CefBrowserHost> GetHost() override { return this; }
+    CefRefPtr<CefFrame> GetMainFrame() override { return m_closed ? nullptr : this; }
+    void Reload() override { m_reloadPending = true; }
+    int GetIdentifier() override { return m_id; }
+
+    // CefBrowserHost
+    void CloseBrowser(bool) override { m_closed = true; }
+    void WasResized() override {}
+    void SendMouseMoveEvent(const CefMouseEvent&, bool) override { ++m_stats.inputEvents; }
+    void SendMouseClickEvent(const CefMouseEvent&, MouseButtonType, bool, int) override { ++m_stats.inputEvents; }
+    void SendMouseWheelEvent(const CefMouseEvent&, int, int) override { ++m_stats.inputEvents; }
+    void SendKeyEvent(const CefKeyEvent&) override { ++m_stats.inputEvents; }
+    void ShowDevTools(const CefWindowInfo&, CefRefPtr<CefClient>, const CefBrowserSettings&,
+                      const CefPoint&) override {}
+    void CloseDevTools() override {}
+
+    // CefFrame
+    void ExecuteJavaScript(const CefString& code, const CefString&, int) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const std::string& script = code.str();
+        ++m_stats.scripts;
+        m_stats.scriptBytes += script.size();
+        m_expected.erase(std::remove_if(m_expected.begin(), m_expected.end(),
+                             [&](const std::string& token) { return script.find(token) != std::string::npos; }),
+                         m_expected.end());
+        if (!m_requests.empty()) SettleRequests(script);
+
+        // The bridge script starts with the preamble naming the page
+        static const std::string ADDON_KEY = "window.__nexus_addon_id='";
+        static const std::string WINDOW_KEY = "window.__nexus_window_id='";
+        if (script.compare(0, ADDON_KEY.size(), ADDON_KEY) == 0) {
+            m_addonId = Quoted(script, ADDON_KEY);
+            m_windowId = Quoted(script, WINDOW_KEY);
+            m_bridgeLoaded = true;
+        }
+    }
+    bool IsMain() override { return true; }
+    void LoadURL(const CefString& url) override {
+        m_url = url.str();
+        m_reloadPending = true;
+    }
+    CefString GetURL() override { return m_url; }
+
+    // SimPage
+    const std::string& GetAddonId() const override { return m_addonId; }
+    const std::string& GetWindowId() const override { return m_windowId; }
+    bool IsBridgeLoaded() const override { return m_bridgeLoaded && !m_closed; }
+    const PageStats& GetStats() const override { return m_stats; }
+
+    void Expect(std::string token) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_expected.push_back(std::move(token));
+    }
+    size_t GetMissing() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_expected.size();
+    }
+    size_t GetUnanswered() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_requests.size();
+    }
+
+    void Send(nlohmann::json msg) override {
+        if (!IsBridgeLoaded()) return;
+        msg["__addonId"] = m_addonId;
+        msg["__windowId"] = m_windowId;
+        auto requestId = msg.find("requestId");
+        if (requestId != msg.end() && requestId->is_number_integer()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_requests.insert(requestId->get<int>());
+        }
+        std::string text = "__NEXUS__:" + msg.dump();
+        ++m_stats.sent;
+        m_stats.sentBytes += text.size();
+        if (CefRefPtr<CefDisplayHandler> display = m_client->GetDisplayHandler()) {
+            display->OnConsoleMessage(this, LOGSEVERITY_INFO, text, "https://sim/page.js", 1);
+        }
+    }
+
+    // Start (or restart) the document: OnLoadStart, then OnLoadEnd.
+    void Load() {
+        m_reloadPending = false;
+        m_bridgeLoaded = false;
+        driverState = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_expected.clear();
+            m_requests.clear();
+        }
+        if (CefRefPtr<CefLoadHandler> load = m_client->GetLoadHandler()) {
+            load->OnLoadStart(this, this, 0);
+            load->OnLoadEnd(this, this, 200);
+        }
+
+        // One opaque frame, so the overlay has a texture to draw and hit
+        // tests have alpha to read
+        if (CefRefPtr<CefRenderHandler> render = m_client->GetRenderHandler()) {
+            CefRect rect;
+            render->GetViewRect(this, rect);
+            if (rect.width > 0 && rect.height > 0) {
+                std::vector<uint8_t> pixels(static_cast<size_t>(rect.width) * rect.height * 4, 0xFF);
+                render->OnPaint(this, PET_VIEW, { rect }, pixels.data(), rect.width, rect.height);
+            }
+        }
+    }
+
+    CefRefPtr<CefClient> m_client;
+    bool m_closed = false;
+    bool m_reloadPending = false;
+
+private:
+    // Drop the requests a script responds to: "requestId":N in an object
+    // literal, or with escaped quotes in a string literal. m_mutex held.
+    void SettleRequests(const std::string& script) {
+        static const std::string KEY = "requestId";
+        for (size_t at = script.find(KEY); at != std::string::npos; at = script.find(KEY, at)) {
+            at += KEY.size();
+            while (at < script.size() && (script[at] == '\\' || script[at] == '"' || script[at] == ':')) ++at;
+            int id = 0;
+            bool digits = false;
+            for (; at < script.size() && std::isdigit(static_cast<unsigned char>(script[at])); ++at) {
+                id = id * 10 + (script[at] - '0');
+                digits = true;
+            }
+            if (digits) m_requests.erase(id);
+        }
+    }
+
+    static std::string Quoted(const std::string& script, const std::string& key) {
+        size_t start = script.find(key);
+        if (start == std::string::npos) return {};
+        start += key.size();
+        size_t end = script.find('\'', start);
+        return end == std::string::npos ? std::string() : script.substr(start, end - start);
+    }
+
+    std::string m_url;
+    int         m_id;
+    std::string m_addonId;
+    std::string m_windowId;
+    bool        m_bridgeLoaded = false;
+    PageStats   m_stats;
+    std::vector<std::string> m_expected;
+    std::unordered_set<int>  m_requests;   // sent, not yet responded to
+    std::mutex  m_mutex;
+
+    IMPLEMENT_REFCOUNTING(SimBrowser);
+};
+
+class SimDictionary : public CefDictionaryValue {
+    IMPLEMENT_REFCOUNTING(SimDictionary);
+};
+
+struct PendingCreate {
+    CefRefPtr<CefClient> client;
+    std::string          url;
+};
+
+static std::mutex                           s_mutex;
+static std::deque<PendingCreate>            s_pending;
+static std::vector<CefRefPtr<SimBrowser>>   s_open;
+static int                                  s_nextId = 1;
+static uint64_t                             s_created = 0;
+
+void Pump() {
+    std::deque<PendingCreate> pending;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        pending.swap(s_pending);
+    }
+
+    for (PendingCreate& create : pending) {
+        CefRefPtr<SimBrowser> browser = new SimBrowser(create.client, create.url, s_nextId++);
+        s_open.push_back(browser);
+        ++s_created;
+        if (CefRefPtr<CefLifeSpanHandler> lifeSpan = create.client->GetLifeSpanHandler()) {
+            lifeSpan->OnAfterCreated(browser.get());
+        }
+        browser->Load();
+    }
+
+    for (size_t i = 0; i < s_open.size();) {
+        CefRefPtr<SimBrowser> browser = s_open[i];
+        if (browser->m_closed) {
+            if (CefRefPtr<CefLifeSpanHandler> lifeSpan = browser->m_client->GetLifeSpanHandler()) {
+                lifeSpan->OnBeforeClose(browser.get());
+            }
+            s_open.erase(s_open.begin() + i);
+            continue;
+        }
+        if (browser->m_reloadPending) browser->Load();
+        ++i;
+    }
+}
+
+void ForEachPage(const std::function<void(SimPage& page)>& fn) {
+    for (const CefRefPtr<SimBrowser>& browser : s_open) {
+        if (!browser->m_closed) fn(*browser);
+    }
+}
+
+size_t GetOpenCount() { return s_open.size(); }
+uint64_t GetCreatedCount() { return s_created; }
+
+void Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_pending.clear();
+    }
+    s_open.clear();
+}
+
+} // namespace SimCef
+
+// ---- CEF entry points used by the core ----
+
+bool CefBrowserHost::CreateBrowser(const CefWindowInfo&, CefRefPtr<CefClient> client,
+                                   const CefString& url, const CefBrowserSettings&,
+                                   CefRefPtr<CefDictionaryValue>, CefRefPtr<CefRequestContext>) {
+    if (!client) return false;
+    std::lock_guard<std::mutex> lock(SimCef::s_mutex);
+    SimCef::s_pending.push_back({ client, url.str() });
+    return true;
+}
+
+CefRefPtr<CefDictionaryValue> CefDictionaryValue::Create() {
+    return new SimCef::SimDictionary();
+}
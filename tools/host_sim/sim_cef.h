@@ -0,0 +1,71 @@
+#pragma once
+
+#include "include/cef_sim.h"
+
+#include "nlohmann/json.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Stub CEF browser for host_sim.
+//
+// CefBrowserHost::CreateBrowser queues a browser; Pump() creates it and runs
+// the client's OnAfterCreated / OnLoadStart / OnLoadEnd, like CEF's UI loop
+// would, so the real InProcessBrowser injects the bridge into it. Each
+// browser carries a page model (SimPage) that stands in for the page's JS:
+// it sends bridge messages through the client's OnConsoleMessage and counts
+// what native executes in it.
+namespace SimCef {
+
+struct PageStats {
+    uint64_t sent = 0;           // bridge messages sent to native
+    uint64_t sentBytes = 0;
+    uint64_t scripts = 0;        // ExecuteJavaScript calls received
+    uint64_t scriptBytes = 0;
+    uint64_t inputEvents = 0;    // mouse / key events received
+};
+
+class SimPage {
+public:
+    virtual ~SimPage() = default;
+
+    // From the bridge preamble (window.__nexus_addon_id / _window_id).
+    virtual const std::string& GetAddonId() const = 0;
+    virtual const std::string& GetWindowId() const = 0;
+
+    // Whether the bridge script has been injected into the current document.
+    virtual bool IsBridgeLoaded() const = 0;
+
+    // Send a bridge message (what window.nexus does: console.log of
+    // "__NEXUS__:" + JSON, with the page's addon and window IDs added).
+    virtual void Send(nlohmann::json msg) = 0;
+
+    virtual const PageStats& GetStats() const = 0;
+
+    // Expect native to execute a script containing `token` (a response value,
+    // an event name). GetMissing counts tokens not seen since their Expect.
+    virtual void Expect(std::string token) = 0;
+    virtual size_t GetMissing() = 0;
+
+    // Requests sent (messages with a requestId) that no response has settled.
+    virtual size_t GetUnanswered() = 0;
+
+    // Scratch slot for the driver (e.g. whether setup messages were sent).
+    uint32_t driverState = 0;
+};
+
+// Create queued browsers, deliver load callbacks, and finish closes.
+// Render thread (the CEF UI thread in the real host).
+void Pump();
+
+// Every open page, in creation order.
+void ForEachPage(const std::function<void(SimPage& page)>& fn);
+
+size_t GetOpenCount();
+uint64_t GetCreatedCount();
+
+// Drop every browser still open (end of run, after AddonManager::Shutdown).
+void Shutdown();
+
+} // namespace SimCef
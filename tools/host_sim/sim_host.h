@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+// Process-wide pieces of the simulated host: the clock behind GetTickCount,
+// the keyboard state behind GetKeyState, and allocation counters.
+
+namespace SimClock {
+
+// Simulated milliseconds since start. Advanced only by the driver, so runs
+// are reproducible regardless of how long a frame really takes.
+uint64_t NowMs();
+void Advance(uint64_t ms);
+
+} // namespace SimClock
+
+namespace SimKeys {
+
+// Virtual-key state reported by GetKeyState (input traces).
+void SetDown(int virtualKey, bool down);
+
+} // namespace SimKeys
+
+namespace SimAlloc {
+
+struct Counters {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+// Totals since start, across all threads (global operator new).
+Counters Read();
+
+} // namespace SimAlloc
@@ -0,0 +1,51 @@
+// Plugin modules host_sim replaces: the scheme handler (no network stack in
+// the stub browser), the libcef.dll gate, and the D3D11 texture upload.
+
+#include "addon_scheme_handler.h"
+#include "cef_loader.h"
+#include "d3d11_texture.h"
+
+namespace AddonSchemeHandler {
+
+void RegisterForAddon(const AddonManifest&) {}
+void UnregisterAll() {}
+
+} // namespace AddonSchemeHandler
+
+namespace CefLoader {
+
+bool IsAvailable() { return true; }
+bool TryInitialize() { return true; }
+
+} // namespace CefLoader
+
+// No device: the "texture" is a non-null handle once a frame has arrived,
+// which is all the overlay and ImGui (without a renderer backend) need.
+
+D3D11Texture::D3D11Texture() = default;
+
+D3D11Texture::~D3D11Texture() {
+    Release();
+}
+
+void D3D11Texture::UpdateFromPixels(const void* pixels, int width, int height) {
+    if (!pixels || width <= 0 || height <= 0) return;
+    if (width != m_width || height != m_height) CreateTexture(width, height);
+}
+
+void* D3D11Texture::GetShaderResourceView() const {
+    return m_srv;
+}
+
+void D3D11Texture::Release() {
+    m_texture = nullptr;
+    m_srv = nullptr;
+    m_width = 0;
+    m_height = 0;
+}
+
+void D3D11Texture::CreateTexture(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_srv = reinterpret_cast<ID3D11ShaderResourceView*>(this);
+}
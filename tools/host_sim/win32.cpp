@@ -0,0 +1,144 @@
+#include "sim_host.h"
+
+#include <windows.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cwchar>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// ---- SimClock ----
+
+namespace SimClock {
+
+static std::atomic<uint64_t> s_nowMs{1000};
+
+uint64_t NowMs() { return s_nowMs.load(std::memory_order_relaxed); }
+void Advance(uint64_t ms) { s_nowMs.fetch_add(ms, std::memory_order_relaxed); }
+
+} // namespace SimClock
+
+// ---- SimKeys ----
+
+namespace SimKeys {
+
+static std::atomic<bool> s_down[256];
+
+void SetDown(int virtualKey, bool down) {
+    if (virtualKey >= 0 && virtualKey < 256) s_down[virtualKey].store(down, std::memory_order_relaxed);
+}
+
+} // namespace SimKeys
+
+// ---- Win32 ----
+
+DWORD GetTickCount() {
+    return static_cast<DWORD>(SimClock::NowMs());
+}
+
+DWORD GetCurrentThreadId() {
+    return static_cast<DWORD>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+}
+
+short GetKeyState(int virtualKey) {
+    if (virtualKey < 0 || virtualKey >= 256) return 0;
+    return SimKeys::s_down[virtualKey].load(std::memory_order_relaxed) ? static_cast<short>(0x8000) : 0;
+}
+
+BOOL ScreenToClient(HWND, POINT*) {
+    return TRUE; // the simulated game window sits at the screen origin
+}
+
+DWORD GetModuleFileNameA(HMODULE, char* path, DWORD size) {
+    static const char* NAME = "/tmp/host_sim/nexus_js_loader.dll";
+    if (!path || size == 0) return 0;
+    size_t len = std::min<size_t>(std::strlen(NAME), size - 1);
+    std::memcpy(path, NAME, len);
+    path[len] = '\0';
+    return static_cast<DWORD>(len);
+}
+
+// ---- Memory (event_router thunk pages) ----
+
+static std::mutex                s_mapMutex;
+static std::map<void*, size_t>   s_mappings;  // VirtualFree(MEM_RELEASE) takes no size
+
+static int ToProt(DWORD protect) {
+    switch (protect) {
+        case PAGE_READWRITE:    return PROT_READ | PROT_WRITE;
+        case PAGE_EXECUTE_READ: return PROT_READ | PROT_EXEC;
+        default:                return PROT_NONE;
+    }
+}
+
+HANDLE GetCurrentProcess() {
+    return reinterpret_cast<HANDLE>(static_cast<intptr_t>(-1));
+}
+
+LPVOID VirtualAlloc(LPVOID, size_t size, DWORD, DWORD protect) {
+    void* p = mmap(nullptr, size, ToProt(protect), MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    std::lock_guard<std::mutex> lock(s_mapMutex);
+    s_mappings[p] = size;
+    return p;
+}
+
+BOOL VirtualProtect(LPVOID address, size_t size, DWORD protect, DWORD* oldProtect) {
+    if (oldProtect) *oldProtect = PAGE_READWRITE;
+    return mprotect(address, size, ToProt(protect)) == 0;
+}
+
+BOOL VirtualFree(LPVOID address, size_t, DWORD) {
+    size_t size = 0;
+    {
+        std::lock_guard<std::mutex> lock(s_mapMutex);
+        auto it = s_mappings.find(address);
+        if (it == s_mappings.end()) return FALSE;
+        size = it->second;
+        s_mappings.erase(it);
+    }
+    return munmap(address, size) == 0;
+}
+
+BOOL FlushInstructionCache(HANDLE, const void*, size_t) {
+    return TRUE; // coherent on x86-64
+}
+
+// UTF-8 encoding of UTF-32 wchar_t (Linux), same contract as the Win32 call:
+// with outSize 0, return the required size.
+int WideCharToMultiByte(UINT, DWORD, const wchar_t* wide, int wideLen,
+                        char* out, int outSize, const char*, BOOL*) {
+    if (!wide) return 0;
+    if (wideLen < 0) wideLen = static_cast<int>(std::wcslen(wide)) + 1;
+
+    std::string utf8;
+    for (int i = 0; i < wideLen; ++i) {
+        uint32_t c = static_cast<uint32_t>(wide[i]);
+        if (c < 0x80) {
+            utf8 += static_cast<char>(c);
+        } else if (c < 0x800) {
+            utf8 += static_cast<char>(0xC0 | (c >> 6));
+            utf8 += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            utf8 += static_cast<char>(0xE0 | (c >> 12));
+            utf8 += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            utf8 += static_cast<char>(0xF0 | (c >> 18));
+            utf8 += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            utf8 += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+
+    if (outSize == 0) return static_cast<int>(utf8.size());
+    if (static_cast<int>(utf8.size()) > outSize) return 0;
+    std::memcpy(out, utf8.data(), utf8.size());
+    return static_cast<int>(utf8.size());
+}
@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+"""Pack an addon directory into a single addon.pack bundle.
+
+The loader maps the bundle and serves its entries in place of loose files
+(see src/plugin/addon_bundle.h for the layout). manifest.json stays loose:
+it is read before the bundle is opened.
+
+    python tools/pack_addon.py web/example
+    python tools/pack_addon.py web/example -o build/addon.pack --bench
+    python tools/pack_addon.py web/example --compress
+
+With --compress, text assets also get a gzip (and, if the brotli module is
+installed, brotli) entry next to the original; the loader serves those with
+Content-Encoding. Existing file.js.br / file.js.gz siblings are packed as-is.
+"""
+
+import argparse
+import gzip
+import mimetypes
+import mmap
+import os
+import struct
+import sys
+import time
+
+MAGIC = b"JSLPACK\0"
+VERSION = 1
+HEADER = struct.Struct("<8sIIQQ")
+ENTRY = struct.Struct("<IIIIQQQ")
+ALIGN = 8
+BUNDLE_NAME = "addon.pack"
+
+# Types the web engine cares about, independent of the host's mimetypes table
+# (same table as AddonFileIndex::MimeTypeFor)
+MIME_TYPES = {
+    ".html": "text/html",
+    ".htm": "text/html",
+    ".js": "text/javascript",
+    ".mjs": "text/javascript",
+    ".cjs": "text/javascript",
+    ".css": "text/css",
+    ".json": "application/json",
+    ".map": "application/json",
+    ".webmanifest": "application/manifest+json",
+    ".wasm": "application/wasm",
+    ".svg": "image/svg+xml",
+    ".png": "image/png",
+    ".jpg": "image/jpeg",
+    ".jpeg": "image/jpeg",
+    ".gif": "image/gif",
+    ".webp": "image/webp",
+    ".avif": "image/avif",
+    ".ico": "image/x-icon",
+    ".woff": "font/woff",
+    ".woff2": "font/woff2",
+    ".ttf": "font/ttf",
+    ".otf": "font/otf",
+    ".mp3": "audio/mpeg",
+    ".ogg": "audio/ogg",
+    ".wav": "audio/wav",
+    ".mp4": "video/mp4",
+    ".webm": "video/webm",
+    ".txt": "text/plain",
+}
+
+SKIPPED = {"manifest.json", BUNDLE_NAME}
+
+# Precompressed variants: suffix -> compressor (None: module not installed)
+try:
+    import brotli
+    BROTLI = lambda data: brotli.compress(data, quality=11)
+except ImportError:
+    BROTLI = None
+
+ENCODINGS = {
+    ".br": BROTLI,
+    ".gz": lambda data: gzip.compress(data, compresslevel=9, mtime=0),
+}
+
+COMPRESSIBLE = (".html", ".htm", ".js", ".mjs", ".css", ".json", ".svg", ".wasm", ".txt")
+MIN_COMPRESS_SIZE = 1024
+MIN_SAVING = 0.1
+
+
+def normalize(path):
+    """Same key as AssetCache::NormalizePath: '/' separators, ASCII lower case."""
+    parts = [p for p in path.replace("\\", "/").split("/") if p not in ("", ".")]
+    return "/".join(parts).translate(str.maketrans("ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+                                                   "abcdefghijklmnopqrstuvwxyz"))
+
+
+def fnv1a64(data):
+    h = 0xCBF29CE484222325
+    for b in data:
+        h = ((h ^ b) * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+
+def guess_mime(path):
+    """MIME type of the content; a precompressed variant reports the original's."""
+    base, ext = os.path.splitext(path.lower())
+    if ext in ENCODINGS:
+        path, ext = base, os.path.splitext(base)[1]
+    if ext in MIME_TYPES:
+        return MIME_TYPES[ext]
+    return mimetypes.guess_type(path)[0] or ""
+
+
+def collect(source):
+    files = {}
+    for root, dirs, names in os.walk(source):
+        dirs[:] = sorted(d for d in dirs if not d.startswith("."))
+        for name in names:
+            full = os.path.join(root, name)
+            rel = os.path.relpath(full, source)
+            if name.startswith(".") or rel in SKIPPED:
+                continue
+            key = normalize(rel)
+            if key in files:
+                sys.exit(f"error: '{rel}' and '{files[key]}' differ only in case")
+            files[key] = full
+    return files
+
+
+def pack(source, output, compress):
+    files = collect(source)
+    contents = {}
+    for key, full in files.items():
+        with open(full, "rb") as f:
+            contents[key] = f.read()
+
+    if compress:
+        for key in list(contents):
+            data = contents[key]
+            if not key.endswith(COMPRESSIBLE) or len(data) < MIN_COMPRESS_SIZE:
+                continue
+            for suffix, compressor in ENCODINGS.items():
+                if compressor is None or key + suffix in contents:
+                    continue
+                packed = compressor(data)
+                if len(packed) <= len(data) * (1 - MIN_SAVING):
+                    contents[key + suffix] = packed
+
+    keys = sorted(contents, key=lambda k: k.encode("utf-8"))
+
+    strings = bytearray()
+    string_refs = {}
+
+    def intern(text):
+        raw = text.encode("utf-8")
+        if raw not in string_refs:
+            string_refs[raw] = len(strings)
+            strings.extend(raw)
+        return string_refs[raw], len(raw)
+
+    entries = []
+    for key in keys:
+        entries.append((intern(key), intern(guess_mime(key)), contents[key]))
+
+    strings_offset = HEADER.size + ENTRY.size * len(entries)
+    offset = strings_offset + len(strings)
+
+    index = bytearray()
+    blobs = bytearray()
+    for (path_ref, mime_ref, data) in entries:
+        pad = -offset % ALIGN
+        blobs.extend(b"\0" * pad)
+        offset += pad
+        index.extend(ENTRY.pack(path_ref[0], path_ref[1], mime_ref[0], mime_ref[1],
+                                offset, len(data), fnv1a64(data)))
+        blobs.extend(data)
+        offset += len(data)
+
+    with open(output, "wb") as f:
+        f.write(HEADER.pack(MAGIC, VERSION, len(entries), strings_offset, len(strings)))
+        f.write(index)
+        f.write(strings)
+        f.write(blobs)
+
+    return files, len(keys), offset
+
+
+def read_index(view):
+    magic, version, count, strings_offset, strings_size = HEADER.unpack_from(view, 0)
+    if magic != MAGIC or version != VERSION:
+        sys.exit("error: not a version 1 bundle")
+    entries = []
+    for i in range(count):
+        _, _, _, _, offset, size, _ = ENTRY.unpack_from(view, HEADER.size + i * ENTRY.size)
+        entries.append((offset, size))
+    return entries
+
+
+def bench(files, output, rounds):
+    """Time reading every asset: loose open/stat/read vs slices of the mapped bundle."""
+    paths = list(files.values())
+    total = sum(os.path.getsize(p) for p in paths)
+
+    start = time.perf_counter()
+    for _ in range(rounds):
+        for path in paths:
+            size = os.stat(path).st_size
+            with open(path, "rb") as f:
+                f.read(size)
+    loose = time.perf_counter() - start
+
+    start = time.perf_counter()
+    with open(output, "rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as view:
+        entries = read_index(view)
+        for _ in range(rounds):
+            for offset, size in entries:
+                view[offset:offset + size]
+    packed = time.perf_counter() - start
+
+    def report(name, seconds):
+        per_round = seconds / rounds
+        print(f"  {name:7} {per_round * 1000:8.3f} ms/round  "
+              f"{len(paths) / per_round:10.0f} files/s  {total / per_round / 1e6:8.1f} MB/s")
+
+    print(f"{len(paths)} file(s), {total} bytes, {rounds} round(s), warm cache:")
+    report("loose", loose)
+    report("bundle", packed)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="addon directory (the one holding manifest.json)")
+    parser.add_argument("-o", "--output", help=f"bundle path (default: <source>/{BUNDLE_NAME})")
+    parser.add_argument("--compress", action="store_true",
+                        help="add gzip/brotli entries for text assets")
+    parser.add_argument("--bench", action="store_true",
+                        help="compare read throughput of loose files and the bundle")
+    parser.add_argument("--rounds", type=int, default=50, help="benchmark rounds (default 50)")
+    args = parser.parse_args()
+
+    if not os.path.isfile(os.path.join(args.source, "manifest.json")):
+        sys.exit(f"error: no manifest.json in '{args.source}'")
+    output = args.output or os.path.join(args.source, BUNDLE_NAME)
+
+    files, entries, size = pack(args.source, output, args.compress)
+    print(f"Packed {len(files)} file(s) into {output} ({entries} entries, {size} bytes)")
+
+    if args.bench:
+        bench(files, output, max(1, args.rounds))
+
+
+if __name__ == "__main__":
+    main()